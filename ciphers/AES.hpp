@@ -8,6 +8,7 @@
 #ifndef MYAES
 #define MYAES
 #include <cstdint>
+#include <new>
 #include "BlockCipher.hpp"
 
 class AES : public BlockCipher {
@@ -17,35 +18,37 @@ private:
 
 public:
     enum KEY_SIZE : uint8_t { AES128 = 16, AES192 = 24, AES256 = 32 };
+    enum BACKEND : uint8_t { AUTO, REFERENCE, TTABLE, AESNI, BITSLICE, VPERM };
 
-    AES(const uint8_t key[], KEY_SIZE keySize = AES128);
+    AES(const uint8_t key[], KEY_SIZE keySize = AES128, BACKEND backend = AUTO);
     AES(const AES &that);
     ~AES();
 
+    static bool isSupported(BACKEND backend);
+
+    void setKey(const uint8_t key[]);
+
     void encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const;
     void decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const;
+    void encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+    KEY_SIZE getKeySize() const;
+    BACKEND getBackend() const;
+    BACKEND getBatchBackend() const;
+    const BlockCipher& getEngine() const;
 
 private:
-    const static uint8_t RCON_TABLE[];
-    const static uint8_t EXP_TABLE[];
-    const static uint8_t LOG_TABLE[];
-    const static uint8_t SBOX_TABLE[];
-    const static uint8_t SBOX_INV_TABLE[];
-
     uint8_t key[32];
     KEY_SIZE keySize;
-    uint8_t ekey[240];
-
-    void generateExpandedKey();
-
-    void addRoundKey(uint8_t block[4][4], int round) const;
-    static void sboxSub(uint8_t block[4][4]);
-    static void sboxSubInv(uint8_t block[4][4]);
-    static void shiftRows(uint8_t block[4][4]);
-    static void shiftRowsInv(uint8_t block[4][4]);
-    static void mixColumns(uint8_t block[4][4]);
-    static void mixColumnsInv(uint8_t block[4][4]);
-    static uint8_t multiplyGF(uint8_t a, uint8_t b);
+    BACKEND backend;
+    BACKEND batchBackend;
+    BlockCipher *engine;
+    BlockCipher *batchEngine;
+
+    void createEngines();
+    BlockCipher* createEngine(BACKEND backend) const;
+    BlockCipher* createReference() const;
+    void setEngineKey(BlockCipher *engine, BACKEND backend) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,754 @@
+/**
+ * class implementation for the bitsliced, constant-time AES 128, 192, and 256 block cipher backend.
+ * @file AES_Bitslice.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "AES_Bitslice.hpp"
+#include "CPUFeatures.hpp"
+
+/**
+ * the state of 8 blocks is held in 8 registers q[0..7], register q[j] holds bit j of every state byte
+ * within a register, byte p holds bit j of byte p of blocks 0 through 7 (block b in bit b)
+ * so every linear step of AES becomes a byte shuffle of each register and the SBOX becomes a boolean circuit
+ *
+ * technique is described at: https://eprint.iacr.org/2009/129.pdf
+ *
+ * a register is a Slice: an SSE2 register on x86, and a pair of 64-bit words everywhere else (ARM included),
+ * so the rounds below are written once against the few Slice operations defined for each
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+
+// SSE2 is part of the x86-64 baseline, the attribute only matters for 32-bit builds
+#define BITSLICE_TARGET __attribute__((target("sse2")))
+
+typedef __m128i Slice;
+
+/**
+ * @return true if the CPU can run the SSE2 Slice operations
+ */
+bool AES_Bitslice::isSupported() {
+    return CPUFeatures::hasSSE2();
+}
+
+BITSLICE_TARGET static inline Slice sliceLoad(const uint8_t bytes[16]) {
+    return _mm_loadu_si128((const __m128i*) bytes);
+}
+
+BITSLICE_TARGET static inline void sliceStore(uint8_t bytes[16], Slice x) {
+    _mm_storeu_si128((__m128i*) bytes, x);
+}
+
+/**
+ * @return a Slice holding value in both 64-bit halves
+ */
+BITSLICE_TARGET static inline Slice sliceBroadcast(uint64_t value) {
+    return _mm_set1_epi64x(value);
+}
+
+/**
+ * converts between a 32-bit word and the first 4 bytes of a Slice, byte 0 in the least significant position
+ */
+BITSLICE_TARGET static inline Slice sliceFromWord(uint32_t word) {
+    return _mm_cvtsi32_si128(word);
+}
+
+BITSLICE_TARGET static inline uint32_t sliceToWord(Slice x) {
+    return _mm_cvtsi128_si32(x);
+}
+
+/**
+ * shifts both 64-bit halves by n bits
+ */
+BITSLICE_TARGET static inline Slice sliceShiftRight(Slice x, int n) {
+    return _mm_srli_epi64(x, n);
+}
+
+BITSLICE_TARGET static inline Slice sliceShiftLeft(Slice x, int n) {
+    return _mm_slli_epi64(x, n);
+}
+
+/**
+ * moves byte r of every column to byte r - n of the same column
+ * columns are the 32-bit lanes of a register since the state bytes are stored in column-major order
+ */
+BITSLICE_TARGET static inline Slice rotateColumns1(Slice x) {
+    return _mm_srli_epi32(x, 8) | _mm_slli_epi32(x, 24);
+}
+
+BITSLICE_TARGET static inline Slice rotateColumns2(Slice x) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+/**
+ * moves column c to column c - n, wrapping around
+ */
+BITSLICE_TARGET static inline Slice rotateRow1(Slice x) {
+    return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 3, 2, 1));
+}
+
+BITSLICE_TARGET static inline Slice rotateRow2(Slice x) {
+    return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+BITSLICE_TARGET static inline Slice rotateRow3(Slice x) {
+    return _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 1, 0, 3));
+}
+
+#else
+
+#define BITSLICE_TARGET
+
+/**
+ * a 128-bit register as two 64-bit words, bytes 0-7 in lo and bytes 8-15 in hi, least significant first
+ */
+struct Slice {
+    uint64_t lo, hi;
+};
+
+static inline Slice operator^(Slice a, Slice b) { return { a.lo ^ b.lo, a.hi ^ b.hi }; }
+static inline Slice operator&(Slice a, Slice b) { return { a.lo & b.lo, a.hi & b.hi }; }
+static inline Slice operator|(Slice a, Slice b) { return { a.lo | b.lo, a.hi | b.hi }; }
+static inline Slice operator~(Slice a) { return { ~a.lo, ~a.hi }; }
+static inline Slice& operator^=(Slice &a, Slice b) { return a = a ^ b; }
+
+/**
+ * @return true since the Slice operations are plain integer arithmetic
+ */
+bool AES_Bitslice::isSupported() {
+    return true;
+}
+
+static inline uint64_t load64(const uint8_t bytes[8]) {
+    uint64_t value = 0;
+
+    for (int i = 7; i >= 0; i--)
+        value = (value << 8) | bytes[i];
+    return value;
+}
+
+static inline void store64(uint8_t bytes[8], uint64_t value) {
+    for (int i = 0; i < 8; i++, value >>= 8)
+        bytes[i] = uint8_t(value);
+}
+
+static inline Slice sliceLoad(const uint8_t bytes[16]) {
+    return { load64(bytes), load64(bytes + 8) };
+}
+
+static inline void sliceStore(uint8_t bytes[16], Slice x) {
+    store64(bytes, x.lo);
+    store64(bytes + 8, x.hi);
+}
+
+/**
+ * @return a Slice holding value in both 64-bit halves
+ */
+static inline Slice sliceBroadcast(uint64_t value) {
+    return { value, value };
+}
+
+/**
+ * converts between a 32-bit word and the first 4 bytes of a Slice, byte 0 in the least significant position
+ */
+static inline Slice sliceFromWord(uint32_t word) {
+    return { word, 0 };
+}
+
+static inline uint32_t sliceToWord(Slice x) {
+    return uint32_t(x.lo);
+}
+
+/**
+ * shifts both 64-bit halves by n bits
+ */
+static inline Slice sliceShiftRight(Slice x, int n) {
+    return { x.lo >> n, x.hi >> n };
+}
+
+static inline Slice sliceShiftLeft(Slice x, int n) {
+    return { x.lo << n, x.hi << n };
+}
+
+/**
+ * moves byte r of every column to byte r - n of the same column
+ * columns are the 32-bit lanes of a register since the state bytes are stored in column-major order
+ */
+static inline uint64_t rotateColumns1(uint64_t x) {
+    return ((x >> 8) & 0x00ffffff00ffffff) | ((x << 24) & 0xff000000ff000000);
+}
+
+static inline uint64_t rotateColumns2(uint64_t x) {
+    return ((x >> 16) & 0x0000ffff0000ffff) | ((x << 16) & 0xffff0000ffff0000);
+}
+
+static inline Slice rotateColumns1(Slice x) {
+    return { rotateColumns1(x.lo), rotateColumns1(x.hi) };
+}
+
+static inline Slice rotateColumns2(Slice x) {
+    return { rotateColumns2(x.lo), rotateColumns2(x.hi) };
+}
+
+/**
+ * moves column c to column c - n, wrapping around
+ */
+static inline Slice rotateRow1(Slice x) {
+    return { (x.lo >> 32) | (x.hi << 32), (x.hi >> 32) | (x.lo << 32) };
+}
+
+static inline Slice rotateRow2(Slice x) {
+    return { x.hi, x.lo };
+}
+
+static inline Slice rotateRow3(Slice x) {
+    return { (x.lo << 32) | (x.hi >> 32), (x.hi << 32) | (x.lo >> 32) };
+}
+
+#endif
+
+/**
+ * swaps the bits of a selected by (mask << n) with the bits of b selected by mask
+ */
+BITSLICE_TARGET static inline void swapMove(Slice &a, Slice &b, int n, Slice mask) {
+    Slice t = (sliceShiftRight(a, n) ^ b) & mask;
+    b ^= t;
+    a ^= sliceShiftLeft(t, n);
+}
+
+/**
+ * converts between 8 blocks and the bitsliced representation
+ * the conversion is an 8x8 bit matrix transpose for every byte position so it is its own inverse
+ *
+ * @param q 8 registers holding either 8 blocks or 8 bit planes
+ */
+BITSLICE_TARGET static inline void transpose(Slice q[8]) {
+    const Slice m1 = sliceBroadcast(0x5555555555555555), m2 = sliceBroadcast(0x3333333333333333), m4 = sliceBroadcast(0x0f0f0f0f0f0f0f0f);
+
+    swapMove(q[0], q[1], 1, m1); swapMove(q[2], q[3], 1, m1); swapMove(q[4], q[5], 1, m1); swapMove(q[6], q[7], 1, m1);
+    swapMove(q[0], q[2], 2, m2); swapMove(q[1], q[3], 2, m2); swapMove(q[4], q[6], 2, m2); swapMove(q[5], q[7], 2, m2);
+    swapMove(q[0], q[4], 4, m4); swapMove(q[1], q[5], 4, m4); swapMove(q[2], q[6], 4, m4); swapMove(q[3], q[7], 4, m4);
+}
+
+/**
+ * performs the SBOX substitution on all 128 bytes of the bitsliced state using only logic operations
+ *
+ * circuit (113 gates) found at: https://eprint.iacr.org/2011/332.pdf
+ *
+ * @param q the bitsliced state
+ */
+BITSLICE_TARGET static inline void sboxSub(Slice q[8]) {
+    Slice x0, x1, x2, x3, x4, x5, x6, x7;
+    Slice y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+    Slice z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14, z15, z16, z17;
+    Slice t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    Slice t20, t21, t22, t23, t24, t25, t26, t27, t28, t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    Slice t40, t41, t42, t43, t44, t45, t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    Slice t60, t61, t62, t63, t64, t65, t66, t67;
+    Slice s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // the circuit numbers bits from the most significant one
+    x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+    x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+    // top linear transformation
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // non-linear section, the inversion in GF(2^8)
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // bottom linear transformation, which includes the SBOX affine transform
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+/**
+ * applies the inverse of the SBOX affine transform: b[i] = b[i+2] ^ b[i+5] ^ b[i+7] ^ 0x05[i]
+ *
+ * @param q the bitsliced state
+ */
+BITSLICE_TARGET static inline void affineInv(Slice q[8]) {
+    Slice r[8];
+
+    #pragma GCC unroll 8
+    for (int i = 0; i < 8; i++)
+        r[i] = q[(i + 2) % 8] ^ q[(i + 5) % 8] ^ q[(i + 7) % 8];
+
+    #pragma GCC unroll 8
+    for (int i = 0; i < 8; i++)
+        q[i] = r[i];
+    q[0] = ~q[0];
+    q[2] = ~q[2];
+}
+
+/**
+ * performs the inverse SBOX substitution on the bitsliced state
+ * since SBOX(x) = A(x^-1) for the affine transform A, SBOX_INV(x) = A^-1(SBOX(A^-1(x)))
+ *
+ * @param q the bitsliced state
+ */
+BITSLICE_TARGET static inline void sboxSubInv(Slice q[8]) {
+    affineInv(q);
+    sboxSub(q);
+    affineInv(q);
+}
+
+/**
+ * performs the row shifts on every bit plane, row r of the state is byte r of each 32-bit lane
+ *
+ * @param q the bitsliced state
+ */
+BITSLICE_TARGET static inline void shiftRows(Slice q[8]) {
+    const Slice row0 = sliceBroadcast(0x000000ff000000ff), row1 = sliceBroadcast(0x0000ff000000ff00);
+    const Slice row2 = sliceBroadcast(0x00ff000000ff0000), row3 = sliceBroadcast(0xff000000ff000000);
+
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        q[j] = (q[j] & row0) | (rotateRow1(q[j]) & row1) | (rotateRow2(q[j]) & row2) | (rotateRow3(q[j]) & row3);
+}
+
+BITSLICE_TARGET static inline void shiftRowsInv(Slice q[8]) {
+    const Slice row0 = sliceBroadcast(0x000000ff000000ff), row1 = sliceBroadcast(0x0000ff000000ff00);
+    const Slice row2 = sliceBroadcast(0x00ff000000ff0000), row3 = sliceBroadcast(0xff000000ff000000);
+
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        q[j] = (q[j] & row0) | (rotateRow3(q[j]) & row1) | (rotateRow2(q[j]) & row2) | (rotateRow1(q[j]) & row3);
+}
+
+/**
+ * multiplies every byte of the bitsliced state by 0x02 in GF(2^8), x^8 is reduced to x^4 + x^3 + x + 1
+ *
+ * @param q the bitsliced state
+ */
+BITSLICE_TARGET static inline void xtime(Slice q[8]) {
+    Slice hi = q[7];
+
+    q[7] = q[6];
+    q[6] = q[5];
+    q[5] = q[4];
+    q[4] = q[3] ^ hi;
+    q[3] = q[2] ^ hi;
+    q[2] = q[1];
+    q[1] = q[0] ^ hi;
+    q[0] = hi;
+}
+
+/**
+ * performs the mix column step on the bitsliced state
+ * each column byte becomes 2(a[r] ^ a[r+1]) ^ a[r+1] ^ a[r+2] ^ a[r+3]
+ *
+ * @param q the bitsliced state
+ */
+BITSLICE_TARGET static inline void mixColumns(Slice q[8]) {
+    Slice t[8];
+
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        t[j] = q[j] ^ rotateColumns1(q[j]);
+
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        q[j] = rotateColumns1(q[j]) ^ rotateColumns2(t[j]);
+
+    xtime(t);
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        q[j] ^= t[j];
+}
+
+/**
+ * performs the inverse mix column step on the bitsliced state
+ * InvMixColumns factors into MixColumns after a[r] ^= 4(a[r] ^ a[r+2])
+ *
+ * @param q the bitsliced state
+ */
+BITSLICE_TARGET static inline void mixColumnsInv(Slice q[8]) {
+    Slice t[8];
+
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        t[j] = q[j] ^ rotateColumns2(q[j]);
+
+    xtime(t);
+    xtime(t);
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        q[j] ^= t[j];
+
+    mixColumns(q);
+}
+
+BITSLICE_TARGET static inline void addRoundKey(Slice q[8], const uint8_t rkey[8][16]) {
+    #pragma GCC unroll 8
+    for (int j = 0; j < 8; j++)
+        q[j] ^= sliceLoad(rkey[j]);
+}
+
+/**
+ * AES_Bitslice primary constructor
+ *
+ * @param key bytearray of size 16, 24, or 32 depending on the chosen keySize
+ * @param keySize enum with three possible values: AES128 = 16, AES192 = 24, or AES256 = 32
+ *
+ * @throws std::invalid_argument if an x86 CPU does not support the SSE2 instructions
+ */
+AES_Bitslice::AES_Bitslice(const uint8_t key[], AES::KEY_SIZE keySize) : BlockCipher(16), keySize(keySize), nRounds(keySize / 4 + 6) {
+    if (!isSupported())
+        throw std::invalid_argument("SSE2 is not supported by this CPU");
+
+    setKey(key);
+}
+
+/**
+ * AES_Bitslice copy constructor
+ *
+ * @param that reference to a preexisting AES_Bitslice object that should be copied
+ */
+AES_Bitslice::AES_Bitslice(const AES_Bitslice &that) : AES_Bitslice(that.key, that.keySize) {
+
+}
+
+/**
+ * AES_Bitslice destructor
+ */
+AES_Bitslice::~AES_Bitslice() {
+    wipe(key, sizeof(key));
+    wipe(rkeys, sizeof(rkeys));
+}
+
+/**
+ * replaces the key and expands it again in place, so modes and kernels that refer to this object keep working
+ *
+ * @param key bytearray of the key size given at construction
+ */
+void AES_Bitslice::setKey(const uint8_t key[]) {
+    for (int i = 0; i < keySize; i++)
+        this->key[i] = key[i];
+
+    generateExpandedKey();
+}
+
+/**
+ * encrypts a block of plaintext and returns the resulting ciphertext
+ * the block still costs a full pass over [AES_Bitslice::PARALLEL_BLOCKS] blocks, so prefer encryptBlocks
+ *
+ * @param plaintext a 16 byte array of data for encrypting
+ * @param ciphertext a 16 byte array for returning the resulting encrypted ciphertext
+ */
+void AES_Bitslice::encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const {
+    encryptBlocks(plaintext, ciphertext, 1);
+}
+
+/**
+ * decrypts a block of ciphertext and returns the resulting plaintext
+ * the block still costs a full pass over [AES_Bitslice::PARALLEL_BLOCKS] blocks, so prefer decryptBlocks
+ *
+ * @param ciphertext a 16 byte array of data for decrypting
+ * @param plaintext a 16 byte array for returning the resulting decrypted plaintext
+ */
+void AES_Bitslice::decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const {
+    decryptBlocks(ciphertext, plaintext, 1);
+}
+
+/**
+ * encrypts a run of consecutive blocks [AES_Bitslice::PARALLEL_BLOCKS] at a time
+ * a trailing group of fewer blocks is padded with zero blocks
+ *
+ * @param plaintext nblocks * 16 bytes of data for encrypting
+ * @param ciphertext nblocks * 16 bytes for returning the resulting encrypted ciphertext
+ * @param nblocks the number of blocks to encrypt
+ */
+void AES_Bitslice::encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    for (; nblocks >= PARALLEL_BLOCKS; nblocks -= PARALLEL_BLOCKS, plaintext += 16 * PARALLEL_BLOCKS, ciphertext += 16 * PARALLEL_BLOCKS)
+        encrypt8(plaintext, ciphertext);
+
+    if (nblocks) {
+        uint8_t buffer[16 * PARALLEL_BLOCKS] = { 0 };
+
+        for (size_t i = 0; i < 16 * nblocks; i++)
+            buffer[i] = plaintext[i];
+        encrypt8(buffer, buffer);
+        for (size_t i = 0; i < 16 * nblocks; i++)
+            ciphertext[i] = buffer[i];
+    }
+}
+
+/**
+ * decrypts a run of consecutive blocks [AES_Bitslice::PARALLEL_BLOCKS] at a time
+ * a trailing group of fewer blocks is padded with zero blocks
+ *
+ * @param ciphertext nblocks * 16 bytes of data for decrypting
+ * @param plaintext nblocks * 16 bytes for returning the resulting decrypted plaintext
+ * @param nblocks the number of blocks to decrypt
+ */
+void AES_Bitslice::decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    for (; nblocks >= PARALLEL_BLOCKS; nblocks -= PARALLEL_BLOCKS, ciphertext += 16 * PARALLEL_BLOCKS, plaintext += 16 * PARALLEL_BLOCKS)
+        decrypt8(ciphertext, plaintext);
+
+    if (nblocks) {
+        uint8_t buffer[16 * PARALLEL_BLOCKS] = { 0 };
+
+        for (size_t i = 0; i < 16 * nblocks; i++)
+            buffer[i] = ciphertext[i];
+        decrypt8(buffer, buffer);
+        for (size_t i = 0; i < 16 * nblocks; i++)
+            plaintext[i] = buffer[i];
+    }
+}
+
+/**
+ * encrypts exactly 8 blocks in the bitsliced representation
+ *
+ * @param plaintext 128 bytes of data for encrypting
+ * @param ciphertext 128 bytes for returning the resulting encrypted ciphertext
+ */
+BITSLICE_TARGET void AES_Bitslice::encrypt8(const uint8_t plaintext[], uint8_t ciphertext[]) const {
+    Slice q[8];
+
+    #pragma GCC unroll 8
+    for (int b = 0; b < 8; b++)
+        q[b] = sliceLoad(plaintext + 16 * b);
+    transpose(q);
+
+    // round 0
+    addRoundKey(q, rkeys[0]);
+
+    // rounds [1-9] / [1-11] / [1-13]
+    for (int round = 1; round < nRounds; round++) {
+        sboxSub(q);
+        shiftRows(q);
+        mixColumns(q);
+        addRoundKey(q, rkeys[round]);
+    }
+
+    // round 10 / 12 / 14
+    sboxSub(q);
+    shiftRows(q);
+    addRoundKey(q, rkeys[nRounds]);
+
+    transpose(q);
+    #pragma GCC unroll 8
+    for (int b = 0; b < 8; b++)
+        sliceStore(ciphertext + 16 * b, q[b]);
+}
+
+/**
+ * decrypts exactly 8 blocks in the bitsliced representation
+ *
+ * @param ciphertext 128 bytes of data for decrypting
+ * @param plaintext 128 bytes for returning the resulting decrypted plaintext
+ */
+BITSLICE_TARGET void AES_Bitslice::decrypt8(const uint8_t ciphertext[], uint8_t plaintext[]) const {
+    Slice q[8];
+
+    #pragma GCC unroll 8
+    for (int b = 0; b < 8; b++)
+        q[b] = sliceLoad(ciphertext + 16 * b);
+    transpose(q);
+
+    // round 10 / 12 / 14
+    addRoundKey(q, rkeys[nRounds]);
+
+    // rounds [9-1] / [11-1] / [13-1]
+    for (int round = nRounds - 1; round > 0; round--) {
+        shiftRowsInv(q);
+        sboxSubInv(q);
+        addRoundKey(q, rkeys[round]);
+        mixColumnsInv(q);
+    }
+
+    // round 0
+    shiftRowsInv(q);
+    sboxSubInv(q);
+    addRoundKey(q, rkeys[0]);
+
+    transpose(q);
+    #pragma GCC unroll 8
+    for (int b = 0; b < 8; b++)
+        sliceStore(plaintext + 16 * b, q[b]);
+}
+
+/**
+ * performs the SBOX substitution of a key schedule word with the bitsliced circuit
+ * so that the key schedule does not index memory with key bytes either
+ *
+ * @param word the word to substitute, byte 0 in the least significant position
+ *
+ * @return the substituted word
+ */
+BITSLICE_TARGET static uint32_t subWord(uint32_t word) {
+    Slice q[8];
+
+    q[0] = sliceFromWord(word);
+    for (int b = 1; b < 8; b++)
+        q[b] = sliceBroadcast(0);
+
+    transpose(q);
+    sboxSub(q);
+    transpose(q);
+
+    return sliceToWord(q[0]);
+}
+
+/**
+ * uses the user-provided key [AES_Bitslice::key] to generate the expanded key
+ * and stores every round key in the bitsliced representation [AES_Bitslice::rkeys], repeated for all 8 blocks
+ *
+ * algorithm is described in FIPS-197 section 5.2
+ */
+BITSLICE_TARGET void AES_Bitslice::generateExpandedKey() {
+    const int nk = keySize / 4, nWords = 4 * (nRounds + 1);
+    uint32_t words[60], rcon = 0x01;
+
+    for (int i = 0; i < nk; i++)
+        words[i] = uint32_t(key[4 * i]) | (uint32_t(key[4 * i + 1]) << 8) | (uint32_t(key[4 * i + 2]) << 16) | (uint32_t(key[4 * i + 3]) << 24);
+
+    for (int i = nk; i < nWords; i++) {
+        uint32_t temp = words[i - 1];
+
+        if (i % nk == 0) {
+            // SubWord, RotWord (a right rotation since byte 0 is the least significant) and XOR with the round constant
+            temp = subWord(temp);
+            temp = ((temp >> 8) | (temp << 24)) ^ rcon;
+            rcon = (rcon << 1) ^ ((rcon & 0x80) ? 0x11b : 0x00);
+        } else if (nk > 6 && i % nk == 4) {
+            temp = subWord(temp);
+        }
+
+        words[i] = words[i - nk] ^ temp;
+    }
+
+    for (int round = 0; round <= nRounds; round++) {
+        uint8_t bytes[16];
+        Slice q[8];
+
+        for (int i = 0; i < 16; i++)
+            bytes[i] = uint8_t(words[4 * round + i / 4] >> (8 * (i % 4)));
+        for (int b = 0; b < 8; b++)
+            q[b] = sliceLoad(bytes);
+        transpose(q);
+
+        for (int j = 0; j < 8; j++)
+            sliceStore(rkeys[round][j], q[j]);
+    }
+}
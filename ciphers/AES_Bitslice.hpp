@@ -0,0 +1,48 @@
+/**
+ * header file for the bitsliced, constant-time AES 128, 192, and 256 block cipher backend.
+ * @file AES_Bitslice.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYAES_BITSLICE
+#define MYAES_BITSLICE
+
+#include <cstdint>
+#include <stdexcept>
+#include "BlockCipher.hpp"
+#include "AES.hpp"
+
+class AES_Bitslice : public BlockCipher {
+private:
+    AES_Bitslice();
+    AES_Bitslice& operator=(const AES_Bitslice &that) = delete;
+
+public:
+    // number of blocks that are encrypted together by one pass of the bitsliced rounds
+    static constexpr size_t PARALLEL_BLOCKS = 8;
+
+    static bool isSupported();
+
+    AES_Bitslice(const uint8_t key[], AES::KEY_SIZE keySize = AES::AES128);
+    AES_Bitslice(const AES_Bitslice &that);
+    ~AES_Bitslice();
+    void setKey(const uint8_t key[]);
+
+    void encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const;
+    void decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const;
+    void encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+
+private:
+    uint8_t key[32];
+    AES::KEY_SIZE keySize;
+    int nRounds;
+    alignas(16) uint8_t rkeys[15][8][16];
+
+    void generateExpandedKey();
+    void encrypt8(const uint8_t plaintext[], uint8_t ciphertext[]) const;
+    void decrypt8(const uint8_t ciphertext[], uint8_t plaintext[]) const;
+};
+
+#endif
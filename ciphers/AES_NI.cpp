@@ -0,0 +1,230 @@
+/**
+ * class implementation for the AES-NI hardware accelerated AES 128, 192, and 256 block cipher backend.
+ * @file AES_NI.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "AES_NI.hpp"
+#include "CPUFeatures.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * AES_NI primary constructor
+ *
+ * @param key bytearray of size 16, 24, or 32 depending on the chosen keySize
+ * @param keySize enum with three possible values: AES128 = 16, AES192 = 24, or AES256 = 32
+ *
+ * @throws std::invalid_argument if the CPU does not support the AES-NI instructions
+ */
+AES_NI::AES_NI(const uint8_t key[], AES::KEY_SIZE keySize) : BlockCipher(16), keySize(keySize), nRounds(keySize / 4 + 6) {
+    if (!CPUFeatures::hasAESNI())
+        throw std::invalid_argument("AES-NI is not supported by this CPU");
+
+    setKey(key);
+}
+
+/**
+ * AES_NI copy constructor
+ *
+ * @param that reference to a preexisting AES_NI object that should be copied
+ */
+AES_NI::AES_NI(const AES_NI &that) : AES_NI(that.key, that.keySize) {
+
+}
+
+/**
+ * AES_NI destructor
+ */
+AES_NI::~AES_NI() {
+    wipe(key, sizeof(key));
+    wipe(ekey, sizeof(ekey));
+    wipe(dkey, sizeof(dkey));
+}
+
+/**
+ * replaces the key and expands it again in place, so modes and kernels that refer to this object keep working
+ *
+ * @param key bytearray of the key size given at construction
+ */
+void AES_NI::setKey(const uint8_t key[]) {
+    for (int i = 0; i < keySize; i++)
+        this->key[i] = key[i];
+
+    generateExpandedKey();
+    generateDecryptionKey();
+}
+
+/**
+ * encrypts a run of consecutive blocks
+ * eight independent blocks are kept in flight so that each AESENC issues while the previous ones are still in the pipeline
+ *
+ * @param plaintext nblocks * 16 bytes of data for encrypting
+ * @param ciphertext nblocks * 16 bytes for returning the resulting encrypted ciphertext
+ * @param nblocks the number of blocks to encrypt
+ */
+AESNI_TARGET void AES_NI::encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    const __m128i *rk = (const __m128i*) ekey;
+    const __m128i *in = (const __m128i*) plaintext;
+    __m128i *out = (__m128i*) ciphertext;
+    __m128i block[8], roundKey;
+
+    for (; nblocks >= 8; nblocks -= 8, in += 8, out += 8) {
+        roundKey = _mm_load_si128(rk);
+        #pragma GCC unroll 8
+        for (int i = 0; i < 8; i++)
+            block[i] = _mm_xor_si128(_mm_loadu_si128(in + i), roundKey);
+
+        for (int round = 1; round < nRounds; round++) {
+            roundKey = _mm_load_si128(rk + round);
+            #pragma GCC unroll 8
+            for (int i = 0; i < 8; i++)
+                block[i] = _mm_aesenc_si128(block[i], roundKey);
+        }
+
+        roundKey = _mm_load_si128(rk + nRounds);
+        #pragma GCC unroll 8
+        for (int i = 0; i < 8; i++)
+            _mm_storeu_si128(out + i, _mm_aesenclast_si128(block[i], roundKey));
+    }
+
+    for (; nblocks > 0; nblocks--, in++, out++)
+        AES_NI::encryptBlock((const uint8_t*) in, (uint8_t*) out);
+}
+
+/**
+ * decrypts a run of consecutive blocks
+ * eight independent blocks are kept in flight so that each AESDEC issues while the previous ones are still in the pipeline
+ *
+ * @param ciphertext nblocks * 16 bytes of data for decrypting
+ * @param plaintext nblocks * 16 bytes for returning the resulting decrypted plaintext
+ * @param nblocks the number of blocks to decrypt
+ */
+AESNI_TARGET void AES_NI::decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    const __m128i *rk = (const __m128i*) dkey;
+    const __m128i *in = (const __m128i*) ciphertext;
+    __m128i *out = (__m128i*) plaintext;
+    __m128i block[8], roundKey;
+
+    for (; nblocks >= 8; nblocks -= 8, in += 8, out += 8) {
+        roundKey = _mm_load_si128(rk);
+        #pragma GCC unroll 8
+        for (int i = 0; i < 8; i++)
+            block[i] = _mm_xor_si128(_mm_loadu_si128(in + i), roundKey);
+
+        for (int round = 1; round < nRounds; round++) {
+            roundKey = _mm_load_si128(rk + round);
+            #pragma GCC unroll 8
+            for (int i = 0; i < 8; i++)
+                block[i] = _mm_aesdec_si128(block[i], roundKey);
+        }
+
+        roundKey = _mm_load_si128(rk + nRounds);
+        #pragma GCC unroll 8
+        for (int i = 0; i < 8; i++)
+            _mm_storeu_si128(out + i, _mm_aesdeclast_si128(block[i], roundKey));
+    }
+
+    for (; nblocks > 0; nblocks--, in++, out++)
+        AES_NI::decryptBlock((const uint8_t*) in, (uint8_t*) out);
+}
+
+/**
+ * performs the SBOX substitution of a key schedule word using AESKEYGENASSIST
+ *
+ * @param word the word to substitute, byte 0 in the least significant position
+ *
+ * @return the substituted word
+ */
+AESNI_TARGET static inline uint32_t subWord(uint32_t word) {
+    return _mm_cvtsi128_si32(_mm_aeskeygenassist_si128(_mm_set1_epi32(word), 0x00));
+}
+
+/**
+ * uses the user-provided key [AES_NI::key] to generate the expanded key [AES_NI::ekey]
+ * one schedule word at a time so that all three key sizes share a single loop
+ *
+ * algorithm is described in FIPS-197 section 5.2
+ */
+AESNI_TARGET void AES_NI::generateExpandedKey() {
+    const int nk = keySize / 4, nWords = 4 * (nRounds + 1);
+    uint32_t words[60], rcon = 0x01;
+
+    for (int i = 0; i < nk; i++)
+        words[i] = uint32_t(key[4 * i]) | (uint32_t(key[4 * i + 1]) << 8) | (uint32_t(key[4 * i + 2]) << 16) | (uint32_t(key[4 * i + 3]) << 24);
+
+    for (int i = nk; i < nWords; i++) {
+        uint32_t temp = words[i - 1];
+
+        if (i % nk == 0) {
+            // SubWord, RotWord (a right rotation since byte 0 is the least significant) and XOR with the round constant
+            temp = subWord(temp);
+            temp = ((temp >> 8) | (temp << 24)) ^ rcon;
+            rcon = (rcon << 1) ^ ((rcon & 0x80) ? 0x11b : 0x00);
+        } else if (nk > 6 && i % nk == 4) {
+            temp = subWord(temp);
+        }
+
+        words[i] = words[i - nk] ^ temp;
+    }
+
+    for (int i = 0; i < nWords; i++)
+        for (int j = 0; j < 4; j++)
+            ekey[4 * i + j] = words[i] >> (8 * j);
+}
+
+/**
+ * builds the decryption key schedule [AES_NI::dkey] for the equivalent inverse cipher used by AESDEC
+ * the round keys are used in reverse order and the inner ones have AESIMC (InvMixColumns) applied
+ */
+AESNI_TARGET void AES_NI::generateDecryptionKey() {
+    const __m128i *rk = (const __m128i*) ekey;
+    __m128i *drk = (__m128i*) dkey;
+
+    _mm_store_si128(drk, _mm_load_si128(rk + nRounds));
+    for (int round = 1; round < nRounds; round++)
+        _mm_store_si128(drk + round, _mm_aesimc_si128(_mm_load_si128(rk + nRounds - round)));
+    _mm_store_si128(drk + nRounds, _mm_load_si128(rk));
+}
+
+#else
+
+/**
+ * AES_NI primary constructor for processors without AES-NI
+ *
+ * @throws std::invalid_argument always since AES-NI only exists on x86 processors
+ */
+AES_NI::AES_NI(const uint8_t[], AES::KEY_SIZE keySize) : BlockCipher(16), keySize(keySize), nRounds(keySize / 4 + 6) {
+    throw std::invalid_argument("AES-NI is not supported by this CPU");
+}
+
+AES_NI::AES_NI(const AES_NI &that) : AES_NI(that.key, that.keySize) {
+
+}
+
+AES_NI::~AES_NI() {
+
+}
+
+void AES_NI::setKey(const uint8_t[]) {
+
+}
+
+void AES_NI::encryptBlock(const uint8_t[], uint8_t[]) const {
+
+}
+
+void AES_NI::decryptBlock(const uint8_t[], uint8_t[]) const {
+
+}
+
+void AES_NI::encryptBlocks(const uint8_t *, uint8_t *, size_t) const {
+
+}
+
+void AES_NI::decryptBlocks(const uint8_t *, uint8_t *, size_t) const {
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * header file for the AES-NI hardware accelerated AES 128, 192, and 256 block cipher backend.
+ * @file AES_NI.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYAES_NI
+#define MYAES_NI
+
+#include <cstdint>
+#include <stdexcept>
+#include "BlockCipher.hpp"
+#include "AES.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// the AES-NI intrinsics are compiled for these functions only so the rest of the library stays portable
+#define AESNI_TARGET __attribute__((target("aes,sse2")))
+#endif
+
+class AES_NI final : public BlockCipher {
+private:
+    AES_NI();
+    AES_NI& operator=(const AES_NI &that) = delete;
+
+public:
+    // known at compile time so mode kernels templated on this class can unroll over the block
+    static constexpr uint8_t BLOCK_SIZE = 16;
+
+    AES_NI(const uint8_t key[], AES::KEY_SIZE keySize = AES::AES128);
+    AES_NI(const AES_NI &that);
+    ~AES_NI();
+    void setKey(const uint8_t key[]);
+
+    void encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const;
+    void decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const;
+    void encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+
+private:
+    uint8_t key[32];
+    AES::KEY_SIZE keySize;
+    int nRounds;
+    alignas(16) uint8_t ekey[240];
+    alignas(16) uint8_t dkey[240];
+
+    void generateExpandedKey();
+    void generateDecryptionKey();
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * encrypts a block of plaintext and returns the resulting ciphertext
+ * each AESENC instruction performs a full inner round
+ * defined here so that code compiled for AES-NI, such as CipherModeKernel<AES_NI>, can inline the rounds into its own loop
+ *
+ * instructions are described at: https://www.intel.com/content/dam/doc/white-paper/advanced-encryption-standard-new-instructions-set-paper.pdf
+ *
+ * @param plaintext a 16 byte array of data for encrypting
+ * @param ciphertext a 16 byte array for returning the resulting encrypted ciphertext
+ */
+AESNI_TARGET inline void AES_NI::encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const {
+    const __m128i *rk = (const __m128i*) ekey;
+
+    __m128i block = _mm_xor_si128(_mm_loadu_si128((const __m128i*) plaintext), _mm_load_si128(rk));
+    for (int round = 1; round < nRounds; round++)
+        block = _mm_aesenc_si128(block, _mm_load_si128(rk + round));
+    block = _mm_aesenclast_si128(block, _mm_load_si128(rk + nRounds));
+
+    _mm_storeu_si128((__m128i*) ciphertext, block);
+}
+
+/**
+ * decrypts a block of ciphertext and returns the resulting plaintext
+ * each AESDEC instruction performs a full inner round of the equivalent inverse cipher
+ *
+ * @param ciphertext a 16 byte array of data for decrypting
+ * @param plaintext a 16 byte array for returning the resulting decrypted plaintext
+ */
+AESNI_TARGET inline void AES_NI::decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const {
+    const __m128i *rk = (const __m128i*) dkey;
+
+    __m128i block = _mm_xor_si128(_mm_loadu_si128((const __m128i*) ciphertext), _mm_load_si128(rk));
+    for (int round = 1; round < nRounds; round++)
+        block = _mm_aesdec_si128(block, _mm_load_si128(rk + round));
+    block = _mm_aesdeclast_si128(block, _mm_load_si128(rk + nRounds));
+
+    _mm_storeu_si128((__m128i*) plaintext, block);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * header file for the byte-matrix AES 128, 192, and 256 block cipher, specialized at compile time on the key size.
+ * @file AES_Reference.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYAES_REFERENCE
+#define MYAES_REFERENCE
+
+#include <cstdint>
+#include "BlockCipher.hpp"
+#include "AES.hpp"
+
+template <AES::KEY_SIZE KEY_SIZE>
+class AES_Reference : public BlockCipher {
+private:
+    AES_Reference();
+    AES_Reference& operator=(const AES_Reference &that) = delete;
+
+public:
+    // the different variations of AES require a different number of rounds, known here at compile time
+    static constexpr int N_ROUNDS = KEY_SIZE / 4 + 6;
+    static constexpr int EXPANDED_KEY_SIZE = 16 * (N_ROUNDS + 1);
+
+    AES_Reference(const uint8_t key[]);
+    AES_Reference(const AES_Reference &that);
+    ~AES_Reference();
+    void setKey(const uint8_t key[]);
+
+    void encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const;
+    void decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const;
+
+private:
+    uint8_t key[KEY_SIZE];
+    uint8_t ekey[EXPANDED_KEY_SIZE];
+    uint8_t dkey[EXPANDED_KEY_SIZE];
+
+    void generateExpandedKey();
+    void generateDecryptionKey();
+
+    static void addRoundKey(uint8_t block[4][4], const uint8_t schedule[], int round);
+    static void sboxSub(uint8_t block[4][4]);
+    static void sboxSubInv(uint8_t block[4][4]);
+    static void shiftRows(uint8_t block[4][4]);
+    static void shiftRowsInv(uint8_t block[4][4]);
+    static void mixColumns(uint8_t block[4][4]);
+    static void mixColumnsInv(uint8_t block[4][4]);
+    static uint8_t xtime(uint8_t a);
+    static uint8_t multiplyGF(uint8_t a, uint8_t b);
+};
+
+// the three specializations are compiled once in AES_Reference.cpp
+extern template class AES_Reference<AES::AES128>;
+extern template class AES_Reference<AES::AES192>;
+extern template class AES_Reference<AES::AES256>;
+
+#endif
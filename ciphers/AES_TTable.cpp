@@ -0,0 +1,316 @@
+/**
+ * class implementation for the word-oriented (T-table) AES 128, 192, and 256 block cipher backend.
+ * @file AES_TTable.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "AES_TTable.hpp"
+
+/**
+ * helpers for moving between the 16 byte blocks and the big-endian 32-bit words used by the tables
+ */
+static inline uint32_t load32(const uint8_t bytes[]) {
+    return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+static inline void store32(uint8_t bytes[], uint32_t word) {
+    bytes[0] = word >> 24;
+    bytes[1] = word >> 16;
+    bytes[2] = word >> 8;
+    bytes[3] = word;
+}
+
+static constexpr uint32_t rotr8(uint32_t word) {
+    return (word >> 8) | (word << 24);
+}
+
+/**
+ * the SBOX and the fused round tables, read by the key schedule and every round
+ */
+struct RoundTables {
+    uint32_t te[4][256];
+    uint32_t td[4][256];
+    uint8_t sbox[256];
+    uint8_t sboxInv[256];
+};
+
+/**
+ * multiplication in GF(2^8) modulo x^8 + x^4 + x^3 + x + 1, usable during compilation
+ */
+static constexpr uint8_t multiplyGF(uint8_t a, uint8_t b) {
+    uint8_t product = 0;
+    for (int i = 0; i < 8; i++, b >>= 1) {
+        if (b & 1)
+            product ^= a;
+        a = (a << 1) ^ ((a & 0x80) ? 0x1b : 0x00);
+    }
+    return product;
+}
+
+/**
+ * builds the SBOX and the fused round tables from the Galois Field definitions during compilation,
+ * so they are filled in before any static constructor in another file can expand a key with them
+ * TE[0][x] holds the MixColumns column (2s, s, s, 3s) for s = SBOX[x], TD[0][x] holds (14s, 9s, 13s, 11s) for s = SBOX_INV[x]
+ * TE[i] and TD[i] are TE[0] and TD[0] rotated right by i bytes
+ *
+ * tables are described at: https://en.wikipedia.org/wiki/Rijndael_S-box
+ */
+static constexpr RoundTables generateTables() {
+    RoundTables tables {};
+    uint8_t exp[256] {}, log[256] {};
+
+    // powers of the generator 0x03 give the multiplicative inverse of x as EXP[255 - LOG[x]]
+    uint8_t power = 1;
+    for (int i = 0; i < 255; i++, power = multiplyGF(power, 0x03)) {
+        exp[i] = power;
+        log[power] = i;
+    }
+
+    // SBOX[x] is the affine transform of the multiplicative inverse of x
+    for (int x = 0; x < 256; x++) {
+        uint8_t inverse = x ? exp[(255 - log[x]) % 255] : 0, s = inverse;
+        for (int i = 1; i < 5; i++)
+            s ^= (inverse << i) | (inverse >> (8 - i));
+        s ^= 0x63;
+
+        tables.sbox[x] = s;
+        tables.sboxInv[s] = x;
+    }
+
+    for (int x = 0; x < 256; x++) {
+        uint8_t s = tables.sbox[x], si = tables.sboxInv[x];
+
+        uint32_t te = (uint32_t(multiplyGF(s, 2)) << 24) | (uint32_t(s) << 16) | (uint32_t(s) << 8) | multiplyGF(s, 3);
+        uint32_t td = (uint32_t(multiplyGF(si, 14)) << 24) | (uint32_t(multiplyGF(si, 9)) << 16) | (uint32_t(multiplyGF(si, 13)) << 8) | multiplyGF(si, 11);
+
+        for (int i = 0; i < 4; i++) {
+            tables.te[i][x] = te;
+            tables.td[i][x] = td;
+            te = rotr8(te);
+            td = rotr8(td);
+        }
+    }
+
+    return tables;
+}
+
+static constexpr RoundTables TABLES = generateTables();
+
+static_assert(TABLES.sbox[0x00] == 0x63 && TABLES.sbox[0x53] == 0xed && TABLES.sboxInv[0x63] == 0x00, "generated SBOX does not match FIPS-197");
+static_assert(TABLES.te[0][0x00] == 0xc66363a5 && TABLES.td[0][0x00] == 0x51f4a750, "generated round tables do not match FIPS-197");
+
+/**
+ * AES_TTable primary constructor
+ *
+ * @param key bytearray of size 16, 24, or 32 depending on the chosen keySize
+ * @param keySize enum with three possible values: AES128 = 16, AES192 = 24, or AES256 = 32
+ */
+AES_TTable::AES_TTable(const uint8_t key[], AES::KEY_SIZE keySize) : BlockCipher(16), keySize(keySize), nRounds(keySize / 4 + 6) {
+    setKey(key);
+}
+
+/**
+ * AES_TTable copy constructor
+ *
+ * @param that reference to a preexisting AES_TTable object that should be copied
+ */
+AES_TTable::AES_TTable(const AES_TTable &that) : AES_TTable(that.key, that.keySize) {
+
+}
+
+/**
+ * AES_TTable destructor
+ */
+AES_TTable::~AES_TTable() {
+    wipe(key, sizeof(key));
+    wipe(ekey, sizeof(ekey));
+    wipe(dkey, sizeof(dkey));
+}
+
+/**
+ * replaces the key and expands it again in place, so modes and kernels that refer to this object keep working
+ *
+ * @param key bytearray of the key size given at construction
+ */
+void AES_TTable::setKey(const uint8_t key[]) {
+    for (int i = 0; i < keySize; i++)
+        this->key[i] = key[i];
+
+    generateExpandedKey();
+    generateDecryptionKey();
+}
+
+/**
+ * encrypts a block of plaintext and returns the resulting ciphertext
+ *
+ * each of the inner rounds fuses SubBytes, ShiftRows and MixColumns into four table lookups per column
+ * algorithm is described at: https://en.wikipedia.org/wiki/Advanced_Encryption_Standard#Optimization_of_the_cipher
+ *
+ * @param plaintext a 16 byte array of data for encrypting
+ * @param ciphertext a 16 byte array for returning the resulting encrypted ciphertext
+ */
+void AES_TTable::encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const {
+    const uint32_t (*te)[256] = TABLES.te;
+    const uint8_t *sbox = TABLES.sbox;
+    const uint32_t *rk = ekey;
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+
+    // round 0
+    s0 = load32(plaintext) ^ rk[0];
+    s1 = load32(plaintext + 4) ^ rk[1];
+    s2 = load32(plaintext + 8) ^ rk[2];
+    s3 = load32(plaintext + 12) ^ rk[3];
+
+    // rounds [1-9] / [1-11] / [1-13]
+    for (int round = 1; round < nRounds; round++) {
+        rk += 4;
+        t0 = te[0][s0 >> 24] ^ te[1][(s1 >> 16) & 0xff] ^ te[2][(s2 >> 8) & 0xff] ^ te[3][s3 & 0xff] ^ rk[0];
+        t1 = te[0][s1 >> 24] ^ te[1][(s2 >> 16) & 0xff] ^ te[2][(s3 >> 8) & 0xff] ^ te[3][s0 & 0xff] ^ rk[1];
+        t2 = te[0][s2 >> 24] ^ te[1][(s3 >> 16) & 0xff] ^ te[2][(s0 >> 8) & 0xff] ^ te[3][s1 & 0xff] ^ rk[2];
+        t3 = te[0][s3 >> 24] ^ te[1][(s0 >> 16) & 0xff] ^ te[2][(s1 >> 8) & 0xff] ^ te[3][s2 & 0xff] ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    // round 10 / 12 / 14 has no MixColumns so the plain SBOX is used
+    rk += 4;
+    t0 = (uint32_t(sbox[s0 >> 24]) << 24) ^ (uint32_t(sbox[(s1 >> 16) & 0xff]) << 16) ^ (uint32_t(sbox[(s2 >> 8) & 0xff]) << 8) ^ sbox[s3 & 0xff] ^ rk[0];
+    t1 = (uint32_t(sbox[s1 >> 24]) << 24) ^ (uint32_t(sbox[(s2 >> 16) & 0xff]) << 16) ^ (uint32_t(sbox[(s3 >> 8) & 0xff]) << 8) ^ sbox[s0 & 0xff] ^ rk[1];
+    t2 = (uint32_t(sbox[s2 >> 24]) << 24) ^ (uint32_t(sbox[(s3 >> 16) & 0xff]) << 16) ^ (uint32_t(sbox[(s0 >> 8) & 0xff]) << 8) ^ sbox[s1 & 0xff] ^ rk[2];
+    t3 = (uint32_t(sbox[s3 >> 24]) << 24) ^ (uint32_t(sbox[(s0 >> 16) & 0xff]) << 16) ^ (uint32_t(sbox[(s1 >> 8) & 0xff]) << 8) ^ sbox[s2 & 0xff] ^ rk[3];
+
+    store32(ciphertext, t0);
+    store32(ciphertext + 4, t1);
+    store32(ciphertext + 8, t2);
+    store32(ciphertext + 12, t3);
+}
+
+/**
+ * decrypts a block of ciphertext and returns the resulting plaintext
+ *
+ * uses the equivalent inverse cipher so that the inner rounds have the same shape as encryption
+ * algorithm is described in FIPS-197 section 5.3.5
+ *
+ * @param ciphertext a 16 byte array of data for decrypting
+ * @param plaintext a 16 byte array for returning the resulting decrypted plaintext
+ */
+void AES_TTable::decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const {
+    const uint32_t (*td)[256] = TABLES.td;
+    const uint8_t *sboxInv = TABLES.sboxInv;
+    const uint32_t *rk = dkey;
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+
+    // round 10 / 12 / 14
+    s0 = load32(ciphertext) ^ rk[0];
+    s1 = load32(ciphertext + 4) ^ rk[1];
+    s2 = load32(ciphertext + 8) ^ rk[2];
+    s3 = load32(ciphertext + 12) ^ rk[3];
+
+    // rounds [9-1] / [11-1] / [13-1]
+    for (int round = 1; round < nRounds; round++) {
+        rk += 4;
+        t0 = td[0][s0 >> 24] ^ td[1][(s3 >> 16) & 0xff] ^ td[2][(s2 >> 8) & 0xff] ^ td[3][s1 & 0xff] ^ rk[0];
+        t1 = td[0][s1 >> 24] ^ td[1][(s0 >> 16) & 0xff] ^ td[2][(s3 >> 8) & 0xff] ^ td[3][s2 & 0xff] ^ rk[1];
+        t2 = td[0][s2 >> 24] ^ td[1][(s1 >> 16) & 0xff] ^ td[2][(s0 >> 8) & 0xff] ^ td[3][s3 & 0xff] ^ rk[2];
+        t3 = td[0][s3 >> 24] ^ td[1][(s2 >> 16) & 0xff] ^ td[2][(s1 >> 8) & 0xff] ^ td[3][s0 & 0xff] ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    // round 0 has no InvMixColumns so the plain inverse SBOX is used
+    rk += 4;
+    t0 = (uint32_t(sboxInv[s0 >> 24]) << 24) ^ (uint32_t(sboxInv[(s3 >> 16) & 0xff]) << 16) ^ (uint32_t(sboxInv[(s2 >> 8) & 0xff]) << 8) ^ sboxInv[s1 & 0xff] ^ rk[0];
+    t1 = (uint32_t(sboxInv[s1 >> 24]) << 24) ^ (uint32_t(sboxInv[(s0 >> 16) & 0xff]) << 16) ^ (uint32_t(sboxInv[(s3 >> 8) & 0xff]) << 8) ^ sboxInv[s2 & 0xff] ^ rk[1];
+    t2 = (uint32_t(sboxInv[s2 >> 24]) << 24) ^ (uint32_t(sboxInv[(s1 >> 16) & 0xff]) << 16) ^ (uint32_t(sboxInv[(s0 >> 8) & 0xff]) << 8) ^ sboxInv[s3 & 0xff] ^ rk[2];
+    t3 = (uint32_t(sboxInv[s3 >> 24]) << 24) ^ (uint32_t(sboxInv[(s2 >> 16) & 0xff]) << 16) ^ (uint32_t(sboxInv[(s1 >> 8) & 0xff]) << 8) ^ sboxInv[s0 & 0xff] ^ rk[3];
+
+    store32(plaintext, t0);
+    store32(plaintext + 4, t1);
+    store32(plaintext + 8, t2);
+    store32(plaintext + 12, t3);
+}
+
+/**
+ * encrypts a run of consecutive blocks
+ * the per-block calls are resolved statically so the round code is inlined into a single loop
+ *
+ * @param plaintext nblocks * 16 bytes of data for encrypting
+ * @param ciphertext nblocks * 16 bytes for returning the resulting encrypted ciphertext
+ * @param nblocks the number of blocks to encrypt
+ */
+void AES_TTable::encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    for (size_t i = 0; i < nblocks; i++)
+        AES_TTable::encryptBlock(plaintext + 16 * i, ciphertext + 16 * i);
+}
+
+/**
+ * decrypts a run of consecutive blocks
+ * the per-block calls are resolved statically so the round code is inlined into a single loop
+ *
+ * @param ciphertext nblocks * 16 bytes of data for decrypting
+ * @param plaintext nblocks * 16 bytes for returning the resulting decrypted plaintext
+ * @param nblocks the number of blocks to decrypt
+ */
+void AES_TTable::decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    for (size_t i = 0; i < nblocks; i++)
+        AES_TTable::decryptBlock(ciphertext + 16 * i, plaintext + 16 * i);
+}
+
+/**
+ * performs a byte-wise SBOX substitution on the four bytes of a key schedule word
+ *
+ * @param word the word to substitute
+ *
+ * @return the substituted word
+ */
+uint32_t AES_TTable::subWord(uint32_t word) {
+    const uint8_t *sbox = TABLES.sbox;
+    return (uint32_t(sbox[word >> 24]) << 24) | (uint32_t(sbox[(word >> 16) & 0xff]) << 16) | (uint32_t(sbox[(word >> 8) & 0xff]) << 8) | sbox[word & 0xff];
+}
+
+/**
+ * uses the user-provided key [AES_TTable::key] to generate the word-oriented expanded key [AES_TTable::ekey]
+ *
+ * algorithm is described in FIPS-197 section 5.2
+ */
+void AES_TTable::generateExpandedKey() {
+    const int nk = keySize / 4, nWords = 4 * (nRounds + 1);
+    uint32_t rcon = 0x01;
+
+    for (int i = 0; i < nk; i++)
+        ekey[i] = load32(key + 4 * i);
+
+    for (int i = nk; i < nWords; i++) {
+        uint32_t temp = ekey[i - 1];
+
+        if (i % nk == 0) {
+            // RotWord, SubWord and XOR with the round constant
+            temp = subWord((temp << 8) | (temp >> 24)) ^ (rcon << 24);
+            rcon = (rcon << 1) ^ ((rcon & 0x80) ? 0x11b : 0x00);
+        } else if (nk > 6 && i % nk == 4) {
+            temp = subWord(temp);
+        }
+
+        ekey[i] = ekey[i - nk] ^ temp;
+    }
+}
+
+/**
+ * builds the decryption key schedule [AES_TTable::dkey] for the equivalent inverse cipher
+ * the round keys are used in reverse order and the inner ones have InvMixColumns applied
+ */
+void AES_TTable::generateDecryptionKey() {
+    const uint32_t (*td)[256] = TABLES.td;
+    const uint8_t *sbox = TABLES.sbox;
+
+    for (int round = 0; round <= nRounds; round++) {
+        for (int i = 0; i < 4; i++) {
+            uint32_t word = ekey[4 * (nRounds - round) + i];
+
+            // TD[i][SBOX[x]] is InvMixColumns applied to a lone byte x so four lookups transform the whole word
+            if (round != 0 && round != nRounds)
+                word = td[0][sbox[word >> 24]] ^ td[1][sbox[(word >> 16) & 0xff]] ^ td[2][sbox[(word >> 8) & 0xff]] ^ td[3][sbox[word & 0xff]];
+
+            dkey[4 * round + i] = word;
+        }
+    }
+}
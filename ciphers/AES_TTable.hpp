@@ -0,0 +1,47 @@
+/**
+ * header file for the word-oriented (T-table) AES 128, 192, and 256 block cipher backend.
+ * @file AES_TTable.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYAES_TTABLE
+#define MYAES_TTABLE
+
+#include <cstdint>
+#include "BlockCipher.hpp"
+#include "AES.hpp"
+
+class AES_TTable final : public BlockCipher {
+private:
+    AES_TTable();
+    AES_TTable& operator=(const AES_TTable &that) = delete;
+
+public:
+    // known at compile time so mode kernels templated on this class can unroll over the block
+    static constexpr uint8_t BLOCK_SIZE = 16;
+
+    AES_TTable(const uint8_t key[], AES::KEY_SIZE keySize = AES::AES128);
+    AES_TTable(const AES_TTable &that);
+    ~AES_TTable();
+    void setKey(const uint8_t key[]);
+
+    void encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const;
+    void decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const;
+    void encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+
+private:
+    uint8_t key[32];
+    AES::KEY_SIZE keySize;
+    int nRounds;
+    uint32_t ekey[60];
+    uint32_t dkey[60];
+
+    void generateExpandedKey();
+    void generateDecryptionKey();
+
+    static uint32_t subWord(uint32_t word);
+};
+
+#endif
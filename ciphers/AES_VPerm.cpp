@@ -0,0 +1,459 @@
+/**
+ * class implementation for the vector-permute (SSSE3), constant-time AES 128, 192, and 256 block cipher backend.
+ * @file AES_VPerm.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "AES_VPerm.hpp"
+#include "CPUFeatures.hpp"
+
+/**
+ * the SBOX is computed rather than looked up: a byte is mapped into the tower field GF((2^4)^2),
+ * inverted there with GF(2^4) arithmetic on nibbles, and mapped back while applying the SBOX affine transform
+ * every GF(2^4) table has 16 entries, so PSHUFB looks up all 16 state bytes at once in a register
+ * and no memory access depends on the key or the data
+ *
+ * technique is described at: https://shiftleft.com/mirrors/www.hamburg.org/data/vpaes-ches-2009.pdf
+ */
+
+/**
+ * every table has 16 entries so that it fits in one register and is indexed by PSHUFB
+ */
+struct NibbleTables {
+    alignas(16) uint8_t encryptIn[2][16];
+    alignas(16) uint8_t encryptOut[2][16];
+    alignas(16) uint8_t decryptIn[2][16];
+    alignas(16) uint8_t decryptOut[2][16];
+    alignas(16) uint8_t log[16];
+    alignas(16) uint8_t exp[16];
+    alignas(16) uint8_t inverse[16];
+    alignas(16) uint8_t square[16];
+    alignas(16) uint8_t squareLambda[16];
+};
+
+/**
+ * multiplication in GF(2^4) modulo x^4 + x + 1 and in GF(2^8) modulo x^8 + x^4 + x^3 + x + 1, usable during compilation
+ */
+static constexpr uint8_t multiply16(uint8_t a, uint8_t b) {
+    uint8_t product = 0;
+    for (int i = 0; i < 4; i++, b >>= 1) {
+        if (b & 1)
+            product ^= a;
+        a = (a << 1) ^ ((a & 0x08) ? 0x13 : 0x00);
+    }
+    return product;
+}
+
+static constexpr uint8_t multiply256(uint8_t a, uint8_t b) {
+    uint8_t product = 0;
+    for (int i = 0; i < 8; i++, b >>= 1) {
+        if (b & 1)
+            product ^= a;
+        a = (a << 1) ^ ((a & 0x80) ? 0x1b : 0x00);
+    }
+    return product;
+}
+
+/**
+ * builds the nibble tables from the field definitions during compilation,
+ * so they are filled in before any static constructor in another file can expand a key with them
+ * GF(2^4) uses x^4 + x + 1, the tower uses Y^2 + Y + lambda with the first lambda that makes it irreducible
+ * LOG[0] is 0xc0 so that any product with 0 sums to a negative index, which PSHUFB turns into 0
+ */
+static constexpr NibbleTables generateTables() {
+    NibbleTables tables {};
+    uint8_t embed[16] {}, phi[256] {}, phiInv[256] {}, affine[256] {}, affineInv[256] {};
+    uint8_t lambda = 0, w = 0, g = 0;
+
+    // GF(2^4) log, exp, inverse and square tables with generator 0x02
+    for (uint8_t i = 0, x = 1; i < 15; i++, x = multiply16(x, 2)) {
+        tables.exp[i] = x;
+        tables.log[x] = i;
+    }
+    tables.exp[15] = 0;
+    tables.log[0] = 0xc0;
+
+    for (int a = 0; a < 16; a++) {
+        tables.inverse[a] = 0;
+        for (int b = 1; b < 16 && a; b++)
+            if (multiply16(a, b) == 1)
+                tables.inverse[a] = b;
+        tables.square[a] = multiply16(a, a);
+    }
+
+    for (int l = 1; l < 16 && !lambda; l++) {
+        bool root = false;
+        for (int y = 0; y < 16; y++)
+            root |= (multiply16(y, y) ^ y ^ l) == 0;
+        if (!root)
+            lambda = l;
+    }
+
+    for (int a = 0; a < 16; a++)
+        tables.squareLambda[a] = multiply16(lambda, tables.square[a]);
+
+    // embed GF(2^4) into GF(2^8) through a root w of x^4 + x + 1, then find a root g of Y^2 + Y + lambda
+    for (int c = 2; c < 256 && !w; c++) {
+        uint8_t c2 = multiply256(c, c);
+        if ((multiply256(c2, c2) ^ c ^ 1) == 0)
+            w = c;
+    }
+
+    for (int c = 0; c < 16; c++) {
+        uint8_t power = 1;
+        embed[c] = 0;
+        for (int i = 0; i < 4; i++, power = multiply256(power, w))
+            if ((c >> i) & 1)
+                embed[c] ^= power;
+    }
+
+    for (int c = 0; c < 256 && !g; c++)
+        if ((multiply256(c, c) ^ c ^ embed[lambda]) == 0)
+            g = c;
+
+    // phi maps the tower element (a << 4 | b) = aY + b to GF(2^8), affine is the linear part of the SBOX affine transform
+    for (int x = 0; x < 256; x++) {
+        phi[x] = multiply256(embed[x >> 4], g) ^ embed[x & 0x0f];
+        phiInv[phi[x]] = x;
+
+        uint8_t s = x;
+        for (int i = 1; i < 5; i++)
+            s ^= (x << i) | (x >> (8 - i));
+        affine[x] = s;
+        affineInv[s] = x;
+    }
+
+    // every map is linear (or affine) so it splits into a table for each nibble
+    for (int n = 0; n < 16; n++) {
+        tables.encryptIn[0][n] = phiInv[n];
+        tables.encryptIn[1][n] = phiInv[n << 4];
+        tables.encryptOut[0][n] = affine[phi[n]];
+        tables.encryptOut[1][n] = affine[phi[n << 4]] ^ 0x63;
+        tables.decryptIn[0][n] = phiInv[affineInv[n]];
+        tables.decryptIn[1][n] = phiInv[affineInv[n << 4]] ^ phiInv[affineInv[0x63]];
+        tables.decryptOut[0][n] = phi[n];
+        tables.decryptOut[1][n] = phi[n << 4];
+    }
+
+    return tables;
+}
+
+static constexpr NibbleTables TABLES = generateTables();
+
+static_assert(TABLES.log[0x01] == 0 && TABLES.exp[0x01] == 0x02 && TABLES.inverse[0x02] == 0x09, "generated GF(2^4) tables do not match x^4 + x + 1");
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+
+#define VPERM_TARGET __attribute__((target("ssse3")))
+
+/**
+ * the tables and byte permutations held in registers for the duration of a call
+ */
+struct VPermConstants {
+    __m128i encryptIn[2], encryptOut[2], decryptIn[2], decryptOut[2];
+    __m128i log, exp, inverse, square, squareLambda;
+    __m128i nibble, fourteen, fifteen, reduction;
+    __m128i shiftRows, shiftRowsInv, rotate1, rotate2;
+};
+
+VPERM_TARGET static inline void loadConstants(VPermConstants &k, const uint8_t encryptIn[2][16], const uint8_t encryptOut[2][16],
+                                              const uint8_t decryptIn[2][16], const uint8_t decryptOut[2][16], const uint8_t log[16],
+                                              const uint8_t exp[16], const uint8_t inverse[16], const uint8_t square[16], const uint8_t squareLambda[16]) {
+    for (int i = 0; i < 2; i++) {
+        k.encryptIn[i] = _mm_load_si128((const __m128i*) encryptIn[i]);
+        k.encryptOut[i] = _mm_load_si128((const __m128i*) encryptOut[i]);
+        k.decryptIn[i] = _mm_load_si128((const __m128i*) decryptIn[i]);
+        k.decryptOut[i] = _mm_load_si128((const __m128i*) decryptOut[i]);
+    }
+    k.log = _mm_load_si128((const __m128i*) log);
+    k.exp = _mm_load_si128((const __m128i*) exp);
+    k.inverse = _mm_load_si128((const __m128i*) inverse);
+    k.square = _mm_load_si128((const __m128i*) square);
+    k.squareLambda = _mm_load_si128((const __m128i*) squareLambda);
+
+    k.nibble = _mm_set1_epi8(0x0f);
+    k.fourteen = _mm_set1_epi8(14);
+    k.fifteen = _mm_set1_epi8(15);
+    k.reduction = _mm_set1_epi8(0x1b);
+
+    // state bytes are in column-major order, byte 4c + r is row r of column c
+    k.shiftRows = _mm_setr_epi8(0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11);
+    k.shiftRowsInv = _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3);
+    k.rotate1 = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    k.rotate2 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+}
+
+/**
+ * multiplies two vectors of GF(2^4) elements given as logarithms
+ * sums of 15 or more are reduced by 15, sums involving LOG[0] stay negative and come out of EXP as 0
+ */
+VPERM_TARGET static inline __m128i multiplyLogs(__m128i la, __m128i lb, const VPermConstants &k) {
+    __m128i sum = _mm_add_epi8(la, lb);
+    sum = _mm_sub_epi8(sum, _mm_and_si128(_mm_cmpgt_epi8(sum, k.fourteen), k.fifteen));
+    return _mm_shuffle_epi8(k.exp, sum);
+}
+
+/**
+ * inverts 16 bytes in GF(2^8) through the tower field, wrapped in the given input and output maps
+ * (aY + b)^-1 = a * d^-1 Y + (a + b) * d^-1 where d = lambda * a^2 + a * b + b^2
+ *
+ * @param x the bytes to transform
+ * @param in the nibble tables mapping a byte into the tower field
+ * @param out the nibble tables mapping a tower element back to a byte
+ */
+VPERM_TARGET static inline __m128i invert(__m128i x, const __m128i in[2], const __m128i out[2], const VPermConstants &k) {
+    __m128i t = _mm_xor_si128(_mm_shuffle_epi8(in[0], _mm_and_si128(x, k.nibble)), _mm_shuffle_epi8(in[1], _mm_and_si128(_mm_srli_epi16(x, 4), k.nibble)));
+    __m128i a = _mm_and_si128(_mm_srli_epi16(t, 4), k.nibble), b = _mm_and_si128(t, k.nibble);
+
+    __m128i la = _mm_shuffle_epi8(k.log, a);
+    __m128i d = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(k.squareLambda, a), _mm_shuffle_epi8(k.square, b)), multiplyLogs(la, _mm_shuffle_epi8(k.log, b), k));
+    __m128i ld = _mm_shuffle_epi8(k.log, _mm_shuffle_epi8(k.inverse, d));
+
+    __m128i a2 = multiplyLogs(la, ld, k);
+    __m128i b2 = multiplyLogs(_mm_shuffle_epi8(k.log, _mm_xor_si128(a, b)), ld, k);
+
+    return _mm_xor_si128(_mm_shuffle_epi8(out[0], b2), _mm_shuffle_epi8(out[1], a2));
+}
+
+/**
+ * multiplies every byte by 0x02 in GF(2^8) without branching on its top bit
+ */
+VPERM_TARGET static inline __m128i xtime(__m128i x, const VPermConstants &k) {
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(_mm_cmpgt_epi8(_mm_setzero_si128(), x), k.reduction));
+}
+
+/**
+ * each column byte becomes 2(a[r] ^ a[r+1]) ^ a[r+1] ^ a[r+2] ^ a[r+3]
+ */
+VPERM_TARGET static inline __m128i mixColumns(__m128i x, const VPermConstants &k) {
+    __m128i r1 = _mm_shuffle_epi8(x, k.rotate1);
+    __m128i t = _mm_xor_si128(x, r1);
+    return _mm_xor_si128(_mm_xor_si128(xtime(t, k), r1), _mm_shuffle_epi8(t, k.rotate2));
+}
+
+/**
+ * InvMixColumns factors into MixColumns after a[r] ^= 4(a[r] ^ a[r+2])
+ */
+VPERM_TARGET static inline __m128i mixColumnsInv(__m128i x, const VPermConstants &k) {
+    __m128i t = _mm_xor_si128(x, _mm_shuffle_epi8(x, k.rotate2));
+    return mixColumns(_mm_xor_si128(x, xtime(xtime(t, k), k)), k);
+}
+
+VPERM_TARGET static inline __m128i encrypt(__m128i x, const uint8_t ekey[], int nRounds, const VPermConstants &k) {
+    const __m128i *rk = (const __m128i*) ekey;
+
+    // round 0
+    x = _mm_xor_si128(x, _mm_load_si128(rk));
+
+    // rounds [1-9] / [1-11] / [1-13]
+    for (int round = 1; round < nRounds; round++) {
+        x = _mm_shuffle_epi8(invert(x, k.encryptIn, k.encryptOut, k), k.shiftRows);
+        x = _mm_xor_si128(mixColumns(x, k), _mm_load_si128(rk + round));
+    }
+
+    // round 10 / 12 / 14
+    x = _mm_shuffle_epi8(invert(x, k.encryptIn, k.encryptOut, k), k.shiftRows);
+    return _mm_xor_si128(x, _mm_load_si128(rk + nRounds));
+}
+
+VPERM_TARGET static inline __m128i decrypt(__m128i x, const uint8_t ekey[], int nRounds, const VPermConstants &k) {
+    const __m128i *rk = (const __m128i*) ekey;
+
+    // round 10 / 12 / 14
+    x = _mm_xor_si128(x, _mm_load_si128(rk + nRounds));
+
+    // rounds [9-1] / [11-1] / [13-1]
+    for (int round = nRounds - 1; round > 0; round--) {
+        x = invert(_mm_shuffle_epi8(x, k.shiftRowsInv), k.decryptIn, k.decryptOut, k);
+        x = mixColumnsInv(_mm_xor_si128(x, _mm_load_si128(rk + round)), k);
+    }
+
+    // round 0
+    x = invert(_mm_shuffle_epi8(x, k.shiftRowsInv), k.decryptIn, k.decryptOut, k);
+    return _mm_xor_si128(x, _mm_load_si128(rk));
+}
+
+#define LOAD_CONSTANTS(k) loadConstants(k, TABLES.encryptIn, TABLES.encryptOut, TABLES.decryptIn, TABLES.decryptOut, \
+                                        TABLES.log, TABLES.exp, TABLES.inverse, TABLES.square, TABLES.squareLambda)
+
+/**
+ * AES_VPerm primary constructor
+ *
+ * @param key bytearray of size 16, 24, or 32 depending on the chosen keySize
+ * @param keySize enum with three possible values: AES128 = 16, AES192 = 24, or AES256 = 32
+ *
+ * @throws std::invalid_argument if the CPU does not support the SSSE3 instructions
+ */
+AES_VPerm::AES_VPerm(const uint8_t key[], AES::KEY_SIZE keySize) : BlockCipher(16), keySize(keySize), nRounds(keySize / 4 + 6) {
+    if (!CPUFeatures::hasSSSE3())
+        throw std::invalid_argument("SSSE3 is not supported by this CPU");
+
+    setKey(key);
+}
+
+/**
+ * AES_VPerm copy constructor
+ *
+ * @param that reference to a preexisting AES_VPerm object that should be copied
+ */
+AES_VPerm::AES_VPerm(const AES_VPerm &that) : AES_VPerm(that.key, that.keySize) {
+
+}
+
+/**
+ * AES_VPerm destructor
+ */
+AES_VPerm::~AES_VPerm() {
+    wipe(key, sizeof(key));
+    wipe(ekey, sizeof(ekey));
+}
+
+/**
+ * replaces the key and expands it again in place, so modes and kernels that refer to this object keep working
+ *
+ * @param key bytearray of the key size given at construction
+ */
+void AES_VPerm::setKey(const uint8_t key[]) {
+    for (int i = 0; i < keySize; i++)
+        this->key[i] = key[i];
+
+    generateExpandedKey();
+}
+
+/**
+ * encrypts a block of plaintext and returns the resulting ciphertext
+ *
+ * @param plaintext a 16 byte array of data for encrypting
+ * @param ciphertext a 16 byte array for returning the resulting encrypted ciphertext
+ */
+VPERM_TARGET void AES_VPerm::encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const {
+    VPermConstants k;
+    LOAD_CONSTANTS(k);
+
+    _mm_storeu_si128((__m128i*) ciphertext, encrypt(_mm_loadu_si128((const __m128i*) plaintext), ekey, nRounds, k));
+}
+
+/**
+ * decrypts a block of ciphertext and returns the resulting plaintext
+ *
+ * @param ciphertext a 16 byte array of data for decrypting
+ * @param plaintext a 16 byte array for returning the resulting decrypted plaintext
+ */
+VPERM_TARGET void AES_VPerm::decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const {
+    VPermConstants k;
+    LOAD_CONSTANTS(k);
+
+    _mm_storeu_si128((__m128i*) plaintext, decrypt(_mm_loadu_si128((const __m128i*) ciphertext), ekey, nRounds, k));
+}
+
+/**
+ * encrypts a run of consecutive blocks, loading the tables into registers only once
+ *
+ * @param plaintext nblocks * 16 bytes of data for encrypting
+ * @param ciphertext nblocks * 16 bytes for returning the resulting encrypted ciphertext
+ * @param nblocks the number of blocks to encrypt
+ */
+VPERM_TARGET void AES_VPerm::encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    VPermConstants k;
+    LOAD_CONSTANTS(k);
+
+    for (size_t i = 0; i < nblocks; i++)
+        _mm_storeu_si128((__m128i*) ciphertext + i, encrypt(_mm_loadu_si128((const __m128i*) plaintext + i), ekey, nRounds, k));
+}
+
+/**
+ * decrypts a run of consecutive blocks, loading the tables into registers only once
+ *
+ * @param ciphertext nblocks * 16 bytes of data for decrypting
+ * @param plaintext nblocks * 16 bytes for returning the resulting decrypted plaintext
+ * @param nblocks the number of blocks to decrypt
+ */
+VPERM_TARGET void AES_VPerm::decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    VPermConstants k;
+    LOAD_CONSTANTS(k);
+
+    for (size_t i = 0; i < nblocks; i++)
+        _mm_storeu_si128((__m128i*) plaintext + i, decrypt(_mm_loadu_si128((const __m128i*) ciphertext + i), ekey, nRounds, k));
+}
+
+/**
+ * uses the user-provided key [AES_VPerm::key] to generate the expanded key [AES_VPerm::ekey]
+ * SubWord goes through the same vector SBOX so that the key schedule does not index memory with key bytes either
+ *
+ * algorithm is described in FIPS-197 section 5.2
+ */
+VPERM_TARGET void AES_VPerm::generateExpandedKey() {
+    const int nk = keySize / 4, nWords = 4 * (nRounds + 1);
+    uint32_t words[60], rcon = 0x01;
+    VPermConstants k;
+    LOAD_CONSTANTS(k);
+
+    auto subWord = [&k](uint32_t word) VPERM_TARGET {
+        return (uint32_t) _mm_cvtsi128_si32(invert(_mm_cvtsi32_si128(word), k.encryptIn, k.encryptOut, k));
+    };
+
+    for (int i = 0; i < nk; i++)
+        words[i] = uint32_t(key[4 * i]) | (uint32_t(key[4 * i + 1]) << 8) | (uint32_t(key[4 * i + 2]) << 16) | (uint32_t(key[4 * i + 3]) << 24);
+
+    for (int i = nk; i < nWords; i++) {
+        uint32_t temp = words[i - 1];
+
+        if (i % nk == 0) {
+            // SubWord, RotWord (a right rotation since byte 0 is the least significant) and XOR with the round constant
+            temp = subWord(temp);
+            temp = ((temp >> 8) | (temp << 24)) ^ rcon;
+            rcon = (rcon << 1) ^ ((rcon & 0x80) ? 0x11b : 0x00);
+        } else if (nk > 6 && i % nk == 4) {
+            temp = subWord(temp);
+        }
+
+        words[i] = words[i - nk] ^ temp;
+    }
+
+    for (int i = 0; i < nWords; i++)
+        for (int j = 0; j < 4; j++)
+            ekey[4 * i + j] = words[i] >> (8 * j);
+}
+
+#else
+
+/**
+ * AES_VPerm primary constructor for processors without SSSE3
+ *
+ * @throws std::invalid_argument always since this backend is written with x86 SSSE3 registers
+ */
+AES_VPerm::AES_VPerm(const uint8_t[], AES::KEY_SIZE keySize) : BlockCipher(16), keySize(keySize), nRounds(keySize / 4 + 6) {
+    throw std::invalid_argument("the vector-permute backend is not supported by this CPU");
+}
+
+AES_VPerm::AES_VPerm(const AES_VPerm &that) : AES_VPerm(that.key, that.keySize) {
+
+}
+
+AES_VPerm::~AES_VPerm() {
+
+}
+
+void AES_VPerm::setKey(const uint8_t[]) {
+
+}
+
+void AES_VPerm::encryptBlock(const uint8_t[], uint8_t[]) const {
+
+}
+
+void AES_VPerm::decryptBlock(const uint8_t[], uint8_t[]) const {
+
+}
+
+void AES_VPerm::encryptBlocks(const uint8_t *, uint8_t *, size_t) const {
+
+}
+
+void AES_VPerm::decryptBlocks(const uint8_t *, uint8_t *, size_t) const {
+
+}
+
+#endif
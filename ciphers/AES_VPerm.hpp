@@ -0,0 +1,41 @@
+/**
+ * header file for the vector-permute (SSSE3), constant-time AES 128, 192, and 256 block cipher backend.
+ * @file AES_VPerm.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYAES_VPERM
+#define MYAES_VPERM
+
+#include <cstdint>
+#include <stdexcept>
+#include "BlockCipher.hpp"
+#include "AES.hpp"
+
+class AES_VPerm : public BlockCipher {
+private:
+    AES_VPerm();
+    AES_VPerm& operator=(const AES_VPerm &that) = delete;
+
+public:
+    AES_VPerm(const uint8_t key[], AES::KEY_SIZE keySize = AES::AES128);
+    AES_VPerm(const AES_VPerm &that);
+    ~AES_VPerm();
+    void setKey(const uint8_t key[]);
+
+    void encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const;
+    void decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const;
+    void encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+
+private:
+    uint8_t key[32];
+    AES::KEY_SIZE keySize;
+    int nRounds;
+    alignas(16) uint8_t ekey[240];
+
+    void generateExpandedKey();
+};
+
+#endif
@@ -26,9 +26,51 @@ BlockCipher::~BlockCipher() {
     
 }
 
+/**
+ * encrypts a run of consecutive, independent blocks
+ * subclasses should override this to amortize per-call overhead or to overlap the work on several blocks
+ * plaintext and ciphertext may point to the same buffer
+ *
+ * @param plaintext nblocks * [BlockCipher::blockSize] bytes of data for encrypting
+ * @param ciphertext nblocks * [BlockCipher::blockSize] bytes for returning the resulting encrypted ciphertext
+ * @param nblocks the number of blocks to encrypt
+ */
+void BlockCipher::encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    for (size_t i = 0; i < nblocks; i++)
+        encryptBlock(plaintext + i * blockSize, ciphertext + i * blockSize);
+}
+
+/**
+ * decrypts a run of consecutive, independent blocks
+ * subclasses should override this to amortize per-call overhead or to overlap the work on several blocks
+ * ciphertext and plaintext may point to the same buffer
+ *
+ * @param ciphertext nblocks * [BlockCipher::blockSize] bytes of data for decrypting
+ * @param plaintext nblocks * [BlockCipher::blockSize] bytes for returning the resulting decrypted plaintext
+ * @param nblocks the number of blocks to decrypt
+ */
+void BlockCipher::decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    for (size_t i = 0; i < nblocks; i++)
+        decryptBlock(ciphertext + i * blockSize, plaintext + i * blockSize);
+}
+
 /**
  * @return [BlockCipher::blockSize]
  */
 uint8_t BlockCipher::getBlockSize() const {
     return blockSize;
-}
\ No newline at end of file
+}
+
+/**
+ * overwrites key material with zeros, including when the memory is about to be freed,
+ * a plain memset of memory that is never read again may be removed by the compiler
+ *
+ * @param data the bytes to clear
+ * @param size the number of bytes
+ */
+void BlockCipher::wipe(void *data, size_t size) {
+    memset(data, 0, size);
+
+    // tells the compiler the zeros may be read through data, so the memset must happen
+    __asm__ __volatile__("" : : "r"(data) : "memory");
+}
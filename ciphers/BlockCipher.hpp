@@ -10,6 +10,8 @@
 #define MYBLOCKCIPHER
 
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #include <stdexcept>
 
 class BlockCipher {
@@ -26,7 +28,11 @@ public:
     virtual ~BlockCipher();
     virtual void encryptBlock(const uint8_t plaintext[], uint8_t ciphertext[]) const = 0;
     virtual void decryptBlock(const uint8_t ciphertext[], uint8_t plaintext[]) const = 0;
+    virtual void encryptBlocks(const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    virtual void decryptBlocks(const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
     uint8_t getBlockSize() const;
+
+    static void wipe(void *data, size_t size);
 };
 
 #endif
\ No newline at end of file
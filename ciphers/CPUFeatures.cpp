@@ -0,0 +1,129 @@
+/**
+ * class implementation for the runtime CPU feature detection used to pick hardware accelerated backends.
+ * @file CPUFeatures.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "CPUFeatures.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+
+/**
+ * reads the feature flags reported by CPUID leaf 1
+ * bit descriptions found at: https://en.wikipedia.org/wiki/CPUID#EAX=1:_Processor_Info_and_Feature_Bits
+ *
+ * @return the ECX feature register of leaf 1, or 0 if the leaf is not supported
+ */
+static unsigned int leaf1ECX() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+    return ecx;
+}
+
+/**
+ * @return the EDX feature register of leaf 1, or 0 if the leaf is not supported
+ */
+static unsigned int leaf1EDX() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+    return edx;
+}
+
+/**
+ * @return true if the CPU implements the AES-NI instructions (CPUID.1:ECX bit 25)
+ */
+bool CPUFeatures::hasAESNI() {
+    static const bool supported = (leaf1ECX() >> 25) & 1;
+    return supported;
+}
+
+/**
+ * @return true if the CPU implements the SSE2 instructions (CPUID.1:EDX bit 26)
+ */
+bool CPUFeatures::hasSSE2() {
+    static const bool supported = (leaf1EDX() >> 26) & 1;
+    return supported;
+}
+
+/**
+ * @return true if the CPU implements the SSSE3 instructions (CPUID.1:ECX bit 9)
+ */
+bool CPUFeatures::hasSSSE3() {
+    static const bool supported = (leaf1ECX() >> 9) & 1;
+    return supported;
+}
+
+/**
+ * @return true if the CPU implements the carry-less multiplication instruction (CPUID.1:ECX bit 1)
+ */
+bool CPUFeatures::hasPCLMULQDQ() {
+    static const bool supported = (leaf1ECX() >> 1) & 1;
+    return supported;
+}
+
+/**
+ * AVX2 needs both the instructions (CPUID.7.0:EBX bit 5) and an operating system that saves the YMM registers,
+ * which it reports through OSXSAVE (CPUID.1:ECX bit 27) and the SSE and AVX state bits of XCR0
+ *
+ * @return true if the CPU implements the AVX2 instructions and they are enabled
+ */
+static bool detectAVX2() {
+    unsigned int eax, ebx, ecx, edx, xcr0;
+
+    if (!((leaf1ECX() >> 27) & 1) || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    __asm__("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+    return (xcr0 & 6) == 6 && ((ebx >> 5) & 1);
+}
+
+/**
+ * @return true if the CPU implements the AVX2 instructions and the operating system has enabled them
+ */
+bool CPUFeatures::hasAVX2() {
+    static const bool supported = detectAVX2();
+    return supported;
+}
+
+#else
+
+/**
+ * @return false since AES-NI only exists on x86 processors
+ */
+bool CPUFeatures::hasAESNI() {
+    return false;
+}
+
+/**
+ * @return false since SSE2 only exists on x86 processors
+ */
+bool CPUFeatures::hasSSE2() {
+    return false;
+}
+
+/**
+ * @return false since SSSE3 only exists on x86 processors
+ */
+bool CPUFeatures::hasSSSE3() {
+    return false;
+}
+
+/**
+ * @return false since PCLMULQDQ only exists on x86 processors
+ */
+bool CPUFeatures::hasPCLMULQDQ() {
+    return false;
+}
+
+/**
+ * @return false since AVX2 only exists on x86 processors
+ */
+bool CPUFeatures::hasAVX2() {
+    return false;
+}
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * header file for the runtime CPU feature detection used to pick hardware accelerated backends.
+ * @file CPUFeatures.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYCPUFEATURES
+#define MYCPUFEATURES
+
+class CPUFeatures {
+private:
+    CPUFeatures() = delete;
+
+public:
+    static bool hasAESNI();
+    static bool hasSSE2();
+    static bool hasSSSE3();
+    static bool hasPCLMULQDQ();
+    static bool hasAVX2();
+};
+
+#endif
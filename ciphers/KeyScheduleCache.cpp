@@ -0,0 +1,218 @@
+/**
+ * class implementation for the thread-safe cache of expanded AES key schedules.
+ * @file KeyScheduleCache.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "KeyScheduleCache.hpp"
+
+/**
+ * KeyScheduleCache primary constructor
+ *
+ * @param capacity the most keys kept expanded at once
+ * @param backend the AES implementation every cached key is expanded for
+ *
+ * @throws std::invalid_argument if capacity is 0
+ */
+KeyScheduleCache::KeyScheduleCache(size_t capacity, AES::BACKEND backend) : capacity(capacity), backend(backend), hits(0), misses(0), evictions(0) {
+    if (capacity == 0)
+        throw std::invalid_argument("capacity must be at least 1 key");
+}
+
+/**
+ * KeyScheduleCache destructor, wipes every cached key
+ * AES objects still held by callers stay valid and are wiped when the last of them is released
+ */
+KeyScheduleCache::~KeyScheduleCache() {
+    clear();
+}
+
+/**
+ * looks up the expanded schedule for a key, expanding it on a miss and evicting the least recently used key when full
+ * the returned AES may be used on any number of threads and stays valid after it is evicted, until it is released
+ *
+ * @param keyId the name the key is cached under
+ * @param key bytearray of size keySize, compared with the cached key so a key ID that now names another key is a miss
+ * @param keySize enum with three possible values: AES128 = 16, AES192 = 24, or AES256 = 32
+ *
+ * @return the AES for key, shared with every other caller that gets the same key ID
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for a new AES or cache entry
+ * @throws std::invalid_argument if the cache's backend is not supported by this CPU
+ */
+std::shared_ptr<const AES> KeyScheduleCache::get(const std::string &keyId, const uint8_t key[], AES::KEY_SIZE keySize) {
+    std::unordered_map<std::string, std::list<Entry>::iterator>::iterator found;
+    std::shared_ptr<AES> aes, recycled;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        found = index.find(keyId);
+        if (found != index.end() && isSameKey(*found->second, key, keySize)) {
+            entries.splice(entries.begin(), entries, found->second);
+            hits++;
+            return found->second->aes;
+        }
+
+        // a stale entry for this key ID, or else the least recently used entry when the cache is full, makes room
+        misses++;
+        if (found != index.end()) {
+            recycled = remove(found->second);
+        } else if (entries.size() >= capacity) {
+            recycled = remove(std::prev(entries.end()));
+            evictions++;
+        }
+    }
+
+    // the key is expanded without holding the lock, and only the cache could hand out copies of recycled,
+    // so when this is its last reference it is rekeyed in place instead of freeing one AES and allocating another
+    try {
+        if (recycled && recycled.use_count() == 1 && recycled->getKeySize() == keySize) {
+            recycled->setKey(key);
+            aes = recycled;
+        } else {
+            recycled.reset();
+            aes = std::make_shared<AES>(key, keySize, backend);
+        }
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // another thread may have missed on the same key ID meanwhile, its AES is kept and this one is dropped
+    found = index.find(keyId);
+    if (found != index.end()) {
+        if (isSameKey(*found->second, key, keySize)) {
+            entries.splice(entries.begin(), entries, found->second);
+            return found->second->aes;
+        }
+        remove(found->second);
+    } else if (entries.size() >= capacity) {
+        remove(std::prev(entries.end()));
+        evictions++;
+    }
+
+    entries.push_front(Entry());
+    try {
+        index[keyId] = entries.begin();
+    } catch (std::bad_alloc &e) {
+        entries.pop_front();
+        throw;
+    }
+
+    entries.front().keyId = keyId;
+    entries.front().keySize = keySize;
+    entries.front().aes = aes;
+    for (int i = 0; i < keySize; i++)
+        entries.front().key[i] = key[i];
+
+    return aes;
+}
+
+/**
+ * drops a key from the cache, for instance after it has been rotated or revoked
+ *
+ * @param keyId the name the key is cached under
+ *
+ * @return true if the key was cached
+ */
+bool KeyScheduleCache::erase(const std::string &keyId) {
+    // declared before the lock so a last reference is released, and the schedule wiped, after unlocking
+    std::shared_ptr<AES> aes;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, std::list<Entry>::iterator>::iterator found = index.find(keyId);
+
+    if (found == index.end())
+        return false;
+
+    aes = remove(found->second);
+    return true;
+}
+
+/**
+ * drops every key from the cache, the hit, miss, and eviction counts are kept
+ */
+void KeyScheduleCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    while (!entries.empty())
+        remove(entries.begin());
+}
+
+/**
+ * @return the number of keys currently cached
+ */
+size_t KeyScheduleCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+/**
+ * @return [KeyScheduleCache::capacity], the most keys kept expanded at once
+ */
+size_t KeyScheduleCache::getCapacity() const {
+    return capacity;
+}
+
+/**
+ * @return the number of get() calls that found the key already expanded
+ */
+uint64_t KeyScheduleCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+/**
+ * @return the number of get() calls that had to expand the key
+ */
+uint64_t KeyScheduleCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+/**
+ * @return the number of keys pushed out because the cache was full
+ */
+uint64_t KeyScheduleCache::getEvictions() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return evictions;
+}
+
+/**
+ * takes an entry out of the cache and wipes its copy of the key, the caller must hold [KeyScheduleCache::mutex]
+ *
+ * @param entry the entry to remove
+ *
+ * @return the entry's AES, which wipes its schedule when the last reference to it is released
+ */
+std::shared_ptr<AES> KeyScheduleCache::remove(std::list<Entry>::iterator entry) {
+    std::shared_ptr<AES> aes = entry->aes;
+
+    BlockCipher::wipe(entry->key, sizeof(entry->key));
+    index.erase(entry->keyId);
+    entries.erase(entry);
+
+    return aes;
+}
+
+/**
+ * compares a cached key with a requested one without stopping at the first differing byte
+ *
+ * @param entry the cached entry
+ * @param key bytearray of size keySize
+ * @param keySize the size of key
+ *
+ * @return true if the entry holds the same key
+ */
+bool KeyScheduleCache::isSameKey(const Entry &entry, const uint8_t key[], AES::KEY_SIZE keySize) {
+    uint8_t difference = 0;
+
+    if (entry.keySize != keySize)
+        return false;
+
+    for (int i = 0; i < keySize; i++)
+        difference |= entry.key[i] ^ key[i];
+
+    return difference == 0;
+}
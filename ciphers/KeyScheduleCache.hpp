@@ -0,0 +1,71 @@
+/**
+ * header file for the thread-safe cache of expanded AES key schedules.
+ * @file KeyScheduleCache.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYKEYSCHEDULECACHE
+#define MYKEYSCHEDULECACHE
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include "AES.hpp"
+
+// keeps the most recently used keys expanded, as AES objects looked up by a key ID, so a server handling many keys
+// expands each one only when it is first seen or after it has been evicted
+// an evicted AES is rekeyed in place for the next miss when nothing else holds it, and wiped when it is freed otherwise
+class KeyScheduleCache {
+private:
+    KeyScheduleCache();
+    KeyScheduleCache(const KeyScheduleCache &that) = delete;
+    KeyScheduleCache& operator=(const KeyScheduleCache &that) = delete;
+
+public:
+    // default number of keys kept expanded
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    KeyScheduleCache(size_t capacity = DEFAULT_CAPACITY, AES::BACKEND backend = AES::AUTO);
+    ~KeyScheduleCache();
+
+    std::shared_ptr<const AES> get(const std::string &keyId, const uint8_t key[], AES::KEY_SIZE keySize = AES::AES128);
+    bool erase(const std::string &keyId);
+    void clear();
+    size_t getSize() const;
+    size_t getCapacity() const;
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+    uint64_t getEvictions() const;
+
+private:
+    // the key is kept alongside its schedule so a key ID that now names a different key is treated as a miss
+    struct Entry {
+        std::string keyId;
+        uint8_t key[32];
+        AES::KEY_SIZE keySize;
+        std::shared_ptr<AES> aes;
+    };
+
+    const size_t capacity;
+    const AES::BACKEND backend;
+
+    // guards every member below, the entries are kept from most to least recently used
+    mutable std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+
+    std::shared_ptr<AES> remove(std::list<Entry>::iterator entry);
+    static bool isSameKey(const Entry &entry, const uint8_t key[], AES::KEY_SIZE keySize);
+};
+
+#endif
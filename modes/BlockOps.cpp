@@ -0,0 +1,272 @@
+/**
+ * class implementation for the vectorized byte operations shared by the modes of operation.
+ * @file BlockOps.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "BlockOps.hpp"
+#include "../ciphers/CPUFeatures.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+typedef void (*XorFunction)(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n);
+
+// shorter runs (a block or two of a stream) go straight to the word loop instead of through a function pointer
+static constexpr size_t VECTOR_THRESHOLD = 64;
+
+/**
+ * reads 8 big-endian bytes as an integer
+ *
+ * @param bytes 8 bytes, most significant first
+ *
+ * @return the integer value
+ */
+static inline uint64_t loadBigEndian(const uint8_t bytes[]) {
+    uint64_t value;
+
+    memcpy(&value, bytes, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+
+    return value;
+}
+
+/**
+ * writes an integer as 8 big-endian bytes
+ *
+ * @param bytes room for 8 bytes
+ * @param value the integer to write
+ */
+static inline void storeBigEndian(uint8_t bytes[], uint64_t value) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    memcpy(bytes, &value, 8);
+}
+
+/**
+ * computes dst = a XOR b two 64 bit words at a time, then byte by byte for the last 1 to 15 bytes
+ *
+ * @param dst the n byte result
+ * @param a the first n byte operand
+ * @param b the second n byte operand
+ * @param n the number of bytes to XOR
+ */
+static void xorPortable(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n) {
+    size_t i = 0;
+
+    // memcpy keeps the unaligned word accesses well-defined and compiles to plain loads and stores
+    for (; i + 16 <= n; i += 16) {
+        uint64_t x[2], y[2];
+        memcpy(x, a + i, 16);
+        memcpy(y, b + i, 16);
+        x[0] ^= y[0];
+        x[1] ^= y[1];
+        memcpy(dst + i, x, 16);
+    }
+
+    for (; i < n; i++)
+        dst[i] = a[i] ^ b[i];
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// the vector versions are compiled for their own instruction sets only so the rest of the library stays portable
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+/**
+ * computes dst = a XOR b 64 bytes at a time in four SSE2 registers
+ *
+ * @param dst the n byte result
+ * @param a the first n byte operand
+ * @param b the second n byte operand
+ * @param n the number of bytes to XOR
+ */
+SSE2_TARGET static void xorSSE2(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64) {
+        __m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i)));
+        __m128i x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (a + i + 16)), _mm_loadu_si128((const __m128i*) (b + i + 16)));
+        __m128i x2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (a + i + 32)), _mm_loadu_si128((const __m128i*) (b + i + 32)));
+        __m128i x3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (a + i + 48)), _mm_loadu_si128((const __m128i*) (b + i + 48)));
+        _mm_storeu_si128((__m128i*) (dst + i), x0);
+        _mm_storeu_si128((__m128i*) (dst + i + 16), x1);
+        _mm_storeu_si128((__m128i*) (dst + i + 32), x2);
+        _mm_storeu_si128((__m128i*) (dst + i + 48), x3);
+    }
+
+    for (; i + 16 <= n; i += 16)
+        _mm_storeu_si128((__m128i*) (dst + i), _mm_xor_si128(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+
+    xorPortable(dst + i, a + i, b + i, n - i);
+}
+
+/**
+ * computes dst = a XOR b 128 bytes at a time in four AVX2 registers
+ *
+ * @param dst the n byte result
+ * @param a the first n byte operand
+ * @param b the second n byte operand
+ * @param n the number of bytes to XOR
+ */
+AVX2_TARGET static void xorAVX2(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 128 <= n; i += 128) {
+        __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (a + i)), _mm256_loadu_si256((const __m256i*) (b + i)));
+        __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (a + i + 32)), _mm256_loadu_si256((const __m256i*) (b + i + 32)));
+        __m256i x2 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (a + i + 64)), _mm256_loadu_si256((const __m256i*) (b + i + 64)));
+        __m256i x3 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (a + i + 96)), _mm256_loadu_si256((const __m256i*) (b + i + 96)));
+        _mm256_storeu_si256((__m256i*) (dst + i), x0);
+        _mm256_storeu_si256((__m256i*) (dst + i + 32), x1);
+        _mm256_storeu_si256((__m256i*) (dst + i + 64), x2);
+        _mm256_storeu_si256((__m256i*) (dst + i + 96), x3);
+    }
+
+    for (; i + 32 <= n; i += 32)
+        _mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (a + i)), _mm256_loadu_si256((const __m256i*) (b + i))));
+
+    xorPortable(dst + i, a + i, b + i, n - i);
+}
+
+#elif defined(__ARM_NEON)
+
+/**
+ * computes dst = a XOR b 64 bytes at a time in four NEON registers
+ *
+ * @param dst the n byte result
+ * @param a the first n byte operand
+ * @param b the second n byte operand
+ * @param n the number of bytes to XOR
+ */
+static void xorNEON(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64) {
+        uint8x16_t x0 = veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        uint8x16_t x1 = veorq_u8(vld1q_u8(a + i + 16), vld1q_u8(b + i + 16));
+        uint8x16_t x2 = veorq_u8(vld1q_u8(a + i + 32), vld1q_u8(b + i + 32));
+        uint8x16_t x3 = veorq_u8(vld1q_u8(a + i + 48), vld1q_u8(b + i + 48));
+        vst1q_u8(dst + i, x0);
+        vst1q_u8(dst + i + 16, x1);
+        vst1q_u8(dst + i + 32, x2);
+        vst1q_u8(dst + i + 48, x3);
+    }
+
+    for (; i + 16 <= n; i += 16)
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+
+    xorPortable(dst + i, a + i, b + i, n - i);
+}
+
+#endif
+
+/**
+ * @return the version of xorBytes() for getImplementation()
+ */
+static XorFunction selectXor() {
+    switch (BlockOps::getImplementation()) {
+#if defined(__x86_64__) || defined(__i386__)
+        case BlockOps::AVX2: return xorAVX2;
+        case BlockOps::SSE2: return xorSSE2;
+#elif defined(__ARM_NEON)
+        case BlockOps::NEON: return xorNEON;
+#endif
+        default: return xorPortable;
+    }
+}
+
+/**
+ * @return the widest vector instructions this CPU supports, which every XOR uses
+ */
+BlockOps::IMPLEMENTATION BlockOps::getImplementation() {
+#if defined(__x86_64__) || defined(__i386__)
+    if (CPUFeatures::hasAVX2())
+        return AVX2;
+    if (CPUFeatures::hasSSE2())
+        return SSE2;
+    return PORTABLE;
+#elif defined(__ARM_NEON)
+    return NEON;
+#else
+    return PORTABLE;
+#endif
+}
+
+/**
+ * computes dst = a XOR b over n bytes, a vector register at a time
+ * dst may be the same buffer as a or b, but must not partially overlap either of them
+ *
+ * @param dst the n byte result
+ * @param a the first n byte operand
+ * @param b the second n byte operand
+ * @param n the number of bytes to XOR
+ */
+void BlockOps::xorBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n) {
+    static const XorFunction function = selectXor();
+
+    if (n < VECTOR_THRESHOLD)
+        xorPortable(dst, a, b, n);
+    else
+        function(dst, a, b, n);
+}
+
+/**
+ * computes dst = a XOR b over n bytes and also stores the result in copy,
+ * for modes whose output becomes the next chaining value
+ * its only caller, serial CFB encryption, passes a single block, so there is no vector version:
+ * it is two 64 bit words at a time, then byte by byte for the last 1 to 15 bytes
+ * dst and copy may each be the same buffer as a or b, but no two buffers may partially overlap
+ *
+ * @param dst the n byte result
+ * @param copy a second n byte result
+ * @param a the first n byte operand
+ * @param b the second n byte operand
+ * @param n the number of bytes to XOR
+ */
+void BlockOps::xorCopy(uint8_t *dst, uint8_t *copy, const uint8_t *a, const uint8_t *b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        uint64_t x[2], y[2];
+        memcpy(x, a + i, 16);
+        memcpy(y, b + i, 16);
+        x[0] ^= y[0];
+        x[1] ^= y[1];
+        memcpy(dst + i, x, 16);
+        memcpy(copy + i, x, 16);
+    }
+
+    for (; i < n; i++)
+        dst[i] = copy[i] = a[i] ^ b[i];
+}
+
+/**
+ * lays out nblocks consecutive 128 bit big-endian counter blocks, each one the block before it plus 1 modulo 2^128
+ * the counter is held as two 64 bit halves, so each block is two byte-swapped stores instead of a carry loop over 16 bytes
+ *
+ * @param counter the counter of the first block, advanced past the last block on return
+ * @param blocks room for nblocks 16 byte blocks, must not overlap counter
+ * @param nblocks the number of counter blocks
+ */
+void BlockOps::generateCounters(uint8_t counter[16], uint8_t *blocks, size_t nblocks) {
+    uint64_t hi = loadBigEndian(counter), lo = loadBigEndian(counter + 8);
+
+    for (size_t b = 0; b < nblocks; b++) {
+        storeBigEndian(blocks + 16 * b, hi);
+        storeBigEndian(blocks + 16 * b + 8, lo);
+        if (++lo == 0)
+            hi++;
+    }
+
+    storeBigEndian(counter, hi);
+    storeBigEndian(counter + 8, lo);
+}
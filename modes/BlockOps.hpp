@@ -0,0 +1,36 @@
+/**
+ * header file for the vectorized byte operations shared by the modes of operation.
+ * @file BlockOps.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYBLOCKOPS
+#define MYBLOCKOPS
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// the XOR, XOR-and-copy, and counter loops that every mode runs around its block cipher calls
+// each XOR has an AVX2, SSE2, and NEON version, the best one the CPU supports is picked the first time it is called
+class BlockOps {
+public:
+    enum IMPLEMENTATION : uint8_t {
+        PORTABLE,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+private:
+    BlockOps() = delete;
+
+public:
+    static IMPLEMENTATION getImplementation();
+    static void xorBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n);
+    static void xorCopy(uint8_t *dst, uint8_t *copy, const uint8_t *a, const uint8_t *b, size_t n);
+    static void generateCounters(uint8_t counter[16], uint8_t *blocks, size_t nblocks);
+};
+
+#endif
@@ -43,6 +43,7 @@ CBC::~CBC() {
 
 /**
  * takes data from a plaintext stream, applies padding and encryption, and writes it to a ciphertext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
  *
  * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
  *
@@ -52,135 +53,232 @@ CBC::~CBC() {
  * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
  */
 void CBC::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
-    uint8_t blockSize, *buffer, *prev, nbytes, *padding;
+    processStream(plaintext, ciphertext, ENCRYPT);
+}
 
-    blockSize = blockCipher.getBlockSize();
-    try {
-        buffer = new uint8_t[blockSize];
-        prev = new uint8_t[blockSize];
-    } catch (std::bad_alloc &e) {
-        throw;
+/**
+ * takes data from a ciphertext stream, decrypts and strips padding, and writes it to a plaintext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ *
+ * @throws std::invalid_argument if the ciphertext is not a multiple of the block size or does not end in valid padding
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void CBC::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    processStream(ciphertext, plaintext, DECRYPT);
+}
+
+/**
+ * encrypts a run of whole blocks, XORing each one with the ciphertext block before it
+ *
+ * @param prev the ciphertext block (or iv) before the run, the last ciphertext block on return
+ * @param plaintext nblocks of plaintext
+ * @param ciphertext nblocks for returning the resulting ciphertext, may be the same buffer as plaintext
+ * @param nblocks the number of blocks in the run
+ */
+void CBC::encryptChain(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+
+    if (kernel) {
+        kernel->cbcEncrypt(prev, plaintext, ciphertext, nblocks);
+        return;
     }
 
-    // read first block of plaintext
-    plaintext.read((char*) buffer, blockSize);
-    nbytes = plaintext.gcount();
+    for (size_t b = 0; b < nblocks; b++) {
+        xorBytes(ciphertext + b * blockSize, plaintext + b * blockSize, prev, blockSize);
+        blockCipher.encryptBlock(ciphertext + b * blockSize, ciphertext + b * blockSize);
+        memcpy(prev, ciphertext + b * blockSize, blockSize);
+    }
+}
 
-    // prepare iv
-    for (uint8_t i = 0; i < blockSize; i++)
-        prev[i] = iv[i];
+/**
+ * decrypts a run of whole ciphertext blocks with one call to the block cipher, then XORs each one with the ciphertext block before it
+ * no block depends on the output of another, so separate runs can be decrypted concurrently
+ *
+ * @param ciphertext nblocks of ciphertext
+ * @param plaintext nblocks for returning the resulting plaintext, must not overlap ciphertext
+ * @param prev the ciphertext block (or iv) that precedes the run
+ * @param nblocks the number of blocks in the run
+ */
+void CBC::decryptChunk(const uint8_t *ciphertext, uint8_t *plaintext, const uint8_t prev[], size_t nblocks) const {
+    uint8_t blockSize = blockCipher.getBlockSize(), chain[256];
 
-    while (plaintext.peek() != EOF) {
-        // XOR plaintext with previous round's ciphertext
-        for (uint8_t i = 0; i < blockSize; i++)
-            buffer[i] ^= prev[i];
+    if (kernel) {
+        memcpy(chain, prev, blockSize);
+        kernel->cbcDecrypt(chain, ciphertext, plaintext, nblocks);
+        return;
+    }
 
-        // encrypt plaintext block and write it to the output stream
-        blockCipher.encryptBlock(buffer, buffer);
-        ciphertext.write((char*) buffer, blockSize);
+    blockCipher.decryptBlocks(ciphertext, plaintext, nblocks);
 
-        // save this round's ciphertext
-        for (uint8_t i = 0; i < blockSize; i++)
-            prev[i] = buffer[i];
+    xorBytes(plaintext, plaintext, prev, blockSize);
+    xorBytes(plaintext + blockSize, plaintext + blockSize, ciphertext, (nblocks - 1) * blockSize);
+}
 
-        // read next block of plaintext
-        plaintext.read((char*) buffer, blockSize);
-        nbytes = plaintext.gcount();
-    }
+/**
+ * decrypts a run of blocks anywhere in the ciphertext, the only chaining state it needs is the ciphertext block before it
+ *
+ * @param ciphertext the start of the whole ciphertext
+ * @param firstBlock the index of the first block to decrypt
+ * @param nbytes the number of bytes to decrypt, a multiple of the block size
+ * @param plaintext room for nbytes, must not overlap ciphertext
+ */
+void CBC::decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+
+    decryptChunk(ciphertext + firstBlock * blockSize, plaintext, firstBlock ? ciphertext + (firstBlock - 1) * blockSize : iv, nbytes / blockSize);
+}
+
+/**
+ * pads and encrypts a contiguous buffer of plaintext without going through iostreams
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for getEncryptedSize(size) bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to getEncryptedSize(size)
+ */
+size_t CBC::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize, last[512], prev[256];
+    size_t nblocks, padded;
+
+    blockSize = blockCipher.getBlockSize();
+    memcpy(prev, iv, blockSize);
+
+    // XOR every block before the final one with the previous round's ciphertext and encrypt it
+    nblocks = size ? (size - 1) / blockSize : 0;
+    encryptChain(prev, plaintext, ciphertext, nblocks);
 
     // the last bytes of plaintext may not be enough to fill a full block so we should add padding
     // depending on the padding scheme, an additional full block of padding may be needed
+    // an empty message has no last bytes to copy and may come with a null plaintext
+    if (size)
+        memcpy(last, plaintext + nblocks * blockSize, size - nblocks * blockSize);
+    padded = blockPadding.addPadding(last, size - nblocks * blockSize);
+    encryptChain(prev, last, ciphertext + nblocks * blockSize, padded / blockSize);
+
+    return nblocks * blockSize + padded;
+}
+
+/**
+ * decrypts and strips padding from a contiguous buffer of ciphertext without going through iostreams
+ * separate buffers, or any buffers when there is a kernel for the cipher, are decrypted in a single run,
+ * in-place buffers otherwise go through a chunk of scratch space since every block is XORed with the ciphertext block before it
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes, a multiple of the block size
+ * @param plaintext room for size bytes, either the same buffer as ciphertext or not overlapping it
+ *
+ * @return the number of plaintext bytes written after stripping padding
+ *
+ * @throws std::invalid_argument if size is not a multiple of the block size or the ciphertext does not end in valid padding
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the in-place scratch space
+ */
+size_t CBC::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t blockSize, *output, prev[256];
+    size_t nblocks, n;
+
+    blockSize = blockCipher.getBlockSize();
+    if (size % blockSize)
+        throw std::invalid_argument("ciphertext size must be a multiple of blockSize");
+    if (size == 0)
+        return 0;
+
+    nblocks = size / blockSize;
+    if (ciphertext != plaintext || kernel) {
+        decryptChunk(ciphertext, plaintext, iv, nblocks);
+        return getUnpaddedSize(plaintext, size);
+    }
+
     try {
-        padding = blockPadding.addPadding(buffer, nbytes);
+        output = new uint8_t[BATCH_BLOCKS * blockSize];
     } catch (std::bad_alloc &e) {
         throw;
     }
 
-    // XOR plaintext with previous round's ciphertext
-    for (uint8_t i = 0; i < blockSize; i++)
-        buffer[i] ^= prev[i];
+    memcpy(prev, iv, blockSize);
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < BATCH_BLOCKS ? nblocks - b : BATCH_BLOCKS;
 
-    // encrypt the plaintext block and write it to the output stream
-    blockCipher.encryptBlock(buffer, buffer);
-    ciphertext.write((char*) buffer, blockSize);
+        // save the last ciphertext block of the chunk before it is overwritten
+        decryptChunk(ciphertext + b * blockSize, output, prev, n);
+        memcpy(prev, ciphertext + (b + n - 1) * blockSize, blockSize);
+        memcpy(plaintext + b * blockSize, output, n * blockSize);
+    }
 
-    // if the padding scheme required an additional full block of padding, encrypt it and write it to the output stream
-    if (padding) {
-        for (uint8_t i = 0; i < blockSize; i++)
-            padding[i] ^= buffer[i];
+    delete[] output;
 
-        blockCipher.encryptBlock(padding, padding);
-        ciphertext.write((char*) padding, blockSize);
-        delete padding;
-    }
-    delete buffer;
-    delete prev;
+    return getUnpaddedSize(plaintext, size);
 }
 
 /**
- * takes data from a ciphertext stream, decrypts and strips padding, and writes it to a plaintext stream 
+ * starts an incremental encryption/decryption of one message, for data that arrives in pieces
+ * the context keeps a reference to this CBC, which must outlive it
  *
- * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
  *
- * @param ciphertext std::istream where data is retrieved for decryption
- * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ * @return a heap allocated context ready for update(), the caller must delete it
  *
- * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
  */
-void CBC::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
-    uint8_t blockSize, *buffer, *prev, *next, padding;
-
-    blockSize = blockCipher.getBlockSize();
+ModeContext* CBC::createContext(DIRECTION direction) const {
+    ModeContext *context;
 
     try {
-        buffer = new uint8_t[blockSize];
-        prev = new uint8_t[blockSize];
-        next = new uint8_t[blockSize];
+        context = new Context(*this, direction);
     } catch (std::bad_alloc &e) {
         throw;
-    } 
-
-    // read first block of ciphertext
-    ciphertext.read((char*) buffer, blockSize);
-
-    // prepare iv
-    for (uint8_t i = 0; i < blockSize; i++)
-        prev[i] = iv[i];
-
-    while (ciphertext.peek() != EOF) {
-        // save this round's ciphertext
-        for (uint8_t i = 0; i < blockSize; i++)
-            next[i] = buffer[i];
-        
-        // decrypt ciphertext block
-        blockCipher.decryptBlock(buffer, buffer);
-        
-        // XOR plaintext with last round's ciphertext
-        for (uint8_t i = 0; i < blockSize; i++) {
-            buffer[i] ^= prev[i];
-            prev[i] = next[i];
-        }
-
-        // write plaintext to output stream
-        plaintext.write((char*) buffer, blockSize);
-
-        // read next block of ciphertext
-        ciphertext.read((char*) buffer, blockSize);
     }
 
-    // decrypt ciphertext block
-    blockCipher.decryptBlock(buffer, buffer);
-        
-    // XOR plaintext with last round's ciphertext
-    for (uint8_t i = 0; i < blockSize; i++)
-        buffer[i] ^= prev[i];
-
-    // strip padding and write it to the output stream
-    padding = blockPadding.getPaddingAmount(buffer);
-    if (padding != blockSize)
-        plaintext.write((char*) buffer, blockSize - padding);
-
-    delete buffer;
-    delete prev;
-    delete next;
-}
\ No newline at end of file
+    return context;
+}
+
+/**
+ * CBC::Context primary constructor
+ *
+ * @param cbc the mode of operation whose cipher, padding, and iv are used
+ * @param direction whether the context encrypts or decrypts
+ */
+CBC::Context::Context(const CBC &cbc, DIRECTION direction) : BlockContext(cbc, direction), cbc(cbc) {
+    init();
+}
+
+/**
+ * CBC::Context destructor
+ */
+CBC::Context::~Context() {
+
+}
+
+/**
+ * discards any buffered data and restarts the chain from the iv
+ */
+void CBC::Context::init() {
+    BlockContext::init();
+    memcpy(prev, cbc.iv, cbc.ivSize);
+}
+
+/**
+ * encrypts/decrypts whole blocks, carrying the previous ciphertext block from one call to the next
+ *
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks, must not overlap input
+ * @param nblocks the number of blocks
+ */
+void CBC::Context::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    uint8_t blockSize = cbc.blockCipher.getBlockSize();
+
+    if (nblocks == 0)
+        return;
+
+    if (direction == ENCRYPT) {
+        cbc.encryptChain(prev, input, output, nblocks);
+    } else {
+        cbc.decryptChunk(input, output, prev, nblocks);
+        memcpy(prev, input + (nblocks - 1) * blockSize, blockSize);
+    }
+}
@@ -19,11 +19,32 @@
 
 class CBC : public BlockModeOfOperation {
 private:
+    CBC();
+    CBC& operator=(const CBC &that) = delete;
+
+protected:
     uint8_t iv[256];
     uint8_t ivSize;
 
-    CBC();
-    CBC& operator=(const CBC &that) = delete;
+    void encryptChain(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void decryptChunk(const uint8_t *ciphertext, uint8_t *plaintext, const uint8_t prev[], size_t nblocks) const;
+    void decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const;
+
+    class Context : public BlockContext {
+    private:
+        const CBC &cbc;
+        uint8_t prev[256];
+
+        Context();
+
+    protected:
+        void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        Context(const CBC &cbc, DIRECTION direction);
+        ~Context();
+        void init();
+    };
 
 public:
     CBC(const BlockCipher &blockCipher, const BlockPadding &blockPadding, const uint8_t iv[], uint8_t ivSize);
@@ -32,6 +53,9 @@ public:
 
     void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
     void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    ModeContext* createContext(DIRECTION direction) const;
 };
 
 #endif
\ No newline at end of file
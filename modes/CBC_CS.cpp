@@ -0,0 +1,470 @@
+/**
+ * class implementation for the CBC mode of operation with ciphertext stealing (NIST SP 800-38A addendum).
+ * @file CBC_CS.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "CBC_CS.hpp"
+
+/**
+ * CBC_CS primary constructor
+ *
+ * @param blockCipher a reference to a BlockCipher that will be used to encrypt/decrypt data
+ * @param iv the iv used during encryption/decryption
+ * @param ivSize the size of the iv
+ * @param variant which of CS1, CS2, or CS3 orders the last two ciphertext blocks
+ *
+ * @throws std::invalid_argument if blockCipher and iv don't have the same size or variant is unknown
+ */
+CBC_CS::CBC_CS(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, VARIANT variant) : ModeOfOperation(blockCipher), ivSize(ivSize), variant(variant) {
+    if (blockCipher.getBlockSize() != ivSize)
+        throw std::invalid_argument("blockCipher and iv must have the same blockSize");
+    if (variant != CS1 && variant != CS2 && variant != CS3)
+        throw std::invalid_argument("unknown ciphertext stealing variant");
+
+    for (int i = 0; i < ivSize; i++)
+        this->iv[i] = iv[i];
+}
+
+/**
+ * CBC_CS copy constructor
+ *
+ * @param that reference to a preexisting CBC_CS object that should be copied
+ */
+CBC_CS::CBC_CS(const CBC_CS &that) : CBC_CS(that.blockCipher, that.iv, that.ivSize, that.variant) {
+
+}
+
+/**
+ * CBC_CS destructor
+ */
+CBC_CS::~CBC_CS() {
+
+}
+
+/**
+ * @param partial the number of bytes in the final block, 1 to blockSize
+ *
+ * @return whether the last full ciphertext block is written after the final one
+ */
+bool CBC_CS::isSwapped(size_t partial) const {
+    return variant == CS3 || (variant == CS2 && partial != blockCipher.getBlockSize());
+}
+
+/**
+ * @param size the number of bytes in a message
+ *
+ * @return the number of blocks at the start of the message that are chained as in plain CBC,
+ * which is every block but the final blockSize to 2 * blockSize bytes
+ */
+size_t CBC_CS::getChainedBlocks(size_t size) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+
+    return size <= 2 * blockSize ? 0 : (size - blockSize - 1) / blockSize;
+}
+
+/**
+ * encrypts whole blocks as in CBC
+ *
+ * @param prev the ciphertext block (or iv) before the first block, the last ciphertext block on return
+ * @param plaintext nblocks blocks of data
+ * @param ciphertext room for nblocks blocks, may be the same buffer as plaintext
+ * @param nblocks the number of blocks
+ */
+void CBC_CS::chainEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+
+    if (kernel) {
+        kernel->cbcEncrypt(prev, plaintext, ciphertext, nblocks);
+        return;
+    }
+
+    for (size_t b = 0; b < nblocks; b++) {
+        xorBytes(ciphertext + b * blockSize, plaintext + b * blockSize, prev, blockSize);
+        blockCipher.encryptBlock(ciphertext + b * blockSize, ciphertext + b * blockSize);
+        memcpy(prev, ciphertext + b * blockSize, blockSize);
+    }
+}
+
+/**
+ * decrypts whole blocks as in CBC with one call to the block cipher
+ *
+ * @param prev the ciphertext block (or iv) before the first block, the last ciphertext block on return
+ * @param ciphertext nblocks blocks of data
+ * @param plaintext room for nblocks blocks, must not overlap ciphertext unless it is the same buffer and there is a kernel for the cipher
+ * @param nblocks the number of blocks
+ */
+void CBC_CS::chainDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+
+    if (kernel) {
+        kernel->cbcDecrypt(prev, ciphertext, plaintext, nblocks);
+        return;
+    }
+    if (nblocks == 0)
+        return;
+
+    blockCipher.decryptBlocks(ciphertext, plaintext, nblocks);
+    xorBytes(plaintext, plaintext, prev, blockSize);
+    xorBytes(plaintext + blockSize, plaintext + blockSize, ciphertext, (nblocks - 1) * blockSize);
+    memcpy(prev, ciphertext + (nblocks - 1) * blockSize, blockSize);
+}
+
+/**
+ * encrypts the final blockSize to 2 * blockSize bytes of a message
+ * the partial block is zero padded and chained onto the last full block, whose ciphertext is then
+ * cut down to the size of the partial block, since the final block's ciphertext depends on all of it
+ *
+ * algorithm described in the addendum to NIST SP 800-38A: https://csrc.nist.gov/publications/detail/sp/800-38a/addendum/final
+ *
+ * @param prev the ciphertext block (or iv) before the tail
+ * @param plaintext size bytes of data
+ * @param size the number of bytes, blockSize to 2 * blockSize
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ */
+void CBC_CS::encryptTail(const uint8_t prev[], const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize, full[256], last[256];
+    size_t partial;
+
+    blockSize = blockCipher.getBlockSize();
+    if (size == blockSize) {
+        xorBytes(full, plaintext, prev, blockSize);
+        blockCipher.encryptBlock(full, ciphertext);
+        return;
+    }
+
+    partial = size - blockSize;
+    xorBytes(full, plaintext, prev, blockSize);
+    blockCipher.encryptBlock(full, full);
+
+    memset(last, 0, blockSize);
+    memcpy(last, plaintext + blockSize, partial);
+    xorBytes(last, last, full, blockSize);
+    blockCipher.encryptBlock(last, last);
+
+    if (isSwapped(partial)) {
+        memcpy(ciphertext, last, blockSize);
+        memcpy(ciphertext + blockSize, full, partial);
+    } else {
+        memcpy(ciphertext, full, partial);
+        memcpy(ciphertext + partial, last, blockSize);
+    }
+}
+
+/**
+ * decrypts the final blockSize to 2 * blockSize bytes of a message
+ * decrypting the final block gives the missing end of the last full ciphertext block, since it was chained onto zero padding
+ *
+ * @param prev the ciphertext block (or iv) before the tail
+ * @param ciphertext size bytes of data
+ * @param size the number of bytes, blockSize to 2 * blockSize
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ */
+void CBC_CS::decryptTail(const uint8_t prev[], const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t blockSize, full[256], last[256];
+    const uint8_t *stolen, *finalBlock;
+    size_t partial;
+
+    blockSize = blockCipher.getBlockSize();
+    if (size == blockSize) {
+        blockCipher.decryptBlock(ciphertext, full);
+        xorBytes(plaintext, full, prev, blockSize);
+        return;
+    }
+
+    partial = size - blockSize;
+    if (isSwapped(partial)) {
+        finalBlock = ciphertext;
+        stolen = ciphertext + blockSize;
+    } else {
+        stolen = ciphertext;
+        finalBlock = ciphertext + partial;
+    }
+
+    // rebuild the last full ciphertext block from its stolen start and the end recovered from the final block
+    blockCipher.decryptBlock(finalBlock, last);
+    memcpy(full, stolen, partial);
+    memcpy(full + partial, last + partial, blockSize - partial);
+    xorBytes(last, last, full, partial);
+
+    blockCipher.decryptBlock(full, full);
+    xorBytes(full, full, prev, blockSize);
+
+    memcpy(plaintext, full, blockSize);
+    memcpy(plaintext + blockSize, last, partial);
+}
+
+/**
+ * takes data from a plaintext stream, encrypts, and writes it to a ciphertext stream of the same size
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
+ *
+ * @param plaintext std::istream where data is retrieved for encryption, empty or at least one block
+ * @param ciphertext std::ostream where data is sent after encrypting
+ *
+ * @throws std::invalid_argument if the plaintext is shorter than one block
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void CBC_CS::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
+    processStream(plaintext, ciphertext, ENCRYPT);
+}
+
+/**
+ * takes data from a ciphertext stream, decrypts, and writes it to a plaintext stream of the same size
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption, empty or at least one block
+ * @param plaintext std::ostream where data is sent after decrypting
+ *
+ * @throws std::invalid_argument if the ciphertext is shorter than one block
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void CBC_CS::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    processStream(ciphertext, plaintext, DECRYPT);
+}
+
+/**
+ * encrypts a contiguous buffer of plaintext without going through iostreams
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes, 0 or at least one block
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to size
+ *
+ * @throws std::invalid_argument if size is smaller than one block
+ */
+size_t CBC_CS::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize, prev[256];
+    size_t nblocks;
+
+    blockSize = blockCipher.getBlockSize();
+    if (size == 0)
+        return 0;
+    if (size < blockSize)
+        throw std::invalid_argument("ciphertext stealing requires at least one block of data");
+
+    memcpy(prev, iv, blockSize);
+    nblocks = getChainedBlocks(size);
+    chainEncrypt(prev, plaintext, ciphertext, nblocks);
+    encryptTail(prev, plaintext + nblocks * blockSize, size - nblocks * blockSize, ciphertext + nblocks * blockSize);
+
+    return size;
+}
+
+/**
+ * decrypts a contiguous buffer of ciphertext without going through iostreams
+ * in-place buffers go through a chunk of scratch space, unless there is a kernel for the cipher,
+ * since every block is XORed with the ciphertext block before it
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes, 0 or at least one block
+ * @param plaintext room for size bytes, either the same buffer as ciphertext or not overlapping it
+ *
+ * @return the number of plaintext bytes written, equal to size
+ *
+ * @throws std::invalid_argument if size is smaller than one block
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the in-place scratch space
+ */
+size_t CBC_CS::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t blockSize, prev[256], *output;
+    size_t nblocks, n;
+
+    blockSize = blockCipher.getBlockSize();
+    if (size == 0)
+        return 0;
+    if (size < blockSize)
+        throw std::invalid_argument("ciphertext stealing requires at least one block of data");
+
+    memcpy(prev, iv, blockSize);
+    nblocks = getChainedBlocks(size);
+    if (ciphertext != plaintext || kernel) {
+        chainDecrypt(prev, ciphertext, plaintext, nblocks);
+    } else {
+        try {
+            output = new uint8_t[BATCH_BLOCKS * blockSize];
+        } catch (std::bad_alloc &e) {
+            throw;
+        }
+
+        // prev is taken from the ciphertext before the chunk is overwritten
+        for (size_t b = 0; b < nblocks; b += n) {
+            n = nblocks - b < BATCH_BLOCKS ? nblocks - b : BATCH_BLOCKS;
+            chainDecrypt(prev, ciphertext + b * blockSize, output, n);
+            memcpy(plaintext + b * blockSize, output, n * blockSize);
+        }
+
+        delete[] output;
+    }
+
+    decryptTail(prev, ciphertext + nblocks * blockSize, size - nblocks * blockSize, plaintext + nblocks * blockSize);
+
+    return size;
+}
+
+/**
+ * @param plaintextSize the number of plaintext bytes to encrypt
+ *
+ * @return plaintextSize, ciphertext stealing does not pad
+ */
+size_t CBC_CS::getEncryptedSize(size_t plaintextSize) const {
+    return plaintextSize;
+}
+
+/**
+ * starts an incremental encryption/decryption of one message, for data that arrives in pieces
+ * the context keeps a reference to this CBC_CS, which must outlive it
+ *
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
+ *
+ * @return a heap allocated context ready for update(), the caller must delete it
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
+ */
+ModeContext* CBC_CS::createContext(DIRECTION direction) const {
+    ModeContext *context;
+
+    try {
+        context = new Context(*this, direction);
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    return context;
+}
+
+/**
+ * CBC_CS::Context primary constructor
+ *
+ * @param mode the mode of operation whose cipher, iv, and variant are used
+ * @param direction whether the context encrypts or decrypts
+ */
+CBC_CS::Context::Context(const CBC_CS &mode, DIRECTION direction) : mode(mode), direction(direction), npending(0) {
+    init();
+}
+
+/**
+ * CBC_CS::Context destructor
+ */
+CBC_CS::Context::~Context() {
+
+}
+
+/**
+ * discards any buffered data and restarts the chain from the iv
+ */
+void CBC_CS::Context::init() {
+    npending = 0;
+    memcpy(prev, mode.iv, mode.ivSize);
+}
+
+/**
+ * encrypts/decrypts whole blocks that are known not to be among the final two
+ *
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks, must not overlap input
+ * @param nblocks the number of blocks
+ */
+void CBC_CS::Context::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    if (direction == ENCRYPT)
+        mode.chainEncrypt(prev, input, output, nblocks);
+    else
+        mode.chainDecrypt(prev, input, output, nblocks);
+}
+
+/**
+ * encrypts/decrypts every block that can no longer be one of the final two, holding back the rest
+ *
+ * @param input size bytes of data
+ * @param size the number of bytes
+ * @param output room for getUpdateSize(size) bytes, must not overlap input
+ *
+ * @return the number of bytes written to output
+ */
+size_t CBC_CS::Context::update(const uint8_t *input, size_t size, uint8_t *output) {
+    uint8_t blockSize;
+    size_t nblocks, take;
+
+    blockSize = mode.blockCipher.getBlockSize();
+    if (npending + size <= 2 * blockSize) {
+        // an empty update may pass a null input
+        if (size)
+            memcpy(pending + npending, input, size);
+        npending += size;
+        return 0;
+    }
+
+    // fill the two held back blocks, more input is known to follow them so the first is not part of the tail
+    take = 2 * blockSize - npending;
+    memcpy(pending + npending, input, take);
+    input += take;
+    size -= take;
+
+    if (size <= blockSize) {
+        processBlocks(pending, output, 1);
+        memcpy(pending, pending + blockSize, blockSize);
+        memcpy(pending + blockSize, input, size);
+        npending = blockSize + size;
+        return blockSize;
+    }
+
+    // process the whole blocks of the input, holding back the final blockSize + 1 to 2 * blockSize bytes
+    processBlocks(pending, output, 2);
+    nblocks = (size - blockSize - 1) / blockSize;
+    processBlocks(input, output + 2 * blockSize, nblocks);
+
+    npending = size - nblocks * blockSize;
+    memcpy(pending, input + nblocks * blockSize, npending);
+
+    return (nblocks + 2) * blockSize;
+}
+
+/**
+ * encrypts/decrypts the held back tail, then readies the context for a new message
+ *
+ * @param output room for getFinalSize() bytes
+ *
+ * @return the number of bytes written to output
+ *
+ * @throws std::invalid_argument if the message was shorter than one block
+ */
+size_t CBC_CS::Context::final(uint8_t *output) {
+    size_t written = npending;
+
+    if (npending == 0)
+        return 0;
+    if (npending < mode.blockCipher.getBlockSize()) {
+        init();
+        throw std::invalid_argument("ciphertext stealing requires at least one block of data");
+    }
+
+    if (direction == ENCRYPT)
+        mode.encryptTail(prev, pending, npending, output);
+    else
+        mode.decryptTail(prev, pending, npending, output);
+
+    init();
+
+    return written;
+}
+
+/**
+ * @param size the number of bytes about to be passed to update()
+ *
+ * @return the exact number of bytes update() will write
+ */
+size_t CBC_CS::Context::getUpdateSize(size_t size) const {
+    uint8_t blockSize = mode.blockCipher.getBlockSize();
+
+    if (npending + size <= 2 * blockSize)
+        return 0;
+
+    return (npending + size - blockSize - 1) / blockSize * blockSize;
+}
+
+/**
+ * @return the number of bytes final() will write given the data held back so far
+ */
+size_t CBC_CS::Context::getFinalSize() const {
+    return npending;
+}
@@ -0,0 +1,82 @@
+/**
+ * header file for the CBC mode of operation with ciphertext stealing (NIST SP 800-38A addendum).
+ * @file CBC_CS.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYCBC_CS
+#define MYCBC_CS
+
+#include <istream>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include "ModeOfOperation.hpp"
+#include "../ciphers/BlockCipher.hpp"
+
+class CBC_CS : public ModeOfOperation {
+public:
+    // where the partial final block goes, the three variants only differ in the order of the last two blocks
+    enum VARIANT : uint8_t {
+        CS1 = 1,    // the partial block, then the last full block
+        CS2,        // as CS1 for block aligned data, otherwise as CS3
+        CS3         // the last two blocks always swapped, as used by Kerberos
+    };
+
+private:
+    CBC_CS();
+    CBC_CS& operator=(const CBC_CS &that) = delete;
+
+protected:
+    uint8_t iv[256];
+    uint8_t ivSize;
+    VARIANT variant;
+
+    bool isSwapped(size_t partial) const;
+    void chainEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void chainDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+    void encryptTail(const uint8_t prev[], const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    void decryptTail(const uint8_t prev[], const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    size_t getChainedBlocks(size_t size) const;
+
+    // buffers partial blocks between updates and always holds back the final blockSize to 2 * blockSize bytes,
+    // which are the only ones affected by the stealing
+    class Context : public ModeContext {
+    private:
+        const CBC_CS &mode;
+        const DIRECTION direction;
+        uint8_t pending[512];
+        size_t npending;
+        uint8_t prev[256];
+
+        Context();
+        void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        Context(const CBC_CS &mode, DIRECTION direction);
+        ~Context();
+        void init();
+        size_t update(const uint8_t *input, size_t size, uint8_t *output);
+        size_t final(uint8_t *output);
+        size_t getUpdateSize(size_t size) const;
+        size_t getFinalSize() const;
+    };
+
+public:
+    CBC_CS(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, VARIANT variant = CS3);
+    CBC_CS(const CBC_CS &that);
+    ~CBC_CS();
+
+    void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
+    void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    size_t getEncryptedSize(size_t plaintextSize) const;
+    ModeContext* createContext(DIRECTION direction) const;
+};
+
+#endif
@@ -42,6 +42,7 @@ CFB::~CFB() {
 
 /**
  * takes data from a plaintext stream, encrypts, and writes it to a ciphertext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
  *
  * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
  *
@@ -51,124 +52,250 @@ CFB::~CFB() {
  * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
  */
 void CFB::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
-    uint8_t blockSize, *buffer, *prev, nbytes;
+    processStream(plaintext, ciphertext, ENCRYPT);
+}
+
+/**
+ * takes data from a ciphertext stream, decrypts, and writes it to a plaintext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void CFB::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    processStream(ciphertext, plaintext, DECRYPT);
+}
+
+/**
+ * decrypts a run of ciphertext whose keystream inputs are all known: prev, then every ciphertext block but the last
+ * the keystream for the whole blocks is built and encrypted with one call to the block cipher, so separate runs can be decrypted concurrently
+ *
+ * @param ciphertext nbytes of ciphertext, only the final run of a stream may end in a partial block
+ * @param plaintext room for nbytes, used for the keystream before it holds the plaintext,
+ * must not overlap ciphertext unless it is the same buffer and there is a kernel for the cipher
+ * @param prev the ciphertext block (or iv) that precedes the run
+ * @param nbytes the number of bytes in the run
+ */
+void CFB::decryptChunk(const uint8_t *ciphertext, uint8_t *plaintext, const uint8_t prev[], size_t nbytes) const {
+    uint8_t blockSize, keystream[256], chain[256];
+    size_t nblocks, remainder;
 
     blockSize = blockCipher.getBlockSize();
-    try {
-        buffer = new uint8_t[blockSize];
-        prev = new uint8_t[blockSize];
-    } catch (std::bad_alloc &e) {
-        throw;
-    }
+    nblocks = nbytes / blockSize;
+    remainder = nbytes % blockSize;
+    memcpy(chain, prev, blockSize);
 
-    // read first block of plaintext
-    plaintext.read((char*) buffer, blockSize);
-    nbytes = plaintext.gcount();
+    if (nblocks && kernel) {
+        kernel->cfbDecrypt(chain, ciphertext, plaintext, nblocks);
+    } else if (nblocks) {
+        // the input to the first keystream block is prev, the input to every other one is the previous ciphertext block
+        memcpy(plaintext, prev, blockSize);
+        memcpy(plaintext + blockSize, ciphertext, (nblocks - 1) * blockSize);
 
-    // prepare iv
-    for (uint8_t i = 0; i < blockSize; i++)
-        prev[i] = iv[i];
+        // encrypt the previous ciphertext blocks and XOR them with the ciphertext
+        blockCipher.encryptBlocks(plaintext, plaintext, nblocks);
+        xorBytes(plaintext, plaintext, ciphertext, nblocks * blockSize);
+        memcpy(chain, ciphertext + (nblocks - 1) * blockSize, blockSize);
+    }
 
-    while (plaintext.peek() != EOF) {
-        // encrypt previous round's ciphertext
-        blockCipher.encryptBlock(prev, prev);
+    // a trailing partial block only uses part of its keystream
+    if (remainder) {
+        blockCipher.encryptBlock(chain, keystream);
+        xorBytes(plaintext + nblocks * blockSize, ciphertext + nblocks * blockSize, keystream, remainder);
+    }
+}
 
-        // XOR plaintext with the previous round's encrypted ciphertext
-        for (uint8_t i = 0; i < blockSize; i++)
-            buffer[i] ^= prev[i];
+/**
+ * decrypts a run of blocks anywhere in the ciphertext, the only chaining state it needs is the ciphertext block before it
+ *
+ * @param ciphertext the start of the whole ciphertext
+ * @param firstBlock the index of the first block to decrypt
+ * @param nbytes the number of bytes to decrypt, a multiple of the block size unless the run ends the ciphertext
+ * @param plaintext room for nbytes, must not overlap ciphertext
+ */
+void CFB::decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
 
-        // write it to the output stream
-        ciphertext.write((char*) buffer, blockSize);
+    decryptChunk(ciphertext + firstBlock * blockSize, plaintext, firstBlock ? ciphertext + (firstBlock - 1) * blockSize : iv, nbytes);
+}
 
-        // save this round's ciphertext
-        for (uint8_t i = 0; i < blockSize; i++)
-            prev[i] = buffer[i];
+/**
+ * encrypts a contiguous buffer of plaintext without going through iostreams
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to size
+ */
+size_t CFB::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize, keystream[256], chain[256];
+    const uint8_t *prev = iv;
+    size_t offset = 0;
 
-        // read next block of plaintext
-        plaintext.read((char*) buffer, blockSize);
-        nbytes = plaintext.gcount();
+    blockSize = blockCipher.getBlockSize();
+    if (kernel && size >= blockSize) {
+        memcpy(chain, iv, blockSize);
+        kernel->cfbEncrypt(chain, plaintext, ciphertext, size / blockSize);
+        offset = size / blockSize * blockSize;
+        prev = ciphertext + offset - blockSize;
     }
 
-    // encrypt previous round's ciphertext
-    blockCipher.encryptBlock(prev, prev);
-
-    // XOR plaintext with the previous round's encrypted ciphertext
-    for (uint8_t i = 0; i < nbytes; i++)
-        buffer[i] ^= prev[i];
-    
-    // write it to the output stream
-    ciphertext.write((char*) buffer, nbytes);
+    for (; offset < size; offset += blockSize) {
+        // encrypt previous round's ciphertext and XOR it with the plaintext
+        blockCipher.encryptBlock(prev, keystream);
+        xorBytes(ciphertext + offset, plaintext + offset, keystream, size - offset < blockSize ? size - offset : blockSize);
+        prev = ciphertext + offset;
+    }
 
-    delete buffer;
-    delete prev;
+    return size;
 }
 
 /**
- * takes data from a ciphertext stream, decrypts, and writes it to a plaintext stream 
+ * decrypts a contiguous buffer of ciphertext without going through iostreams
+ * separate buffers, or any buffers when there is a kernel for the cipher, are decrypted in a single run,
+ * in-place buffers otherwise go through a chunk of scratch space since the ciphertext is also the keystream input
  *
- * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes
+ * @param plaintext room for size bytes, either the same buffer as ciphertext or not overlapping it
  *
- * @param ciphertext std::istream where data is retrieved for decryption
- * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ * @return the number of plaintext bytes written, equal to size
  *
- * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the in-place scratch space
  */
-void CFB::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
-    uint8_t blockSize, *buffer, *prev, *next, nbytes;
+size_t CFB::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t blockSize, *output, prev[256];
+    size_t chunkSize, n;
 
-    blockSize = blockCipher.getBlockSize();
+    if (size == 0)
+        return 0;
+    if (ciphertext != plaintext || kernel) {
+        decryptChunk(ciphertext, plaintext, iv, size);
+        return size;
+    }
 
+    blockSize = blockCipher.getBlockSize();
+    chunkSize = BATCH_BLOCKS * blockSize;
     try {
-        buffer = new uint8_t[blockSize];
-        prev = new uint8_t[blockSize];
-        next = new uint8_t[blockSize];
+        output = new uint8_t[chunkSize];
     } catch (std::bad_alloc &e) {
         throw;
-    } 
-
-    // read first block of ciphertext
-    ciphertext.read((char*) buffer, blockSize);
-    nbytes = ciphertext.gcount();
-
-    // prepare iv
-    for (uint8_t i = 0; i < blockSize; i++)
-        prev[i] = iv[i];
-
-    while (ciphertext.peek() != EOF) {
-        // save this round's ciphertext
-        for (uint8_t i = 0; i < blockSize; i++)
-            next[i] = buffer[i];
-        
-        // encrypt previous round's ciphertext
-        blockCipher.encryptBlock(prev, prev);
-        
-        // XOR ciphertext with the previous round's encrypted ciphertext
-        for (uint8_t i = 0; i < blockSize; i++) {
-            buffer[i] ^= prev[i];
-            prev[i] = next[i];
-        }
+    }
 
-        // write it to the output stream
-        plaintext.write((char*) buffer, blockSize);
+    memcpy(prev, iv, blockSize);
+    for (size_t offset = 0; offset < size; offset += n) {
+        n = size - offset < chunkSize ? size - offset : chunkSize;
 
-        // read next block of ciphertext
-        ciphertext.read((char*) buffer, blockSize);
-        nbytes = ciphertext.gcount();
+        // save the last ciphertext block of the chunk before it is overwritten, only the final chunk can be partial
+        decryptChunk(ciphertext + offset, output, prev, n);
+        if (n == chunkSize)
+            memcpy(prev, ciphertext + offset + chunkSize - blockSize, blockSize);
+        memcpy(plaintext + offset, output, n);
     }
 
-    if (nbytes) {
-        // encrypt previous round's ciphertext
-        blockCipher.encryptBlock(prev, prev);
-            
-        // XOR ciphertext with the previous round's encrypted ciphertext
-        for (uint8_t i = 0; i < nbytes; i++)
-            buffer[i] ^= prev[i];
+    delete[] output;
+
+    return size;
+}
+
+/**
+ * starts an incremental encryption/decryption of one message, for data that arrives in pieces
+ * the context keeps a reference to this CFB, which must outlive it
+ *
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
+ *
+ * @return a heap allocated context ready for update(), the caller must delete it
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
+ */
+ModeContext* CFB::createContext(DIRECTION direction) const {
+    ModeContext *context;
+
+    try {
+        context = new Context(*this, direction);
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    return context;
+}
+
+/**
+ * CFB::Context primary constructor
+ *
+ * @param cfb the mode of operation whose cipher and iv are used
+ * @param direction whether the context encrypts or decrypts
+ */
+CFB::Context::Context(const CFB &cfb, DIRECTION direction) : StreamContext(cfb, direction), cfb(cfb) {
+    init();
+}
+
+/**
+ * CFB::Context destructor
+ */
+CFB::Context::~Context() {
+
+}
+
+/**
+ * marks the keystream as used up and restarts the chain from the iv
+ */
+void CFB::Context::init() {
+    StreamContext::init();
+    memcpy(prev, cfb.iv, cfb.ivSize);
+}
+
+/**
+ * encrypts the previous ciphertext block (or iv) to get the keystream of the next block
+ */
+void CFB::Context::nextKeystream() {
+    cfb.blockCipher.encryptBlock(prev, keystream);
+}
 
-        // write it to the output stream
-        plaintext.write((char*) buffer, nbytes);
+/**
+ * collects the ciphertext of the current block, it becomes the keystream input of the next block once complete
+ *
+ * @param ciphertext n bytes of ciphertext
+ * @param offset the position of the first byte within its block
+ * @param n the number of bytes
+ */
+void CFB::Context::absorb(const uint8_t *ciphertext, size_t offset, size_t n) {
+    // an empty update may pass a null ciphertext
+    if (n)
+        memcpy(prev + offset, ciphertext, n);
+}
+
+/**
+ * decrypts whole blocks in a single run since the ciphertext is already known, encryption goes a block at a time
+ * (inside the kernel for the cipher when there is one), writing each ciphertext block to output and prev together
+ *
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks, must not overlap input
+ * @param nblocks the number of blocks
+ */
+void CFB::Context::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    uint8_t blockSize = cfb.blockCipher.getBlockSize();
+
+    if (direction == ENCRYPT && cfb.kernel) {
+        cfb.kernel->cfbEncrypt(prev, input, output, nblocks);
+        return;
     }
+    if (direction == ENCRYPT) {
+        // each ciphertext block is written out and kept as the next keystream input in one pass
+        for (size_t b = 0; b < nblocks; b++) {
+            nextKeystream();
+            BlockOps::xorCopy(output + b * blockSize, prev, input + b * blockSize, keystream, blockSize);
+        }
+        return;
+    }
+    if (nblocks == 0)
+        return;
 
-    delete buffer;
-    delete prev;
-    delete next;
-}
\ No newline at end of file
+    cfb.decryptChunk(input, output, prev, nblocks * blockSize);
+    memcpy(prev, input + (nblocks - 1) * blockSize, blockSize);
+}
@@ -19,11 +19,33 @@
 
 class CFB : public StreamModeOfOperation {
 private:
+    CFB();
+    CFB& operator=(const CFB &that) = delete;
+
+protected:
     uint8_t iv[256];
     uint8_t ivSize;
 
-    CFB();
-    CFB& operator=(const CFB &that) = delete;
+    void decryptChunk(const uint8_t *ciphertext, uint8_t *plaintext, const uint8_t prev[], size_t nbytes) const;
+    void decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const;
+
+    class Context : public StreamContext {
+    private:
+        const CFB &cfb;
+        uint8_t prev[256];
+
+        Context();
+
+    protected:
+        void nextKeystream();
+        void absorb(const uint8_t *ciphertext, size_t offset, size_t n);
+        void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        Context(const CFB &cfb, DIRECTION direction);
+        ~Context();
+        void init();
+    };
 
 public:
     CFB(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize);
@@ -32,6 +54,9 @@ public:
 
     void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
     void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    ModeContext* createContext(DIRECTION direction) const;
 };
 
 #endif
\ No newline at end of file
@@ -7,6 +7,35 @@
 
 #include "CTR.hpp"
 
+/**
+ * increments a big-endian counter block by 1, wrapping around to 0 after the maximum value
+ *
+ * @param ctr the counter block to increment
+ * @param size the size of the counter block
+ */
+void CTR::incrementCounter(uint8_t ctr[], uint8_t size) {
+    for (int i = size - 1; i >= 0; i--)
+        if (++ctr[i])
+            break;
+}
+
+/**
+ * adds n to a big-endian counter block, wrapping around modulo 2^(8 * size)
+ * equivalent to calling incrementCounter n times
+ *
+ * @param ctr the counter block to advance
+ * @param size the size of the counter block
+ * @param n the number of blocks to advance by
+ */
+void CTR::addCounter(uint8_t ctr[], uint8_t size, uint64_t n) {
+    unsigned int carry = 0;
+    for (int i = size - 1; i >= 0 && (n || carry); i--, n >>= 8) {
+        unsigned int sum = ctr[i] + (n & 0xff) + carry;
+        ctr[i] = sum;
+        carry = sum >> 8;
+    }
+}
+
 /**
  * CTR primary constructor
  *
@@ -41,7 +70,8 @@ CTR::~CTR() {
 }
 
 /**
- * takes data from a plaintext stream, applies padding and encryption, and writes it to a ciphertext stream 
+ * takes data from a plaintext stream, encrypts, and writes it to a ciphertext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
  *
  * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
  *
@@ -51,71 +81,218 @@ CTR::~CTR() {
  * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
  */
 void CTR::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
-    uint8_t blockSize, *buffer, *ctr, *temp, nbytes;
+    processStream(plaintext, ciphertext, ENCRYPT);
+}
+
+/**
+ * takes data from a ciphertext stream, decrypts and strips padding, and writes it to a plaintext stream 
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void CTR::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    encrypt(ciphertext, plaintext);
+}
+
+/**
+ * encrypts a contiguous buffer of plaintext without going through iostreams
+ * the counter blocks for [ModeOfOperation::BATCH_BLOCKS] blocks are encrypted at a time,
+ * or the whole blocks go through the kernel for the cipher without any heap allocation when there is one
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to size
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the keystream
+ */
+size_t CTR::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize, ctr[256], last[256], *keystream;
+    size_t chunkSize, nbytes, nblocks;
 
     blockSize = blockCipher.getBlockSize();
+    chunkSize = BATCH_BLOCKS * blockSize;
+
+    if (kernel) {
+        memcpy(ctr, iv, blockSize);
+        nblocks = size / blockSize;
+        kernel->ctr(ctr, plaintext, ciphertext, nblocks);
+
+        // a trailing partial block only uses part of its keystream
+        if (size % blockSize) {
+            generateKeystream(ctr, last, 1);
+            xorBytes(ciphertext + nblocks * blockSize, plaintext + nblocks * blockSize, last, size % blockSize);
+        }
+
+        return size;
+    }
+
     try {
-        buffer = new uint8_t[blockSize];
-        ctr = new uint8_t[blockSize];
-        temp = new uint8_t[blockSize];
+        keystream = new uint8_t[chunkSize];
     } catch (std::bad_alloc &e) {
         throw;
     }
 
-    // read first block of plaintext
-    plaintext.read((char*) buffer, blockSize);
-    nbytes = plaintext.gcount();
-
     // prepare iv/ctr
-    for (uint8_t i = 0; i < blockSize; i++)
-        ctr[i] = iv[i];
+    memcpy(ctr, iv, blockSize);
 
-    while (plaintext.peek() != EOF) {
-        // encrypt iv/ctr
-        blockCipher.encryptBlock(ctr, temp);
+    for (size_t offset = 0; offset < size; offset += nbytes) {
+        nbytes = size - offset < chunkSize ? size - offset : chunkSize;
 
-        // XOR plaintext with encrypted iv/ctr
-        for (uint8_t i = 0; i < blockSize; i++)
-            buffer[i] ^= temp[i];
+        // XOR plaintext with encrypted iv/ctr, a trailing partial block only uses part of its keystream
+        generateKeystream(ctr, keystream, (nbytes + blockSize - 1) / blockSize);
+        xorBytes(ciphertext + offset, plaintext + offset, keystream, nbytes);
+    }
 
-        // write it to the output stream
-        ciphertext.write((char*) buffer, blockSize);
+    delete[] keystream;
 
-        // increment iv/ctr by 1
-        for (uint8_t i = blockSize - 1; i >= 0; i--)
-            if (++ctr[i])
-                break;
+    return size;
+}
+
+/**
+ * decrypts a contiguous buffer of ciphertext without going through iostreams
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @return the number of plaintext bytes written, equal to size
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the keystream
+ */
+size_t CTR::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    return encrypt(ciphertext, size, plaintext);
+}
+
+/**
+ * lays out one iv/ctr per block, incrementing by 1 each time, and encrypts them
+ * 128 bit counters are laid out as two 64 bit words per block by BlockOps
+ *
+ * @param ctr the counter of the first block, advanced past the last block on return
+ * @param keystream room for nblocks blocks of keystream
+ * @param nblocks the number of keystream blocks to generate
+ */
+void CTR::generateKeystream(uint8_t ctr[], uint8_t *keystream, size_t nblocks) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
 
-        // read next block of plaintext
-        plaintext.read((char*) buffer, blockSize);
-        nbytes = plaintext.gcount();
+    if (blockSize == 16) {
+        BlockOps::generateCounters(ctr, keystream, nblocks);
+    } else {
+        for (size_t b = 0; b < nblocks; b++) {
+            memcpy(keystream + b * blockSize, ctr, blockSize);
+            incrementCounter(ctr, blockSize);
+        }
     }
 
-    // encrypt iv/ctr
-    blockCipher.encryptBlock(ctr, temp);
+    blockCipher.encryptBlocks(keystream, keystream, nblocks);
+}
 
-    // XOR plaintext with encrypted iv/ctr
-    for (uint8_t i = 0; i < nbytes; i++)
-        buffer[i] ^= temp[i];
-    
-    // write it to the output stream
-    ciphertext.write((char*) buffer, blockSize);
+/**
+ * decrypts a run of blocks anywhere in the ciphertext, the counter of any block is the iv plus the block's index
+ *
+ * @param ciphertext the start of the whole ciphertext
+ * @param firstBlock the index of the first block to decrypt
+ * @param nbytes the number of bytes to decrypt, a multiple of the block size unless the run ends the ciphertext
+ * @param plaintext room for nbytes rounded up to a whole number of blocks, must not overlap ciphertext
+ */
+void CTR::decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const {
+    uint8_t blockSize, ctr[256];
 
-    delete buffer;
-    delete ctr;
-    delete temp;
+    blockSize = blockCipher.getBlockSize();
+    memcpy(ctr, iv, blockSize);
+    addCounter(ctr, blockSize, firstBlock);
+
+    generateKeystream(ctr, plaintext, (nbytes + blockSize - 1) / blockSize);
+    xorBytes(plaintext, plaintext, ciphertext + firstBlock * blockSize, nbytes);
 }
 
 /**
- * takes data from a ciphertext stream, decrypts and strips padding, and writes it to a plaintext stream 
+ * starts an incremental encryption/decryption of one message, for data that arrives in pieces
+ * the context keeps a reference to this CTR, which must outlive it
  *
- * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
  *
- * @param ciphertext std::istream where data is retrieved for decryption
- * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ * @return a heap allocated context ready for update(), the caller must delete it
  *
- * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
  */
-void CTR::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
-    encrypt(ciphertext, plaintext);
-}
\ No newline at end of file
+ModeContext* CTR::createContext(DIRECTION direction) const {
+    ModeContext *context;
+
+    try {
+        context = new Context(*this, direction);
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    return context;
+}
+
+/**
+ * CTR::Context primary constructor
+ *
+ * @param ctr the mode of operation whose cipher and iv are used
+ * @param direction whether the context encrypts or decrypts
+ */
+CTR::Context::Context(const CTR &ctr, DIRECTION direction) : StreamContext(ctr, direction), ctr(ctr), batch(nullptr) {
+    try {
+        batch = new uint8_t[BATCH_BLOCKS * ctr.blockCipher.getBlockSize()];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    init();
+}
+
+/**
+ * CTR::Context destructor
+ */
+CTR::Context::~Context() {
+    delete[] batch;
+}
+
+/**
+ * marks the keystream as used up and restarts the counter from the iv
+ */
+void CTR::Context::init() {
+    StreamContext::init();
+    memcpy(counter, ctr.iv, ctr.ivSize);
+}
+
+/**
+ * encrypts the current iv/ctr and increments it
+ */
+void CTR::Context::nextKeystream() {
+    memcpy(keystream, counter, ctr.ivSize);
+    incrementCounter(counter, ctr.ivSize);
+    ctr.blockCipher.encryptBlock(keystream, keystream);
+}
+
+/**
+ * encrypts/decrypts whole blocks, generating their keystream up to BATCH_BLOCKS blocks at a time
+ * or inside the kernel for the cipher when there is one
+ *
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+void CTR::Context::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    uint8_t blockSize = ctr.blockCipher.getBlockSize();
+    size_t n;
+
+    if (ctr.kernel) {
+        ctr.kernel->ctr(counter, input, output, nblocks);
+        return;
+    }
+
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < BATCH_BLOCKS ? nblocks - b : BATCH_BLOCKS;
+        ctr.generateKeystream(counter, batch, n);
+        xorBytes(output + b * blockSize, input + b * blockSize, batch, n * blockSize);
+    }
+}
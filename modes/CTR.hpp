@@ -18,12 +18,36 @@
 
 class CTR : public StreamModeOfOperation {
 private:
-    uint8_t iv[256];
-    uint8_t ivSize;
-    
     CTR();
     CTR& operator=(const CTR &that) = delete;
 
+protected:
+    uint8_t iv[256];
+    uint8_t ivSize;
+
+    static void incrementCounter(uint8_t ctr[], uint8_t size);
+    static void addCounter(uint8_t ctr[], uint8_t size, uint64_t n);
+    void generateKeystream(uint8_t ctr[], uint8_t *keystream, size_t nblocks) const;
+    void decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const;
+
+    class Context : public StreamContext {
+    private:
+        const CTR &ctr;
+        uint8_t counter[256];
+        uint8_t *batch;
+
+        Context();
+
+    protected:
+        void nextKeystream();
+        void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        Context(const CTR &ctr, DIRECTION direction);
+        ~Context();
+        void init();
+    };
+
 public:
     CTR(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize);
     CTR(const CTR &that);
@@ -31,6 +55,9 @@ public:
 
     void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
     void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    ModeContext* createContext(DIRECTION direction) const;
 };
 
 #endif
\ No newline at end of file
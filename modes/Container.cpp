@@ -0,0 +1,509 @@
+/**
+ * class implementations for the chunked, seekable encrypted container format and its parallel writer and reader.
+ * @file Container.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "Container.hpp"
+#include "CBC.hpp"
+#include "CFB.hpp"
+#include "OFB.hpp"
+#include "CTR.hpp"
+#include "GCM.hpp"
+
+static const uint8_t HEADER_MAGIC[4] = { 'E', 'S', 'P', 'C' };
+static const uint8_t FOOTER_MAGIC[8] = { 'E', 'S', 'P', 'C', 'I', 'N', 'D', 'X' };
+
+/**
+ * writes an integer as size little-endian bytes
+ *
+ * @param bytes room for size bytes
+ * @param value the integer
+ * @param size the number of bytes, at most 8
+ */
+static void storeLittleEndian(uint8_t bytes[], uint64_t value, uint8_t size) {
+    for (uint8_t i = 0; i < size; i++, value >>= 8)
+        bytes[i] = value;
+}
+
+/**
+ * reads size bytes as a little-endian integer
+ *
+ * @param bytes the bytes
+ * @param size the number of bytes, at most 8
+ *
+ * @return the integer
+ */
+static uint64_t loadLittleEndian(const uint8_t bytes[], uint8_t size) {
+    uint64_t value = 0;
+
+    for (int i = size - 1; i >= 0; i--)
+        value = (value << 8) | bytes[i];
+
+    return value;
+}
+
+/**
+ * Container primary constructor, subclasses fill in the mode, chunk size, and nonce
+ *
+ * @param aes the cipher every chunk is encrypted with, it must outlive the container
+ */
+Container::Container(const AES &aes) : aes(aes), padding(16), mode(MODE_CTR), chunkSize(DEFAULT_CHUNK_SIZE) {
+    memset(nonce, 0, 16);
+}
+
+/**
+ * Container destructor
+ */
+Container::~Container() {
+
+}
+
+/**
+ * @throws std::invalid_argument if [Container::mode] is unknown or [Container::chunkSize] is not a nonzero multiple of 16 up to 1 GiB
+ */
+void Container::checkParameters() const {
+    if (mode < MODE_CBC || mode > MODE_GCM)
+        throw std::invalid_argument("unknown container mode");
+    if (chunkSize == 0 || chunkSize % 16 || chunkSize > (1u << 30))
+        throw std::invalid_argument("chunkSize must be a nonzero multiple of 16 up to 1 GiB");
+}
+
+/**
+ * builds the mode of operation for one chunk, whose iv is the nonce with the chunk index XORed into its last 8 bytes
+ * and then encrypted, so every chunk has its own unpredictable iv and can be decrypted without any other chunk
+ *
+ * @param chunk the index of the chunk
+ *
+ * @return a heap allocated mode of operation, the caller must delete it
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the mode of operation
+ */
+ModeOfOperation* Container::createMode(uint64_t chunk) const {
+    uint8_t iv[16];
+    ModeOfOperation *chunkMode = nullptr;
+
+    memcpy(iv, nonce, 16);
+    for (int i = 0; i < 8; i++)
+        iv[15 - i] ^= chunk >> (8 * i);
+    aes.encryptBlock(iv, iv);
+
+    try {
+        switch (mode) {
+        case MODE_CBC:
+            chunkMode = new CBC(aes, padding, iv, 16);
+            break;
+        case MODE_CFB:
+            chunkMode = new CFB(aes, iv, 16);
+            break;
+        case MODE_OFB:
+            chunkMode = new OFB(aes, iv, 16);
+            break;
+        case MODE_CTR:
+            chunkMode = new CTR(aes, iv, 16);
+            break;
+        case MODE_GCM:
+            chunkMode = new GCM(aes, iv, 16);
+            break;
+        }
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    return chunkMode;
+}
+
+/**
+ * @return the number of ciphertext bytes a full chunk encrypts to, including CBC padding or the GCM tag
+ */
+size_t Container::getMaxChunkCiphertextSize() const {
+    return mode == MODE_CBC || mode == MODE_GCM ? chunkSize + 16 : chunkSize;
+}
+
+/**
+ * @return [Container::mode], the mode of operation every chunk is encrypted with
+ */
+Container::MODE Container::getMode() const {
+    return mode;
+}
+
+/**
+ * @return [Container::chunkSize], the number of plaintext bytes in every chunk but the last
+ */
+uint32_t Container::getChunkSize() const {
+    return chunkSize;
+}
+
+/**
+ * ContainerWriter primary constructor, writes the header immediately so the total length never needs to be known
+ *
+ * @param output std::ostream the container is written to, it does not need to be seekable
+ * @param aes the cipher every chunk is encrypted with, it must outlive the writer
+ * @param mode the mode of operation every chunk is encrypted with
+ * @param nonce 16 bytes that must never be reused for another container under the same key
+ * @param pool the worker threads that encrypt one chunk each at a time
+ * @param chunkSize the number of plaintext bytes per chunk, a multiple of 16
+ *
+ * @throws std::invalid_argument if mode is unknown or chunkSize is not a nonzero multiple of 16 up to 1 GiB
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+ContainerWriter::ContainerWriter(std::ostream &output, const AES &aes, MODE mode, const uint8_t nonce[16], WorkerPool &pool, uint32_t chunkSize) : Container(aes), output(output), pool(pool), plaintext(nullptr), ciphertext(nullptr), nbuffered(0), position(0), finished(false) {
+    uint8_t header[HEADER_SIZE] = {0};
+
+    this->mode = mode;
+    this->chunkSize = chunkSize;
+    memcpy(this->nonce, nonce, 16);
+    checkParameters();
+
+    try {
+        plaintext = new uint8_t[pool.getThreadCount() * (size_t) chunkSize];
+        ciphertext = new uint8_t[pool.getThreadCount() * getMaxChunkCiphertextSize()];
+    } catch (std::bad_alloc &e) {
+        delete[] plaintext;
+        throw;
+    }
+
+    memcpy(header, HEADER_MAGIC, 4);
+    header[4] = VERSION;
+    header[5] = CIPHER_AES;
+    header[6] = aes.getKeySize();
+    header[7] = mode;
+    storeLittleEndian(header + 8, chunkSize, 4);
+    memcpy(header + 16, nonce, 16);
+
+    output.write((char*) header, HEADER_SIZE);
+    position = HEADER_SIZE;
+}
+
+/**
+ * ContainerWriter destructor, a container whose writer was never finished has no index and cannot be read
+ */
+ContainerWriter::~ContainerWriter() {
+    delete[] plaintext;
+    delete[] ciphertext;
+}
+
+/**
+ * encrypts the buffered chunks concurrently, one per thread, then writes them in order and records them in the index
+ * the buffer is only flushed when full or by finish(), so only the very last chunk can be partial
+ */
+void ContainerWriter::flush() {
+    size_t nchunks, maxChunk;
+    std::vector<size_t> sizes;
+
+    nchunks = (nbuffered + chunkSize - 1) / chunkSize;
+    if (nchunks == 0)
+        return;
+
+    maxChunk = getMaxChunkCiphertextSize();
+    sizes.resize(nchunks);
+    pool.run(nchunks, [&](size_t j) {
+        size_t length = nbuffered - j * chunkSize < chunkSize ? nbuffered - j * chunkSize : chunkSize;
+        ModeOfOperation *chunkMode = createMode(index.size() + j);
+
+        try {
+            sizes[j] = chunkMode->encrypt(plaintext + j * chunkSize, length, ciphertext + j * maxChunk);
+        } catch (...) {
+            delete chunkMode;
+            throw;
+        }
+        delete chunkMode;
+    });
+
+    for (size_t j = 0; j < nchunks; j++) {
+        uint32_t length = nbuffered - j * chunkSize < chunkSize ? nbuffered - j * chunkSize : chunkSize;
+
+        output.write((char*) ciphertext + j * maxChunk, sizes[j]);
+        index.push_back({position, (uint32_t) sizes[j], length});
+        position += sizes[j];
+    }
+
+    nbuffered = 0;
+}
+
+/**
+ * appends plaintext to the container, encrypting and writing every time a chunk per thread has been buffered
+ *
+ * @param data size bytes of plaintext
+ * @param size the number of bytes
+ *
+ * @throws std::invalid_argument if the container has already been finished
+ * @throws std::bad_alloc if unable to allocate memory on the heap for a chunk's mode of operation
+ */
+void ContainerWriter::write(const uint8_t *data, size_t size) {
+    size_t capacity = pool.getThreadCount() * (size_t) chunkSize, n;
+
+    if (finished)
+        throw std::invalid_argument("the container has already been finished");
+
+    for (; size; data += n, size -= n) {
+        n = capacity - nbuffered < size ? capacity - nbuffered : size;
+        memcpy(plaintext + nbuffered, data, n);
+        nbuffered += n;
+        if (nbuffered == capacity)
+            flush();
+    }
+}
+
+/**
+ * appends everything left in a plaintext stream to the container, reading straight into the chunk buffer
+ *
+ * @param input std::istream where plaintext is retrieved
+ *
+ * @throws std::invalid_argument if the container has already been finished
+ * @throws std::bad_alloc if unable to allocate memory on the heap for a chunk's mode of operation
+ */
+void ContainerWriter::write(std::istream &input) {
+    size_t capacity = pool.getThreadCount() * (size_t) chunkSize;
+
+    if (finished)
+        throw std::invalid_argument("the container has already been finished");
+
+    do {
+        input.read((char*) plaintext + nbuffered, capacity - nbuffered);
+        nbuffered += input.gcount();
+        if (nbuffered == capacity)
+            flush();
+    } while (input);
+}
+
+/**
+ * encrypts the final, possibly partial, chunk and writes the index and footer, no more plaintext can be written afterwards
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for a chunk's mode of operation
+ */
+void ContainerWriter::finish() {
+    uint8_t entry[INDEX_ENTRY_SIZE], footer[FOOTER_SIZE];
+
+    if (finished)
+        return;
+
+    flush();
+
+    for (const IndexEntry &chunk : index) {
+        storeLittleEndian(entry, chunk.offset, 8);
+        storeLittleEndian(entry + 8, chunk.ciphertextSize, 4);
+        storeLittleEndian(entry + 12, chunk.plaintextSize, 4);
+        output.write((char*) entry, INDEX_ENTRY_SIZE);
+    }
+
+    storeLittleEndian(footer, position, 8);
+    storeLittleEndian(footer + 8, index.size(), 8);
+    memcpy(footer + 16, FOOTER_MAGIC, 8);
+    output.write((char*) footer, FOOTER_SIZE);
+    output.flush();
+
+    finished = true;
+}
+
+/**
+ * ContainerReader primary constructor, reads and checks the header, the footer, and the chunk index
+ *
+ * @param input a seekable std::istream holding a finished container
+ * @param aes the cipher the container was written with, it must outlive the reader
+ * @param pool the worker threads that decrypt one chunk each at a time in read()
+ *
+ * @throws std::invalid_argument if the stream is not a container, was written with a different key size, or is corrupt
+ */
+ContainerReader::ContainerReader(std::istream &input, const AES &aes, WorkerPool &pool) : Container(aes), input(input), pool(pool), plaintextSize(0) {
+    uint8_t header[HEADER_SIZE], footer[FOOTER_SIZE];
+    uint64_t total, indexOffset, nchunks, expected;
+    std::vector<uint8_t> entries;
+
+    input.clear();
+    input.seekg(0, std::ios::end);
+    total = input.tellg();
+    if (!input || total < HEADER_SIZE + FOOTER_SIZE)
+        throw std::invalid_argument("the stream is too short to be a container");
+
+    readExactly(0, header, HEADER_SIZE);
+    if (memcmp(header, HEADER_MAGIC, 4) || header[4] != VERSION || header[5] != CIPHER_AES)
+        throw std::invalid_argument("the stream is not a container this version can read");
+    if (header[6] != aes.getKeySize())
+        throw std::invalid_argument("the container was written with a different AES key size");
+
+    mode = (MODE) header[7];
+    chunkSize = loadLittleEndian(header + 8, 4);
+    memcpy(nonce, header + 16, 16);
+    checkParameters();
+
+    // the footer locates the index, which must fill the space between the last chunk and the footer exactly
+    readExactly(total - FOOTER_SIZE, footer, FOOTER_SIZE);
+    indexOffset = loadLittleEndian(footer, 8);
+    nchunks = loadLittleEndian(footer + 8, 8);
+    if (memcmp(footer + 16, FOOTER_MAGIC, 8) || indexOffset < HEADER_SIZE || indexOffset > total - FOOTER_SIZE
+            || (total - FOOTER_SIZE - indexOffset) % INDEX_ENTRY_SIZE || (total - FOOTER_SIZE - indexOffset) / INDEX_ENTRY_SIZE != nchunks)
+        throw std::invalid_argument("the container footer is corrupt");
+
+    entries.resize(nchunks * INDEX_ENTRY_SIZE);
+    readExactly(indexOffset, entries.data(), entries.size());
+
+    // chunks are stored back to back and every one but the last holds a full chunk of plaintext
+    expected = HEADER_SIZE;
+    index.resize(nchunks);
+    for (uint64_t i = 0; i < nchunks; i++) {
+        IndexEntry &chunk = index[i];
+
+        chunk.offset = loadLittleEndian(&entries[i * INDEX_ENTRY_SIZE], 8);
+        chunk.ciphertextSize = loadLittleEndian(&entries[i * INDEX_ENTRY_SIZE + 8], 4);
+        chunk.plaintextSize = loadLittleEndian(&entries[i * INDEX_ENTRY_SIZE + 12], 4);
+
+        if (chunk.offset != expected || chunk.ciphertextSize > getMaxChunkCiphertextSize() || chunk.plaintextSize == 0
+                || chunk.plaintextSize > chunkSize || (i + 1 < nchunks && chunk.plaintextSize != chunkSize))
+            throw std::invalid_argument("the container index is corrupt");
+
+        expected += chunk.ciphertextSize;
+        plaintextSize += chunk.plaintextSize;
+    }
+
+    if (expected != indexOffset)
+        throw std::invalid_argument("the container index is corrupt");
+}
+
+/**
+ * ContainerReader destructor
+ */
+ContainerReader::~ContainerReader() {
+
+}
+
+/**
+ * reads size bytes starting at offset from the container stream
+ *
+ * @param offset the position in the container of the first byte
+ * @param data room for size bytes
+ * @param size the number of bytes
+ *
+ * @throws std::invalid_argument if the stream ends early
+ */
+void ContainerReader::readExactly(uint64_t offset, uint8_t *data, size_t size) {
+    input.clear();
+    input.seekg(offset);
+    input.read((char*) data, size);
+    if ((size_t) input.gcount() != size)
+        throw std::invalid_argument("the container is truncated");
+}
+
+/**
+ * decrypts one chunk in place
+ *
+ * @param chunk the index of the chunk
+ * @param buffer the chunk's ciphertext, overwritten with its plaintext
+ *
+ * @return the number of plaintext bytes
+ *
+ * @throws std::invalid_argument if the chunk is damaged (a GCM tag mismatch or the wrong amount of plaintext)
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the chunk's mode of operation
+ */
+size_t ContainerReader::decryptChunk(uint64_t chunk, uint8_t *buffer) const {
+    ModeOfOperation *chunkMode = createMode(chunk);
+    size_t size;
+
+    try {
+        size = chunkMode->decrypt(buffer, index[chunk].ciphertextSize, buffer);
+    } catch (...) {
+        delete chunkMode;
+        throw;
+    }
+    delete chunkMode;
+
+    if (size != index[chunk].plaintextSize)
+        throw std::invalid_argument("container chunk is corrupt");
+
+    return size;
+}
+
+/**
+ * @return the number of chunks in the container
+ */
+uint64_t ContainerReader::getChunkCount() const {
+    return index.size();
+}
+
+/**
+ * @return the total number of plaintext bytes in the container
+ */
+uint64_t ContainerReader::getPlaintextSize() const {
+    return plaintextSize;
+}
+
+/**
+ * seeks to one chunk and decrypts only it, chunk i holds plaintext bytes [i * getChunkSize(), (i + 1) * getChunkSize())
+ * a damaged chunk throws without affecting any other chunk, so callers can skip it
+ *
+ * @param chunk the index of the chunk
+ * @param plaintext room for getChunkSize() bytes
+ *
+ * @return the number of plaintext bytes written, getChunkSize() for every chunk but the last
+ *
+ * @throws std::out_of_range if chunk is not less than getChunkCount()
+ * @throws std::invalid_argument if the chunk is damaged or the stream ends early
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+size_t ContainerReader::readChunk(uint64_t chunk, uint8_t *plaintext) {
+    uint8_t *buffer;
+    size_t size;
+
+    if (chunk >= index.size())
+        throw std::out_of_range("chunk is past the end of the container");
+
+    try {
+        buffer = new uint8_t[getMaxChunkCiphertextSize()];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    try {
+        readExactly(index[chunk].offset, buffer, index[chunk].ciphertextSize);
+        size = decryptChunk(chunk, buffer);
+    } catch (...) {
+        delete[] buffer;
+        throw;
+    }
+
+    memcpy(plaintext, buffer, size);
+    delete[] buffer;
+
+    return size;
+}
+
+/**
+ * decrypts the whole container to a stream, reading one chunk per thread at a time and decrypting them concurrently
+ *
+ * @param output std::ostream where the plaintext is written, in order
+ *
+ * @throws std::invalid_argument if a chunk is damaged or the stream ends early
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void ContainerReader::read(std::ostream &output) {
+    uint8_t *buffer;
+    uint64_t first, n, threads;
+
+    threads = pool.getThreadCount();
+    try {
+        buffer = new uint8_t[threads * getMaxChunkCiphertextSize()];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    try {
+        for (first = 0; first < index.size(); first += n) {
+            n = index.size() - first < threads ? index.size() - first : threads;
+
+            // the chunks of one round are contiguous in the container, so they are read at once and decrypted where they land
+            readExactly(index[first].offset, buffer, index[first + n - 1].offset + index[first + n - 1].ciphertextSize - index[first].offset);
+            pool.run(n, [&](size_t j) {
+                decryptChunk(first + j, buffer + (index[first + j].offset - index[first].offset));
+            });
+
+            for (uint64_t j = first; j < first + n; j++)
+                output.write((char*) buffer + (index[j].offset - index[first].offset), index[j].plaintextSize);
+        }
+    } catch (...) {
+        delete[] buffer;
+        throw;
+    }
+
+    delete[] buffer;
+}
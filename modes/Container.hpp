@@ -0,0 +1,133 @@
+/**
+ * header file for the chunked, seekable encrypted container format and its parallel writer and reader.
+ * @file Container.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYCONTAINER
+#define MYCONTAINER
+
+#include <istream>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "ModeOfOperation.hpp"
+#include "WorkerPool.hpp"
+#include "../ciphers/AES.hpp"
+#include "../padding/PKCS_5.hpp"
+
+/*
+ * container layout, every integer is little-endian:
+ *
+ *   header (32 bytes)  "ESPC", version, cipher (1 = AES), key size, mode, chunk size (4), reserved (4), nonce (16)
+ *   chunks             each chunk of plaintext encrypted on its own with iv = AES(nonce XOR chunk index)
+ *   index              per chunk: offset (8), ciphertext size (4), plaintext size (4)
+ *   footer (24 bytes)  index offset (8), chunk count (8), "ESPCINDX"
+ */
+class Container {
+public:
+    enum MODE : uint8_t {
+        MODE_CBC = 1,
+        MODE_CFB,
+        MODE_OFB,
+        MODE_CTR,
+        MODE_GCM
+    };
+
+    static constexpr size_t HEADER_SIZE = 32;
+    static constexpr size_t INDEX_ENTRY_SIZE = 16;
+    static constexpr size_t FOOTER_SIZE = 24;
+
+    // plaintext bytes per chunk, the unit of parallelism and of random access
+    static constexpr uint32_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+private:
+    Container();
+    Container(const Container &that) = delete;
+    Container& operator=(const Container &that) = delete;
+
+protected:
+    // where one chunk lives in the container
+    struct IndexEntry {
+        uint64_t offset;
+        uint32_t ciphertextSize;
+        uint32_t plaintextSize;
+    };
+
+    static constexpr uint8_t VERSION = 1;
+    static constexpr uint8_t CIPHER_AES = 1;
+
+    const AES &aes;
+    PKCS_5 padding;
+    MODE mode;
+    uint32_t chunkSize;
+    uint8_t nonce[16];
+
+    Container(const AES &aes);
+
+    void checkParameters() const;
+    ModeOfOperation* createMode(uint64_t chunk) const;
+    size_t getMaxChunkCiphertextSize() const;
+
+public:
+    virtual ~Container();
+    MODE getMode() const;
+    uint32_t getChunkSize() const;
+};
+
+class ContainerWriter : public Container {
+private:
+    std::ostream &output;
+    WorkerPool &pool;
+    uint8_t *plaintext;
+    uint8_t *ciphertext;
+    size_t nbuffered;
+    uint64_t position;
+    std::vector<IndexEntry> index;
+    bool finished;
+
+    ContainerWriter();
+    ContainerWriter(const ContainerWriter &that) = delete;
+    ContainerWriter& operator=(const ContainerWriter &that) = delete;
+
+    void flush();
+
+public:
+    ContainerWriter(std::ostream &output, const AES &aes, MODE mode, const uint8_t nonce[16], WorkerPool &pool, uint32_t chunkSize = DEFAULT_CHUNK_SIZE);
+    ~ContainerWriter();
+
+    void write(const uint8_t *data, size_t size);
+    void write(std::istream &input);
+    void finish();
+};
+
+class ContainerReader : public Container {
+private:
+    std::istream &input;
+    WorkerPool &pool;
+    std::vector<IndexEntry> index;
+    uint64_t plaintextSize;
+
+    ContainerReader();
+    ContainerReader(const ContainerReader &that) = delete;
+    ContainerReader& operator=(const ContainerReader &that) = delete;
+
+    void readExactly(uint64_t offset, uint8_t *data, size_t size);
+    size_t decryptChunk(uint64_t chunk, uint8_t *buffer) const;
+
+public:
+    ContainerReader(std::istream &input, const AES &aes, WorkerPool &pool);
+    ~ContainerReader();
+
+    uint64_t getChunkCount() const;
+    uint64_t getPlaintextSize() const;
+    size_t readChunk(uint64_t chunk, uint8_t *plaintext);
+    void read(std::ostream &output);
+};
+
+#endif
@@ -37,6 +37,7 @@ ECB::~ECB() {
 
 /**
  * takes data from a plaintext stream, applies padding, encrypts, and writes it to a ciphertext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
  *
  * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
  *
@@ -46,91 +47,142 @@ ECB::~ECB() {
  * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
  */
 void ECB::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
-    uint8_t blockSize, *buffer, nbytes, *padding;
+    processStream(plaintext, ciphertext, ENCRYPT);
+}
 
-    blockSize = blockCipher.getBlockSize();
-    try {
-        buffer = new uint8_t[blockSize];
-    } catch (std::bad_alloc &e) {
-        throw;
-    }
+/**
+ * takes data from a ciphertext stream, decrypts and strips padding, and writes it to a plaintext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ *
+ * @throws std::invalid_argument if the ciphertext is not a multiple of the block size or does not end in valid padding
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void ECB::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    processStream(ciphertext, plaintext, DECRYPT);
+}
 
-    // read first block of plaintext
-    plaintext.read((char*) buffer, blockSize);
-    nbytes = plaintext.gcount();
+/**
+ * pads and encrypts a contiguous buffer of plaintext without going through iostreams
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for getEncryptedSize(size) bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to getEncryptedSize(size)
+ */
+size_t ECB::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize, last[512];
+    size_t nblocks, padded;
 
-    while (plaintext.peek() != EOF) {
-        // encrypt plaintext block and write it to the output stream
-        blockCipher.encryptBlock(buffer, buffer);
-        ciphertext.write((char*) buffer, blockSize);
+    blockSize = blockCipher.getBlockSize();
 
-        // read next block of plaintext
-        plaintext.read((char*) buffer, blockSize);
-        nbytes = plaintext.gcount();
-    }
+    // encrypt every block before the final one
+    nblocks = size ? (size - 1) / blockSize : 0;
+    blockCipher.encryptBlocks(plaintext, ciphertext, nblocks);
 
     // the last bytes of plaintext may not be enough to fill a full block so we should add padding
     // depending on the padding scheme, an additional full block of padding may be needed
-    try {
-        padding = blockPadding.addPadding(buffer, nbytes);
-    } catch (std::bad_alloc &e) {
-        throw;
-    }
-    
-    // encrypt the plaintext block and write it to the output stream
-    blockCipher.encryptBlock(buffer, buffer);
-    ciphertext.write((char*) buffer, blockSize);
+    // an empty message has no last bytes to copy and may come with a null plaintext
+    if (size)
+        memcpy(last, plaintext + nblocks * blockSize, size - nblocks * blockSize);
+    padded = blockPadding.addPadding(last, size - nblocks * blockSize);
+    blockCipher.encryptBlocks(last, ciphertext + nblocks * blockSize, padded / blockSize);
 
-    // if the padding scheme required an additional full block of padding, encrypt it and write it to the output stream
-    if (padding) {
-        blockCipher.encryptBlock(padding, padding);
-        ciphertext.write((char*) padding, blockSize);
+    return nblocks * blockSize + padded;
+}
 
-        delete padding;
-    }
+/**
+ * decrypts and strips padding from a contiguous buffer of ciphertext without going through iostreams
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes, a multiple of the block size
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @return the number of plaintext bytes written after stripping padding
+ *
+ * @throws std::invalid_argument if size is not a multiple of the block size or the ciphertext does not end in valid padding
+ */
+size_t ECB::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+
+    if (size % blockSize)
+        throw std::invalid_argument("ciphertext size must be a multiple of blockSize");
+    if (size == 0)
+        return 0;
+
+    blockCipher.decryptBlocks(ciphertext, plaintext, size / blockSize);
 
-    delete buffer;
+    return getUnpaddedSize(plaintext, size);
 }
 
 /**
- * takes data from a ciphertext stream, decrypts and strips padding, and writes it to a plaintext stream 
+ * decrypts a run of blocks anywhere in the ciphertext, every block is independent of the others
  *
- * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ * @param ciphertext the start of the whole ciphertext
+ * @param firstBlock the index of the first block to decrypt
+ * @param nbytes the number of bytes to decrypt, a multiple of the block size
+ * @param plaintext room for nbytes, must not overlap ciphertext
+ */
+void ECB::decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+
+    blockCipher.decryptBlocks(ciphertext + firstBlock * blockSize, plaintext, nbytes / blockSize);
+}
+
+/**
+ * starts an incremental encryption/decryption of one message, for data that arrives in pieces
+ * the context keeps a reference to this ECB, which must outlive it
  *
- * @param ciphertext std::istream where data is retrieved for decryption
- * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
  *
- * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ * @return a heap allocated context ready for update(), the caller must delete it
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
  */
-void ECB::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
-    uint8_t blockSize, *buffer, padding;
+ModeContext* ECB::createContext(DIRECTION direction) const {
+    ModeContext *context;
 
-    blockSize = blockCipher.getBlockSize();
     try {
-        buffer = new uint8_t[blockSize];
+        context = new Context(*this, direction);
     } catch (std::bad_alloc &e) {
         throw;
     }
-    
-    // read first block of ciphertext
-    ciphertext.read((char*) buffer, blockSize);
 
-    while (ciphertext.peek() != EOF) {
-        // decrypt ciphertext block and write it to the output stream
-        blockCipher.decryptBlock(buffer, buffer);
-        plaintext.write((char*) buffer, blockSize);
+    return context;
+}
 
-        // read the next block of ciphertext
-        ciphertext.read((char*) buffer, blockSize);
-    }
+/**
+ * ECB::Context primary constructor
+ *
+ * @param ecb the mode of operation whose cipher and padding are used
+ * @param direction whether the context encrypts or decrypts
+ */
+ECB::Context::Context(const ECB &ecb, DIRECTION direction) : BlockContext(ecb, direction), ecb(ecb) {
+
+}
 
-    // decrypt ciphertext block
-    blockCipher.decryptBlock(buffer, buffer);
+/**
+ * ECB::Context destructor
+ */
+ECB::Context::~Context() {
 
-    // strip padding and write it to the output stream
-    padding = blockPadding.getPaddingAmount(buffer);
-    if (padding != blockSize)
-        plaintext.write((char*) buffer, blockSize - padding);
+}
 
-    delete buffer;
-}
\ No newline at end of file
+/**
+ * encrypts/decrypts whole blocks, each independently of the others
+ *
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+void ECB::Context::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    if (direction == ENCRYPT)
+        ecb.blockCipher.encryptBlocks(input, output, nblocks);
+    else
+        ecb.blockCipher.decryptBlocks(input, output, nblocks);
+}
@@ -21,6 +21,23 @@ private:
     ECB();
     ECB& operator=(const ECB &that) = delete;
 
+    class Context : public BlockContext {
+    private:
+        const ECB &ecb;
+
+        Context();
+
+    protected:
+        void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        Context(const ECB &ecb, DIRECTION direction);
+        ~Context();
+    };
+
+protected:
+    void decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const;
+
 public:
     ECB(const BlockCipher &blockCipher, const BlockPadding &blockPadding);
     ECB(const ECB &that);
@@ -28,6 +45,9 @@ public:
 
     void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
     void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    ModeContext* createContext(DIRECTION direction) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,562 @@
+/**
+ * class implementation for the GCM authenticated encryption mode of operation.
+ * @file GCM.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "GCM.hpp"
+
+/**
+ * GCM primary constructor, derives the pre-counter block J0 from the iv
+ * a 12 byte iv is used directly, any other length is hashed with GHASH first
+ * H and J0 come from the key at this point, so a GCM must be constructed again (or copied) after AES::setKey()
+ *
+ * algorithm described in the GCM specification, section 7.1: https://csrc.nist.gov/publications/detail/sp/800-38d/final
+ *
+ * @param blockCipher a reference to a BlockCipher with a 128 bit block that will be used to encrypt/decrypt and authenticate data
+ * @param iv the iv used during encryption/decryption, 12 bytes is recommended and must never repeat under one key
+ * @param ivSize the size of the iv
+ * @param tagSize the number of authentication tag bytes: 4, 8, or 12 to 16
+ *
+ * @throws std::invalid_argument if blockCipher does not have a 16 byte block, the iv is empty, or tagSize is not allowed
+ */
+GCM::GCM(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, uint8_t tagSize) : StreamModeOfOperation(blockCipher), ivSize(ivSize), tagSize(tagSize), ghash(blockCipher) {
+    if (ivSize == 0)
+        throw std::invalid_argument("iv must not be empty");
+    if (tagSize > 16 || (tagSize < 12 && tagSize != 8 && tagSize != 4))
+        throw std::invalid_argument("tagSize must be 4, 8, or 12 to 16 bytes");
+
+    for (int i = 0; i < ivSize; i++)
+        this->iv[i] = iv[i];
+
+    if (ivSize == 12) {
+        memcpy(j0, iv, 12);
+        j0[12] = 0;
+        j0[13] = 0;
+        j0[14] = 0;
+        j0[15] = 1;
+    } else {
+        memset(j0, 0, 16);
+        ghash.updatePadded(j0, iv, ivSize);
+        ghash.updateLengths(j0, 0, ivSize);
+    }
+}
+
+/**
+ * GCM copy constructor
+ *
+ * @param that reference to a preexisting GCM object that should be copied
+ */
+GCM::GCM(const GCM &that) : GCM(that.blockCipher, that.iv, that.ivSize, that.tagSize) {
+
+}
+
+/**
+ * GCM destructor
+ */
+GCM::~GCM() {
+
+}
+
+/**
+ * increments the last 32 bits of a counter block as a big-endian integer, the first 96 bits never change
+ *
+ * @param ctr the 16 byte counter block
+ */
+void GCM::incrementCounter(uint8_t ctr[16]) {
+    for (int i = 15; i >= 12; i--)
+        if (++ctr[i])
+            break;
+}
+
+/**
+ * the number of blocks before the last 32 bits of a counter block wrap around to 0
+ *
+ * @param ctr the 16 byte counter block
+ *
+ * @return between 1 and 2^32 blocks
+ */
+uint64_t GCM::blocksBeforeWrap(const uint8_t ctr[16]) {
+    return (1ULL << 32) - ((uint32_t) ctr[12] << 24 | (uint32_t) ctr[13] << 16 | (uint32_t) ctr[14] << 8 | ctr[15]);
+}
+
+/**
+ * lays out one counter block per block, incrementing by 1 each time, and encrypts them with one call to the block cipher
+ * the counters come from BlockOps::generateCounters(), which carries into the first 96 bits, so the runs are split
+ * where the last 32 bits wrap and the first 96 bits are put back after each one
+ *
+ * @param ctr the counter of the first block, advanced past the last block on return
+ * @param keystream room for nblocks blocks of keystream
+ * @param nblocks the number of keystream blocks to generate
+ */
+void GCM::generateKeystream(uint8_t ctr[16], uint8_t *keystream, size_t nblocks) const {
+    uint8_t fixed[12];
+    size_t n;
+
+    memcpy(fixed, ctr, 12);
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < blocksBeforeWrap(ctr) ? nblocks - b : blocksBeforeWrap(ctr);
+
+        BlockOps::generateCounters(ctr, keystream + b * 16, n);
+        memcpy(ctr, fixed, 12);
+    }
+
+    blockCipher.encryptBlocks(keystream, keystream, nblocks);
+}
+
+/**
+ * counter mode over whole blocks, in the kernel for the cipher when there is one, so the counters, the cipher,
+ * and the XOR are a single pass, the runs are split where the last 32 bits of the counter wrap as in generateKeystream()
+ *
+ * @param ctr the counter of the first block, advanced past the last block on return
+ * @param input nblocks blocks of plaintext/ciphertext
+ * @param output room for nblocks blocks, may be the same buffer as input
+ * @param nblocks the number of blocks
+ */
+void GCM::cryptBlocks(uint8_t ctr[16], const uint8_t *input, uint8_t *output, size_t nblocks) const {
+    uint8_t keystream[BATCH_BLOCKS * 16], fixed[12];
+    size_t n;
+
+    if (!kernel) {
+        for (size_t b = 0; b < nblocks; b += n) {
+            n = nblocks - b < BATCH_BLOCKS ? nblocks - b : BATCH_BLOCKS;
+
+            generateKeystream(ctr, keystream, n);
+            xorBytes(output + b * 16, input + b * 16, keystream, n * 16);
+        }
+        return;
+    }
+
+    memcpy(fixed, ctr, 12);
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < blocksBeforeWrap(ctr) ? nblocks - b : blocksBeforeWrap(ctr);
+
+        kernel->ctr(ctr, input + b * 16, output + b * 16, n);
+        memcpy(ctr, fixed, 12);
+    }
+}
+
+/**
+ * the single pass over the data: [ModeOfOperation::BATCH_BLOCKS] blocks of counter mode at a time, each chunk of
+ * ciphertext hashed while it is still in cache, the ciphertext is hashed before decryption overwrites it
+ *
+ * @param ctr the counter of the first block, advanced past the last block on return
+ * @param input size bytes of plaintext/ciphertext
+ * @param size the number of bytes, only the end of the data may be a partial block
+ * @param output room for size bytes, may be the same buffer as input
+ * @param state the running GHASH, already covering the aad
+ * @param encrypting whether output (encryption) or input (decryption) is the ciphertext
+ */
+void GCM::crypt(uint8_t ctr[16], const uint8_t *input, size_t size, uint8_t *output, uint8_t state[16], bool encrypting) const {
+    uint8_t keystream[16];
+    size_t n, whole;
+
+    for (size_t offset = 0; offset < size; offset += n) {
+        n = size - offset < BATCH_BLOCKS * 16 ? size - offset : BATCH_BLOCKS * 16;
+        whole = n & ~(size_t) 15;
+
+        if (!encrypting)
+            ghash.updatePadded(state, input + offset, n);
+        cryptBlocks(ctr, input + offset, output + offset, whole / 16);
+        if (whole < n) {
+            generateKeystream(ctr, keystream, 1);
+            xorBytes(output + offset + whole, input + offset + whole, keystream, n - whole);
+        }
+        if (encrypting)
+            ghash.updatePadded(state, output + offset, n);
+    }
+}
+
+/**
+ * finishes GHASH with the length block and masks it with E(K, J0)
+ *
+ * @param state the running GHASH over the aad and ciphertext, consumed
+ * @param aadSize the number of aad bytes
+ * @param textSize the number of ciphertext bytes
+ * @param tag room for the full 16 byte tag, callers use its first tagSize bytes
+ */
+void GCM::computeTag(uint8_t state[16], uint64_t aadSize, uint64_t textSize, uint8_t tag[16]) const {
+    uint8_t mask[16];
+
+    ghash.updateLengths(state, aadSize, textSize);
+    blockCipher.encryptBlock(j0, mask);
+    xorBytes(tag, state, mask, 16);
+}
+
+/**
+ * encrypts and authenticates a buffer of plaintext together with associated data that is authenticated but not encrypted
+ *
+ * algorithm described in the GCM specification, section 7.1: https://csrc.nist.gov/publications/detail/sp/800-38d/final
+ *
+ * @param aad aadSize bytes of associated data, may be null if aadSize is 0
+ * @param aadSize the number of associated data bytes
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ * @param tag room for getTagSize() bytes of authentication tag
+ *
+ * @throws std::out_of_range if size is larger than MAX_TEXT_SIZE
+ */
+void GCM::encrypt(const uint8_t *aad, size_t aadSize, const uint8_t *plaintext, size_t size, uint8_t *ciphertext, uint8_t tag[]) const {
+    uint8_t ctr[16], state[16] = {0}, fullTag[16];
+
+    if (size > MAX_TEXT_SIZE)
+        throw std::out_of_range("GCM can encrypt at most 2^32 - 2 blocks under one iv");
+
+    ghash.updatePadded(state, aad, aadSize);
+
+    memcpy(ctr, j0, 16);
+    incrementCounter(ctr);
+    crypt(ctr, plaintext, size, ciphertext, state, true);
+
+    computeTag(state, aadSize, size, fullTag);
+    memcpy(tag, fullTag, tagSize);
+}
+
+/**
+ * verifies and decrypts a buffer of ciphertext and its associated data
+ * the tag is compared in constant time, on a mismatch the plaintext buffer is zeroed so unauthenticated data never escapes
+ *
+ * @param aad aadSize bytes of associated data, may be null if aadSize is 0
+ * @param aadSize the number of associated data bytes
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes
+ * @param tag the getTagSize() byte authentication tag produced by encrypt()
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @return true if the tag matched, false if the ciphertext, aad, or tag was modified
+ *
+ * @throws std::out_of_range if size is larger than MAX_TEXT_SIZE
+ */
+bool GCM::decrypt(const uint8_t *aad, size_t aadSize, const uint8_t *ciphertext, size_t size, const uint8_t tag[], uint8_t *plaintext) const {
+    uint8_t ctr[16], state[16] = {0}, fullTag[16], diff = 0;
+
+    if (size > MAX_TEXT_SIZE)
+        throw std::out_of_range("GCM can decrypt at most 2^32 - 2 blocks under one iv");
+
+    ghash.updatePadded(state, aad, aadSize);
+
+    memcpy(ctr, j0, 16);
+    incrementCounter(ctr);
+    crypt(ctr, ciphertext, size, plaintext, state, false);
+
+    computeTag(state, aadSize, size, fullTag);
+    for (uint8_t i = 0; i < tagSize; i++)
+        diff |= fullTag[i] ^ tag[i];
+
+    if (diff) {
+        memset(plaintext, 0, size);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * takes data from a plaintext stream, encrypts it, and writes it followed by the tag to a ciphertext stream
+ *
+ * @param plaintext std::istream where data is retrieved for encryption
+ * @param ciphertext std::ostream where data is sent after encrypting, getTagSize() bytes longer than the plaintext
+ *
+ * @throws std::out_of_range if the plaintext is longer than MAX_TEXT_SIZE
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void GCM::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
+    processStream(plaintext, ciphertext, ENCRYPT);
+}
+
+/**
+ * takes ciphertext followed by its tag from a stream, decrypts, and writes it to a plaintext stream
+ * plaintext is written as it is decrypted, before the tag at the end of the stream has been checked,
+ * so the output must be discarded if this throws
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting
+ *
+ * @throws std::invalid_argument if the stream is shorter than the tag or the tag does not match
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void GCM::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    processStream(ciphertext, plaintext, DECRYPT);
+}
+
+/**
+ * encrypts a contiguous buffer of plaintext with no associated data and appends the tag
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for getEncryptedSize(size) bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to size + getTagSize()
+ *
+ * @throws std::out_of_range if size is larger than MAX_TEXT_SIZE
+ */
+size_t GCM::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    encrypt(nullptr, 0, plaintext, size, ciphertext, ciphertext + size);
+
+    return size + tagSize;
+}
+
+/**
+ * verifies and decrypts a contiguous buffer of ciphertext with no associated data whose last getTagSize() bytes are the tag
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes, including the tag
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @return the number of plaintext bytes written, equal to size - getTagSize()
+ *
+ * @throws std::invalid_argument if size is smaller than the tag or the tag does not match
+ * @throws std::out_of_range if size is larger than MAX_TEXT_SIZE
+ */
+size_t GCM::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t tag[16];
+
+    if (size < tagSize)
+        throw std::invalid_argument("ciphertext is shorter than the tag");
+
+    size -= tagSize;
+    memcpy(tag, ciphertext + size, tagSize);
+    if (!decrypt(nullptr, 0, ciphertext, size, tag, plaintext))
+        throw std::invalid_argument("authentication tag mismatch");
+
+    return size;
+}
+
+/**
+ * @param plaintextSize the number of plaintext bytes to encrypt
+ *
+ * @return plaintextSize + getTagSize(), the tag follows the ciphertext
+ */
+size_t GCM::getEncryptedSize(size_t plaintextSize) const {
+    return plaintextSize + tagSize;
+}
+
+/**
+ * @return the number of authentication tag bytes
+ */
+uint8_t GCM::getTagSize() const {
+    return tagSize;
+}
+
+/**
+ * starts an incremental encryption/decryption of one message with no associated data
+ * the context keeps a reference to this GCM, which must outlive it
+ *
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
+ *
+ * @return a heap allocated context ready for update(), the caller must delete it
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
+ */
+ModeContext* GCM::createContext(DIRECTION direction) const {
+    return createContext(direction, nullptr, 0);
+}
+
+/**
+ * starts an incremental encryption/decryption of one message, authenticating the given associated data
+ * encryption writes the tag in final(), decryption holds the last getTagSize() bytes back and checks them in final()
+ *
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
+ * @param aad aadSize bytes of associated data, hashed once and reused by every message of the context
+ * @param aadSize the number of associated data bytes
+ *
+ * @return a heap allocated context ready for update(), the caller must delete it
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
+ */
+ModeContext* GCM::createContext(DIRECTION direction, const uint8_t *aad, size_t aadSize) const {
+    ModeContext *context;
+
+    try {
+        context = new Context(*this, direction, aad, aadSize);
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    return context;
+}
+
+/**
+ * GCM::Context primary constructor
+ *
+ * @param gcm the mode of operation whose cipher, iv, and hash subkey are used
+ * @param direction whether the context encrypts or decrypts
+ * @param aad aadSize bytes of associated data
+ * @param aadSize the number of associated data bytes
+ */
+GCM::Context::Context(const GCM &gcm, DIRECTION direction, const uint8_t *aad, size_t aadSize) : StreamContext(gcm, direction), gcm(gcm), aadSize(aadSize) {
+    memset(aadState, 0, 16);
+    gcm.ghash.updatePadded(aadState, aad, aadSize);
+
+    init();
+}
+
+/**
+ * GCM::Context destructor
+ */
+GCM::Context::~Context() {
+
+}
+
+/**
+ * restarts the counter from J0 + 1 and the hash from the associated data
+ */
+void GCM::Context::init() {
+    StreamContext::init();
+    memcpy(counter, gcm.j0, 16);
+    incrementCounter(counter);
+    memcpy(state, aadState, 16);
+    textSize = 0;
+    nheld = 0;
+}
+
+/**
+ * encrypts the current counter block and increments it
+ */
+void GCM::Context::nextKeystream() {
+    memcpy(keystream, counter, 16);
+    incrementCounter(counter);
+    gcm.blockCipher.encryptBlock(keystream, keystream);
+}
+
+/**
+ * collects ciphertext bytes of a partial block, hashing the block once it is complete
+ *
+ * @param ciphertext n bytes of ciphertext
+ * @param offset the position of the first byte within its block
+ * @param n the number of bytes
+ */
+void GCM::Context::absorb(const uint8_t *ciphertext, size_t offset, size_t n) {
+    // an empty update may pass a null ciphertext
+    if (n)
+        memcpy(partial + offset, ciphertext, n);
+    textSize += n;
+    if (offset + n == 16)
+        gcm.ghash.update(state, partial, 1);
+}
+
+/**
+ * encrypts/decrypts and hashes whole blocks, [ModeOfOperation::BATCH_BLOCKS] blocks at a time so each run is hashed
+ * while it is still in cache
+ *
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks, must not overlap input
+ * @param nblocks the number of blocks
+ */
+void GCM::Context::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    size_t n;
+
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < BATCH_BLOCKS ? nblocks - b : BATCH_BLOCKS;
+
+        gcm.cryptBlocks(counter, input + b * 16, output + b * 16, n);
+        gcm.ghash.update(state, direction == ENCRYPT ? output + b * 16 : input + b * 16, n);
+    }
+
+    textSize += nblocks * 16;
+}
+
+/**
+ * encrypts every byte immediately, decryption holds back the last getTagSize() bytes seen so far since they may be the tag
+ *
+ * @param input size bytes of the message
+ * @param size the number of input bytes, may be 0
+ * @param output room for getUpdateSize(size) bytes, must not overlap input
+ *
+ * @return the number of bytes written to output
+ *
+ * @throws std::out_of_range if the message grows beyond MAX_TEXT_SIZE
+ */
+size_t GCM::Context::update(const uint8_t *input, size_t size, uint8_t *output) {
+    uint8_t tail[16];
+    size_t total, release, fromHeld, fromInput, written;
+
+    if (textSize + size > MAX_TEXT_SIZE + (direction == DECRYPT ? gcm.tagSize : 0))
+        throw std::out_of_range("GCM can encrypt at most 2^32 - 2 blocks under one iv");
+
+    if (direction == ENCRYPT)
+        return StreamContext::update(input, size, output);
+
+    total = nheld + size;
+    if (total <= gcm.tagSize) {
+        if (size)
+            memcpy(held + nheld, input, size);
+        nheld += size;
+        return 0;
+    }
+
+    // everything but the last tagSize bytes is known to be ciphertext, the held back bytes come first
+    release = total - gcm.tagSize;
+    fromHeld = release < nheld ? release : nheld;
+    fromInput = release - fromHeld;
+    written = StreamContext::update(held, fromHeld, output);
+    written += StreamContext::update(input, fromInput, output + fromHeld);
+
+    memcpy(tail, held + fromHeld, nheld - fromHeld);
+    memcpy(tail + nheld - fromHeld, input + fromInput, size - fromInput);
+    memcpy(held, tail, gcm.tagSize);
+    nheld = gcm.tagSize;
+
+    return written;
+}
+
+/**
+ * writes the tag after encrypting, or checks the held back tag after decrypting, then readies the context for a new message
+ *
+ * @param output room for getFinalSize() bytes
+ *
+ * @return the number of bytes written to output, getTagSize() when encrypting and 0 when decrypting
+ *
+ * @throws std::invalid_argument if decrypting and the message was shorter than the tag or the tag does not match
+ */
+size_t GCM::Context::final(uint8_t *output) {
+    uint8_t tag[16], diff = 0;
+    size_t written = 0;
+
+    if (direction == DECRYPT && nheld != gcm.tagSize) {
+        init();
+        throw std::invalid_argument("ciphertext is shorter than the tag");
+    }
+
+    // hash the final partial block padded with zeros
+    if (textSize % 16) {
+        memset(partial + textSize % 16, 0, 16 - textSize % 16);
+        gcm.ghash.update(state, partial, 1);
+    }
+    gcm.computeTag(state, aadSize, textSize, tag);
+
+    if (direction == ENCRYPT) {
+        memcpy(output, tag, gcm.tagSize);
+        written = gcm.tagSize;
+    } else {
+        for (uint8_t i = 0; i < gcm.tagSize; i++)
+            diff |= tag[i] ^ held[i];
+    }
+
+    init();
+    if (diff)
+        throw std::invalid_argument("authentication tag mismatch");
+
+    return written;
+}
+
+/**
+ * @param size the number of bytes about to be passed to update()
+ *
+ * @return the exact number of bytes update() will write
+ */
+size_t GCM::Context::getUpdateSize(size_t size) const {
+    if (direction == ENCRYPT)
+        return size;
+
+    return nheld + size > gcm.tagSize ? nheld + size - gcm.tagSize : 0;
+}
+
+/**
+ * @return the number of bytes final() writes, the tag when encrypting and nothing when decrypting
+ */
+size_t GCM::Context::getFinalSize() const {
+    return direction == ENCRYPT ? gcm.tagSize : 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * header file for the GCM authenticated encryption mode of operation.
+ * @file GCM.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYGCM
+#define MYGCM
+
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include "ModeOfOperation.hpp"
+#include "GHASH.hpp"
+#include "../ciphers/BlockCipher.hpp"
+
+class GCM : public StreamModeOfOperation {
+private:
+    GCM();
+    GCM& operator=(const GCM &that) = delete;
+
+protected:
+    uint8_t iv[256];
+    uint8_t ivSize;
+    uint8_t tagSize;
+    GHASH ghash;
+
+    // the pre-counter block J0, E(K, J0) masks the tag and the keystream starts at J0 + 1
+    uint8_t j0[16];
+
+    static void incrementCounter(uint8_t ctr[16]);
+    static uint64_t blocksBeforeWrap(const uint8_t ctr[16]);
+    void generateKeystream(uint8_t ctr[16], uint8_t *keystream, size_t nblocks) const;
+    void cryptBlocks(uint8_t ctr[16], const uint8_t *input, uint8_t *output, size_t nblocks) const;
+    void crypt(uint8_t ctr[16], const uint8_t *input, size_t size, uint8_t *output, uint8_t state[16], bool encrypting) const;
+    void computeTag(uint8_t state[16], uint64_t aadSize, uint64_t textSize, uint8_t tag[16]) const;
+
+    class Context : public StreamContext {
+    private:
+        const GCM &gcm;
+        uint8_t counter[16];
+        uint8_t aadState[16];
+        uint64_t aadSize;
+        uint8_t state[16];
+        uint8_t partial[16];
+        uint64_t textSize;
+        uint8_t held[16];
+        size_t nheld;
+
+        Context();
+
+    protected:
+        void nextKeystream();
+        void absorb(const uint8_t *ciphertext, size_t offset, size_t n);
+        void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        Context(const GCM &gcm, DIRECTION direction, const uint8_t *aad, size_t aadSize);
+        ~Context();
+        void init();
+        size_t update(const uint8_t *input, size_t size, uint8_t *output);
+        size_t final(uint8_t *output);
+        size_t getUpdateSize(size_t size) const;
+        size_t getFinalSize() const;
+    };
+
+public:
+    // the largest plaintext GCM can encrypt under one iv, 2^32 - 2 blocks
+    static constexpr uint64_t MAX_TEXT_SIZE = ((1ULL << 32) - 2) * 16;
+
+    GCM(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, uint8_t tagSize = 16);
+    GCM(const GCM &that);
+    ~GCM();
+
+    void encrypt(const uint8_t *aad, size_t aadSize, const uint8_t *plaintext, size_t size, uint8_t *ciphertext, uint8_t tag[]) const;
+    bool decrypt(const uint8_t *aad, size_t aadSize, const uint8_t *ciphertext, size_t size, const uint8_t tag[], uint8_t *plaintext) const;
+
+    void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
+    void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    size_t getEncryptedSize(size_t plaintextSize) const;
+    ModeContext* createContext(DIRECTION direction) const;
+    ModeContext* createContext(DIRECTION direction, const uint8_t *aad, size_t aadSize) const;
+    uint8_t getTagSize() const;
+};
+
+#endif
@@ -0,0 +1,372 @@
+/**
+ * class implementation for the GHASH universal hash used by the GCM mode of operation.
+ * @file GHASH.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "GHASH.hpp"
+#include "../ciphers/CPUFeatures.hpp"
+
+// reduction of the 4 bits shifted out of the low end, multiplied by the GCM polynomial x^128 + x^7 + x^2 + x + 1
+static const uint64_t LAST4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/**
+ * reads 8 bytes as a big-endian integer
+ *
+ * @param bytes the 8 bytes
+ *
+ * @return the integer
+ */
+static uint64_t loadBigEndian(const uint8_t bytes[]) {
+    uint64_t value = 0;
+
+    for (int i = 0; i < 8; i++)
+        value = (value << 8) | bytes[i];
+
+    return value;
+}
+
+/**
+ * writes an integer as 8 big-endian bytes
+ *
+ * @param bytes room for 8 bytes
+ * @param value the integer
+ */
+static void storeBigEndian(uint8_t bytes[], uint64_t value) {
+    for (int i = 7; i >= 0; i--, value >>= 8)
+        bytes[i] = value;
+}
+
+/**
+ * GHASH primary constructor, derives the hash subkey H = E(K, 0^128) and precomputes the multiplication tables
+ * they are not updated if the block cipher is rekeyed afterwards (AES::setKey()), construct a new GHASH instead
+ *
+ * @param blockCipher a reference to a BlockCipher with a 128 bit block, keyed with the GCM key
+ * @param useClmul whether to use the PCLMULQDQ instruction when the CPU has it, false forces the portable tables
+ *
+ * @throws std::invalid_argument if the blockCipher's block size is not 16 bytes
+ */
+GHASH::GHASH(const BlockCipher &blockCipher, bool useClmul) : blockCipher(blockCipher), clmul(useClmul && CPUFeatures::hasPCLMULQDQ() && CPUFeatures::hasSSSE3()) {
+    uint8_t h[16] = {0};
+
+    if (blockCipher.getBlockSize() != BLOCK_SIZE)
+        throw std::invalid_argument("GHASH requires a block cipher with a 16 byte block");
+
+    blockCipher.encryptBlock(h, h);
+    generateTables(h);
+    if (clmul)
+        generatePowers(h);
+    BlockCipher::wipe(h, sizeof(h));
+}
+
+/**
+ * GHASH copy constructor
+ *
+ * @param that reference to a preexisting GHASH object that should be copied
+ */
+GHASH::GHASH(const GHASH &that) : GHASH(that.blockCipher, that.clmul) {
+
+}
+
+/**
+ * GHASH destructor
+ */
+GHASH::~GHASH() {
+    // H comes from the cipher key, so it is key material
+    BlockCipher::wipe(hh, sizeof(hh));
+    BlockCipher::wipe(hl, sizeof(hl));
+    BlockCipher::wipe(hPowers, sizeof(hPowers));
+}
+
+/**
+ * @return true if update() runs on the PCLMULQDQ instruction rather than the portable tables
+ */
+bool GHASH::usesClmul() const {
+    return clmul;
+}
+
+/**
+ * folds whole blocks into a running hash: state = (state XOR block) * H for every block
+ *
+ * @param state the 16 byte running hash, all zero at the start of a message
+ * @param data nblocks * 16 bytes to hash
+ * @param nblocks the number of blocks
+ */
+void GHASH::update(uint8_t state[16], const uint8_t *data, size_t nblocks) const {
+    if (clmul)
+        updateClmul(state, data, nblocks);
+    else
+        updateTable(state, data, nblocks);
+}
+
+/**
+ * hashes data of any length, zero padding the final partial block as GCM does for the aad and the ciphertext
+ *
+ * @param state the 16 byte running hash
+ * @param data size bytes to hash
+ * @param size the number of bytes
+ */
+void GHASH::updatePadded(uint8_t state[16], const uint8_t *data, size_t size) const {
+    uint8_t last[16] = {0};
+    size_t nblocks = size / BLOCK_SIZE;
+
+    update(state, data, nblocks);
+    if (size % BLOCK_SIZE) {
+        memcpy(last, data + nblocks * BLOCK_SIZE, size % BLOCK_SIZE);
+        update(state, last, 1);
+    }
+}
+
+/**
+ * hashes the closing block of GCM: the bit lengths of the aad and of the ciphertext as 64 bit big-endian integers
+ *
+ * @param state the 16 byte running hash
+ * @param aadSize the number of aad bytes
+ * @param textSize the number of plaintext/ciphertext bytes
+ */
+void GHASH::updateLengths(uint8_t state[16], uint64_t aadSize, uint64_t textSize) const {
+    uint8_t lengths[16];
+
+    storeBigEndian(lengths, aadSize * 8);
+    storeBigEndian(lengths + 8, textSize * 8);
+    update(state, lengths, 1);
+}
+
+/**
+ * fills the 4 bit tables with every multiple i * H, i = 0..15, in GCM's reflected bit order
+ * H * x^k for k = 1, 2, 3 is a right shift with reduction, every other entry is an XOR of those
+ *
+ * algorithm described in the GCM specification, section 4.1: https://csrc.nist.gov/publications/detail/sp/800-38d/final
+ *
+ * @param h the hash subkey
+ */
+void GHASH::generateTables(const uint8_t h[16]) {
+    uint64_t vh, vl, reduce;
+
+    vh = loadBigEndian(h);
+    vl = loadBigEndian(h + 8);
+
+    hh[0] = 0;
+    hl[0] = 0;
+    hh[8] = vh;
+    hl[8] = vl;
+
+    for (int i = 4; i > 0; i >>= 1) {
+        reduce = (vl & 1) * 0xe100000000000000ULL;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ reduce;
+        hh[i] = vh;
+        hl[i] = vl;
+    }
+
+    for (int i = 2; i <= 8; i *= 2) {
+        for (int j = 1; j < i; j++) {
+            hh[i + j] = hh[i] ^ hh[j];
+            hl[i + j] = hl[i] ^ hl[j];
+        }
+    }
+}
+
+/**
+ * portable GHASH, multiplies by H 4 bits at a time using the precomputed tables
+ * the table index depends on the data, so unlike the PCLMULQDQ path this is not constant-time
+ *
+ * @param state the 16 byte running hash
+ * @param data nblocks * 16 bytes to hash
+ * @param nblocks the number of blocks
+ */
+void GHASH::updateTable(uint8_t state[16], const uint8_t *data, size_t nblocks) const {
+    uint8_t x[16], rem, nibble;
+    uint64_t zh, zl;
+
+    for (size_t b = 0; b < nblocks; b++) {
+        for (int i = 0; i < 16; i++)
+            x[i] = state[i] ^ data[b * 16 + i];
+
+        nibble = x[15] & 0xf;
+        zh = hh[nibble];
+        zl = hl[nibble];
+
+        // Horner's rule from the last nibble to the first, multiplying by x^4 between nibbles
+        for (int i = 15; i >= 0; i--) {
+            if (i != 15) {
+                nibble = x[i] & 0xf;
+                rem = zl & 0xf;
+                zl = (zh << 60) | (zl >> 4);
+                zh = (zh >> 4) ^ (LAST4[rem] << 48);
+                zh ^= hh[nibble];
+                zl ^= hl[nibble];
+            }
+
+            nibble = x[i] >> 4;
+            rem = zl & 0xf;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (LAST4[rem] << 48);
+            zh ^= hh[nibble];
+            zl ^= hl[nibble];
+        }
+
+        storeBigEndian(state, zh);
+        storeBigEndian(state + 8, zl);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// the carry-less multiply intrinsics are compiled for this file's functions only so the rest of the library stays portable
+#define CLMUL_TARGET __attribute__((target("pclmul,ssse3,sse2")))
+
+/**
+ * multiplies two field elements without reducing, in the byte reversed representation
+ * the 256 bit product is returned as its low and high halves, still to be shifted left by one bit
+ *
+ * algorithm described at: https://www.intel.com/content/dam/develop/external/us/en/documents/clmul-wp-rev-2-02-2014-04-20.pdf
+ *
+ * @param a the first factor
+ * @param b the second factor
+ * @param lo the low 128 bits of the product
+ * @param hi the high 128 bits of the product
+ */
+CLMUL_TARGET static inline void multiply(__m128i a, __m128i b, __m128i &lo, __m128i &hi) {
+    __m128i mid;
+
+    lo = _mm_clmulepi64_si128(a, b, 0x00);
+    hi = _mm_clmulepi64_si128(a, b, 0x11);
+    mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+}
+
+/**
+ * reduces a 256 bit product modulo the GCM polynomial
+ * the one bit left shift that corrects for GCM's reflected bit order is linear, so it is applied here
+ * once for a whole sum of products rather than once per product
+ *
+ * @param lo the low 128 bits of the product
+ * @param hi the high 128 bits of the product
+ *
+ * @return the reduced product
+ */
+CLMUL_TARGET static inline __m128i reduce(__m128i lo, __m128i hi) {
+    __m128i carryLo, carryHi, carryMid, t1, t2, t3;
+
+    // shift the 256 bit value left by one bit
+    carryLo = _mm_srli_epi32(lo, 31);
+    carryHi = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    carryMid = _mm_srli_si128(carryLo, 12);
+    carryHi = _mm_slli_si128(carryHi, 4);
+    carryLo = _mm_slli_si128(carryLo, 4);
+    lo = _mm_or_si128(lo, carryLo);
+    hi = _mm_or_si128(hi, carryHi);
+    hi = _mm_or_si128(hi, carryMid);
+
+    // first phase of the reduction
+    t1 = _mm_slli_epi32(lo, 31);
+    t2 = _mm_slli_epi32(lo, 30);
+    t3 = _mm_slli_epi32(lo, 25);
+    t1 = _mm_xor_si128(t1, t2);
+    t1 = _mm_xor_si128(t1, t3);
+    t2 = _mm_srli_si128(t1, 4);
+    t1 = _mm_slli_si128(t1, 12);
+    lo = _mm_xor_si128(lo, t1);
+
+    // second phase of the reduction
+    t1 = _mm_srli_epi32(lo, 1);
+    t3 = _mm_srli_epi32(lo, 2);
+    t1 = _mm_xor_si128(t1, t3);
+    t3 = _mm_srli_epi32(lo, 7);
+    t1 = _mm_xor_si128(t1, t3);
+    t1 = _mm_xor_si128(t1, t2);
+    lo = _mm_xor_si128(lo, t1);
+
+    return _mm_xor_si128(hi, lo);
+}
+
+/**
+ * @return the shuffle mask that reverses the 16 bytes of a register
+ */
+CLMUL_TARGET static inline __m128i byteReverseMask() {
+    return _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+}
+
+/**
+ * computes H, H^2, H^3, and H^4 so that 4 blocks can be multiplied by their power of H and reduced together
+ *
+ * @param h the hash subkey
+ */
+CLMUL_TARGET void GHASH::generatePowers(const uint8_t h[16]) {
+    __m128i mask, power[4], lo, hi;
+
+    mask = byteReverseMask();
+    power[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) h), mask);
+    for (int i = 1; i < 4; i++) {
+        multiply(power[i - 1], power[0], lo, hi);
+        power[i] = reduce(lo, hi);
+    }
+
+    for (int i = 0; i < 4; i++)
+        _mm_store_si128((__m128i*) hPowers[i], power[i]);
+}
+
+/**
+ * GHASH on the PCLMULQDQ instruction: 4 blocks at a time are multiplied by H^4, H^3, H^2, and H
+ * and their products summed before a single reduction (aggregated reduction)
+ *
+ * @param state the 16 byte running hash
+ * @param data nblocks * 16 bytes to hash
+ * @param nblocks the number of blocks
+ */
+CLMUL_TARGET void GHASH::updateClmul(uint8_t state[16], const uint8_t *data, size_t nblocks) const {
+    const __m128i *in = (const __m128i*) data;
+    __m128i mask, y, h1, h2, h3, h4, lo, hi, plo, phi;
+
+    mask = byteReverseMask();
+    y = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) state), mask);
+    h1 = _mm_load_si128((const __m128i*) hPowers[0]);
+    h2 = _mm_load_si128((const __m128i*) hPowers[1]);
+    h3 = _mm_load_si128((const __m128i*) hPowers[2]);
+    h4 = _mm_load_si128((const __m128i*) hPowers[3]);
+
+    for (; nblocks >= 4; nblocks -= 4, in += 4) {
+        // ((((y + x0) H + x1) H + x2) H + x3) H = (y + x0) H^4 + x1 H^3 + x2 H^2 + x3 H
+        multiply(_mm_xor_si128(y, _mm_shuffle_epi8(_mm_loadu_si128(in), mask)), h4, lo, hi);
+        multiply(_mm_shuffle_epi8(_mm_loadu_si128(in + 1), mask), h3, plo, phi);
+        lo = _mm_xor_si128(lo, plo);
+        hi = _mm_xor_si128(hi, phi);
+        multiply(_mm_shuffle_epi8(_mm_loadu_si128(in + 2), mask), h2, plo, phi);
+        lo = _mm_xor_si128(lo, plo);
+        hi = _mm_xor_si128(hi, phi);
+        multiply(_mm_shuffle_epi8(_mm_loadu_si128(in + 3), mask), h1, plo, phi);
+        lo = _mm_xor_si128(lo, plo);
+        hi = _mm_xor_si128(hi, phi);
+
+        y = reduce(lo, hi);
+    }
+
+    for (; nblocks > 0; nblocks--, in++) {
+        multiply(_mm_xor_si128(y, _mm_shuffle_epi8(_mm_loadu_si128(in), mask)), h1, lo, hi);
+        y = reduce(lo, hi);
+    }
+
+    _mm_storeu_si128((__m128i*) state, _mm_shuffle_epi8(y, mask));
+}
+
+#else
+
+void GHASH::generatePowers(const uint8_t[16]) {
+
+}
+
+void GHASH::updateClmul(uint8_t[16], const uint8_t *, size_t) const {
+
+}
+
+#endif
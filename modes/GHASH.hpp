@@ -0,0 +1,51 @@
+/**
+ * header file for the GHASH universal hash used by the GCM mode of operation.
+ * @file GHASH.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYGHASH
+#define MYGHASH
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "../ciphers/BlockCipher.hpp"
+
+class GHASH {
+private:
+    const BlockCipher &blockCipher;
+
+    // 4 bit multiplication tables for the portable path: i * H split into high and low halves
+    uint64_t hh[16];
+    uint64_t hl[16];
+
+    // H, H^2, H^3, and H^4 byte reversed for the PCLMULQDQ path, which folds 4 blocks per reduction
+    alignas(16) uint8_t hPowers[4][16];
+    bool clmul;
+
+    GHASH();
+    GHASH& operator=(const GHASH &that) = delete;
+
+    void generateTables(const uint8_t h[16]);
+    void generatePowers(const uint8_t h[16]);
+    void updateTable(uint8_t state[16], const uint8_t *data, size_t nblocks) const;
+    void updateClmul(uint8_t state[16], const uint8_t *data, size_t nblocks) const;
+
+public:
+    // GHASH works on 128 bit blocks
+    static constexpr uint8_t BLOCK_SIZE = 16;
+
+    GHASH(const BlockCipher &blockCipher, bool useClmul = true);
+    GHASH(const GHASH &that);
+    ~GHASH();
+
+    void update(uint8_t state[16], const uint8_t *data, size_t nblocks) const;
+    void updatePadded(uint8_t state[16], const uint8_t *data, size_t size) const;
+    void updateLengths(uint8_t state[16], uint64_t aadSize, uint64_t textSize) const;
+    bool usesClmul() const;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/**
+ * class implementation for the keystream generator that precomputes OFB and CTR keystream ahead of the data.
+ * @file KeystreamGenerator.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "KeystreamGenerator.hpp"
+
+// encrypting zeros with OFB or CTR outputs the keystream itself
+static const uint8_t ZEROS[KeystreamGenerator::REFILL_BYTES] = {};
+
+/**
+ * KeystreamGenerator primary constructor, shared by the OFB and CTR constructors
+ *
+ * @param mode the OFB or CTR mode whose keystream is generated, which must outlive the generator
+ * @param capacity the number of keystream bytes the ring buffer holds
+ * @param background whether a thread keeps the ring buffer full, otherwise keystream is only made by precompute() or on demand
+ *
+ * @throws std::invalid_argument if capacity is 0
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the ring buffer or context
+ * @throws std::system_error if the background thread cannot be started
+ */
+KeystreamGenerator::KeystreamGenerator(const ModeOfOperation &mode, size_t capacity, bool background) : context(nullptr), ring(nullptr), capacity(capacity), head(0), buffered(0), position(0), stopping(false) {
+    if (capacity == 0)
+        throw std::invalid_argument("capacity must be at least 1 byte");
+
+    try {
+        ring = new uint8_t[capacity];
+        context = mode.createContext(ModeOfOperation::ENCRYPT);
+    } catch (std::bad_alloc &e) {
+        delete[] ring;
+        throw;
+    }
+
+    // the thread refills a chunk at a time, or half the ring when it is smaller than two chunks
+    refillSize = capacity < 2 * REFILL_BYTES ? (capacity + 1) / 2 : REFILL_BYTES;
+
+    if (background) {
+        try {
+            worker = std::thread(&KeystreamGenerator::workerLoop, this);
+        } catch (...) {
+            delete context;
+            delete[] ring;
+            throw;
+        }
+    }
+}
+
+/**
+ * KeystreamGenerator OFB constructor
+ *
+ * @param ofb the mode whose keystream is generated, its cipher and iv, which must outlive the generator
+ * @param capacity the number of keystream bytes the ring buffer holds
+ * @param background whether a thread keeps the ring buffer full, otherwise keystream is only made by precompute() or on demand
+ *
+ * @throws std::invalid_argument if capacity is 0
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the ring buffer or context
+ * @throws std::system_error if the background thread cannot be started
+ */
+KeystreamGenerator::KeystreamGenerator(const OFB &ofb, size_t capacity, bool background) : KeystreamGenerator(static_cast<const ModeOfOperation&>(ofb), capacity, background) {
+
+}
+
+/**
+ * KeystreamGenerator CTR constructor, also used for ParallelCTR
+ *
+ * @param ctr the mode whose keystream is generated, its cipher and iv, which must outlive the generator
+ * @param capacity the number of keystream bytes the ring buffer holds
+ * @param background whether a thread keeps the ring buffer full, otherwise keystream is only made by precompute() or on demand
+ *
+ * @throws std::invalid_argument if capacity is 0
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the ring buffer or context
+ * @throws std::system_error if the background thread cannot be started
+ */
+KeystreamGenerator::KeystreamGenerator(const CTR &ctr, size_t capacity, bool background) : KeystreamGenerator(static_cast<const ModeOfOperation&>(ctr), capacity, background) {
+
+}
+
+/**
+ * KeystreamGenerator destructor, stops the background thread and clears the unused keystream
+ */
+KeystreamGenerator::~KeystreamGenerator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    consumed.notify_all();
+
+    if (worker.joinable())
+        worker.join();
+
+    BlockCipher::wipe(ring, capacity);
+    delete[] ring;
+    delete context;
+}
+
+/**
+ * encrypts the next size bytes of the message by XORing them with buffered keystream,
+ * generating any keystream that is not buffered yet on the calling thread
+ * calls must not be made concurrently with each other, but may be concurrent with precompute() and the background thread
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to size
+ */
+size_t KeystreamGenerator::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) {
+    const uint8_t *keystream;
+    size_t n;
+
+    for (size_t offset = 0; offset < size; offset += n) {
+        // the buffered keystream up to the end of the ring, the background thread only writes past it
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            n = buffered < capacity - head ? buffered : capacity - head;
+            n = n < size - offset ? n : size - offset;
+            keystream = ring + head;
+        }
+
+        if (n == 0) {
+            generate(size - offset);
+            continue;
+        }
+
+        BlockOps::xorBytes(ciphertext + offset, plaintext + offset, keystream, n);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            head = (head + n) % capacity;
+            buffered -= n;
+            position += n;
+        }
+        consumed.notify_one();
+    }
+
+    return size;
+}
+
+/**
+ * decrypts the next size bytes of the message, the same as encrypting since the keystream is XORed either way
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @return the number of plaintext bytes written, equal to size
+ */
+size_t KeystreamGenerator::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) {
+    return encrypt(ciphertext, size, plaintext);
+}
+
+/**
+ * generates keystream into the free part of the ring buffer, for callers without a background thread to use idle time
+ *
+ * @param nbytes the most keystream bytes to generate, by default as many as fit
+ *
+ * @return the number of keystream bytes generated, less than nbytes once the ring buffer is full
+ */
+size_t KeystreamGenerator::precompute(size_t nbytes) {
+    size_t total = 0, n;
+
+    while (total < nbytes && (n = generate(nbytes - total)))
+        total += n;
+
+    return total;
+}
+
+/**
+ * @return the number of keystream bytes ready for encrypt() without running the block cipher
+ */
+size_t KeystreamGenerator::getBuffered() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffered;
+}
+
+/**
+ * @return [KeystreamGenerator::capacity], the most keystream bytes the ring buffer holds
+ */
+size_t KeystreamGenerator::getCapacity() const {
+    return capacity;
+}
+
+/**
+ * @return the number of message bytes encrypted so far, the offset of the next byte in the OFB/CTR stream
+ */
+uint64_t KeystreamGenerator::getPosition() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return position;
+}
+
+/**
+ * runs the context over zeros to write keystream after the buffered keystream, up to the end of the ring
+ *
+ * @param nbytes the most keystream bytes to generate, at most REFILL_BYTES are generated per call
+ *
+ * @return the number of keystream bytes generated, 0 if the ring buffer is full or the generator is stopping
+ */
+size_t KeystreamGenerator::generate(size_t nbytes) {
+    std::lock_guard<std::mutex> generateLock(generateMutex);
+    size_t tail, n;
+
+    // encrypt() only moves head forward, which leaves tail where it is and frees more space
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping)
+            return 0;
+        tail = (head + buffered) % capacity;
+        n = capacity - buffered < capacity - tail ? capacity - buffered : capacity - tail;
+    }
+
+    n = n < nbytes ? n : nbytes;
+    n = n < REFILL_BYTES ? n : REFILL_BYTES;
+    if (n == 0)
+        return 0;
+
+    context->update(ZEROS, n, ring + tail);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffered += n;
+    }
+
+    return n;
+}
+
+/**
+ * body of the background thread: sleep until refillSize bytes of the ring buffer are free, then fill it, repeat until destruction
+ */
+void KeystreamGenerator::workerLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            consumed.wait(lock, [this] { return stopping || capacity - buffered >= refillSize; });
+            if (stopping)
+                return;
+        }
+
+        // keep generating until the ring buffer is full again
+        while (generate(REFILL_BYTES))
+            continue;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * header file for the keystream generator that precomputes OFB and CTR keystream ahead of the data.
+ * @file KeystreamGenerator.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYKEYSTREAMGENERATOR
+#define MYKEYSTREAMGENERATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "ModeOfOperation.hpp"
+#include "OFB.hpp"
+#include "CTR.hpp"
+
+// OFB and CTR keystream depends only on the key and iv, so it can be generated before the data it encrypts arrives
+// the generator encrypts one continuous message, like a ModeContext, whose keystream is kept in a bounded ring buffer
+// and refilled by a background thread or by calls to precompute(), so encrypt() is only an XOR while keystream is buffered
+class KeystreamGenerator {
+private:
+    KeystreamGenerator();
+    KeystreamGenerator(const KeystreamGenerator &that) = delete;
+    KeystreamGenerator& operator=(const KeystreamGenerator &that) = delete;
+
+    KeystreamGenerator(const ModeOfOperation &mode, size_t capacity, bool background);
+
+public:
+    // default ring buffer size, 4096 AES blocks
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+
+    // most keystream bytes generated at once, so a consumer waits at most this long for keystream already being made
+    static constexpr size_t REFILL_BYTES = 1 << 12;
+
+    KeystreamGenerator(const OFB &ofb, size_t capacity = DEFAULT_CAPACITY, bool background = true);
+    KeystreamGenerator(const CTR &ctr, size_t capacity = DEFAULT_CAPACITY, bool background = true);
+    ~KeystreamGenerator();
+
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext);
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext);
+    size_t precompute(size_t nbytes = SIZE_MAX);
+    size_t getBuffered() const;
+    size_t getCapacity() const;
+    uint64_t getPosition() const;
+
+private:
+    // only the thread holding generateMutex uses the context, writing into the free part of the ring
+    ModeContext *context;
+    std::mutex generateMutex;
+
+    // the keystream for bytes [position, position + buffered) of the message starts at ring[head] and may wrap around
+    uint8_t *ring;
+    size_t capacity;
+    size_t head;
+    size_t buffered;
+    uint64_t position;
+
+    // the background thread wakes once this much of the ring buffer is free
+    size_t refillSize;
+
+    // guards head, buffered, position, and stopping, and wakes the background thread when keystream is used up
+    mutable std::mutex mutex;
+    std::condition_variable consumed;
+    bool stopping;
+    std::thread worker;
+
+    size_t generate(size_t nbytes);
+    void workerLoop();
+};
+
+#endif
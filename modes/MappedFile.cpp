@@ -0,0 +1,131 @@
+/**
+ * class implementation for a file mapped into memory, used by the file-level encryption API.
+ * @file MappedFile.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "MappedFile.hpp"
+
+/**
+ * MappedFile constructor for input, maps an existing file read-only for one sequential pass
+ *
+ * @param path the file to read
+ *
+ * @throws std::system_error if the file cannot be opened, examined, or mapped
+ */
+MappedFile::MappedFile(const std::string &path) : fd(-1), data(nullptr), size(0) {
+    struct stat info;
+
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+
+    if (fstat(fd, &info) < 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "cannot stat " + path);
+    }
+
+    size = info.st_size;
+    map(PROT_READ);
+}
+
+/**
+ * MappedFile constructor for output, creates or truncates a file of exactly size bytes and maps it writable
+ *
+ * @param path the file to write
+ * @param size the size of the file, it can be shrunk afterwards with truncate()
+ *
+ * @throws std::system_error if the file cannot be created, sized, or mapped
+ */
+MappedFile::MappedFile(const std::string &path, size_t size) : fd(-1), data(nullptr), size(size) {
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "cannot create " + path);
+
+    if (ftruncate(fd, size) < 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "cannot resize " + path);
+    }
+
+    map(PROT_READ | PROT_WRITE);
+}
+
+/**
+ * MappedFile destructor, unmaps and closes the file, writes to an output mapping reach the file through the page cache
+ */
+MappedFile::~MappedFile() {
+    unmap();
+    close(fd);
+}
+
+/**
+ * maps the whole file and tells the kernel it will be accessed once from front to back
+ * an empty file still gets a one page mapping so that getData() is never null, it is never touched
+ *
+ * @param protection PROT_READ, or PROT_READ | PROT_WRITE
+ *
+ * @throws std::system_error if the file cannot be mapped, the file is closed first
+ */
+void MappedFile::map(int protection) {
+    void *address = mmap(nullptr, size ? size : 1, protection, MAP_SHARED, fd, 0);
+
+    if (address == MAP_FAILED) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "cannot map file");
+    }
+
+    data = (uint8_t*) address;
+    madvise(data, size ? size : 1, MADV_SEQUENTIAL);
+}
+
+/**
+ * removes the mapping if there is one
+ */
+void MappedFile::unmap() {
+    if (data)
+        munmap(data, size ? size : 1);
+    data = nullptr;
+}
+
+/**
+ * @return the mapped bytes of the file
+ */
+const uint8_t* MappedFile::getData() const {
+    return data;
+}
+
+/**
+ * @return the mapped bytes of the file
+ */
+uint8_t* MappedFile::getData() {
+    return data;
+}
+
+/**
+ * @return the size of the file in bytes
+ */
+size_t MappedFile::getSize() const {
+    return size;
+}
+
+/**
+ * shrinks an output file to its final size once the data has been written, the file is no longer mapped afterwards
+ *
+ * @param size the new size of the file, at most getSize()
+ *
+ * @throws std::out_of_range if size is larger than the current size
+ * @throws std::system_error if the file cannot be resized
+ */
+void MappedFile::truncate(size_t size) {
+    if (size > this->size)
+        throw std::out_of_range("a mapped file can only be truncated to a smaller size");
+
+    unmap();
+    this->size = size;
+    if (ftruncate(fd, size) < 0)
+        throw std::system_error(errno, std::generic_category(), "cannot resize file");
+}
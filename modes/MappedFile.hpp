@@ -0,0 +1,46 @@
+/**
+ * header file for a file mapped into memory, used by the file-level encryption API.
+ * @file MappedFile.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYMAPPEDFILE
+#define MYMAPPEDFILE
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+class MappedFile {
+private:
+    int fd;
+    uint8_t *data;
+    size_t size;
+
+    MappedFile();
+    MappedFile(const MappedFile &that) = delete;
+    MappedFile& operator=(const MappedFile &that) = delete;
+
+    void map(int protection);
+    void unmap();
+
+public:
+    MappedFile(const std::string &path);
+    MappedFile(const std::string &path, size_t size);
+    ~MappedFile();
+
+    const uint8_t* getData() const;
+    uint8_t* getData();
+    size_t getSize() const;
+    void truncate(size_t size);
+};
+
+#endif
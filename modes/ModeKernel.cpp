@@ -0,0 +1,265 @@
+/**
+ * class implementation for the mode of operation kernels, the chaining loops of the modes compiled against a concrete block cipher.
+ * @file ModeKernel.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ModeKernel.hpp"
+#include "../ciphers/CPUFeatures.hpp"
+
+/**
+ * ModeKernel default constructor
+ */
+ModeKernel::ModeKernel() {
+
+}
+
+/**
+ * ModeKernel destructor
+ */
+ModeKernel::~ModeKernel() {
+
+}
+
+/**
+ * picks the kernels compiled for the class that actually encrypts the blocks of blockCipher,
+ * looking through the AES facade at its backend when single blocks and runs of blocks share one
+ *
+ * @param blockCipher the cipher a mode of operation was constructed with
+ *
+ * @return a heap allocated kernel that must be deleted by the caller, or nullptr if there is none for this cipher
+ * and the mode should keep calling blockCipher through its virtual functions
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the kernel
+ */
+ModeKernel* ModeKernel::create(const BlockCipher &blockCipher) {
+    const BlockCipher *engine = &blockCipher;
+    const AES *aes = dynamic_cast<const AES*>(engine);
+    ModeKernel *kernel = nullptr;
+
+    if (aes) {
+        if (aes->getBackend() != aes->getBatchBackend())
+            return nullptr;
+        engine = &aes->getEngine();
+    }
+
+    try {
+        if (const AES_NI *aesni = dynamic_cast<const AES_NI*>(engine))
+            kernel = new CipherModeKernel<AES_NI>(*aesni);
+        else if (const AES_TTable *ttable = dynamic_cast<const AES_TTable*>(engine)) {
+#if defined(__i386__)
+            // the kernels are compiled with SSE2 enabled, which 32 bit x86 processors may lack
+            if (!CPUFeatures::hasSSE2())
+                return nullptr;
+#endif
+            kernel = new CipherModeKernel<AES_TTable>(*ttable);
+        }
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    return kernel;
+}
+
+/**
+ * CipherModeKernel primary constructor
+ *
+ * @param cipher the cipher whose block functions are called directly, which must outlive the kernel
+ */
+template <class Cipher>
+CipherModeKernel<Cipher>::CipherModeKernel(const Cipher &cipher) : cipher(cipher) {
+
+}
+
+/**
+ * CipherModeKernel destructor
+ */
+template <class Cipher>
+CipherModeKernel<Cipher>::~CipherModeKernel() {
+
+}
+
+/**
+ * XORs two blocks, both loaded whole before the result is stored so the compiler can use a vector register per block
+ *
+ * @param dst BLOCK_SIZE bytes for the result, may be the same as a or b
+ * @param a BLOCK_SIZE bytes
+ * @param b BLOCK_SIZE bytes
+ */
+template <class Cipher>
+inline void CipherModeKernel<Cipher>::xorBlock(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
+    uint64_t x[BLOCK_SIZE / 8], y[BLOCK_SIZE / 8];
+
+    memcpy(x, a, BLOCK_SIZE);
+    memcpy(y, b, BLOCK_SIZE);
+    for (int i = 0; i < BLOCK_SIZE / 8; i++)
+        x[i] ^= y[i];
+    memcpy(dst, x, BLOCK_SIZE);
+}
+
+/**
+ * increments a big-endian counter block by 1, wrapping around to 0 after the maximum value
+ *
+ * @param counter BLOCK_SIZE bytes
+ */
+template <class Cipher>
+inline void CipherModeKernel<Cipher>::incrementCounter(uint8_t counter[]) {
+    for (int i = BLOCK_SIZE - 1; i >= 0; i--)
+        if (++counter[i])
+            break;
+}
+
+/**
+ * CBC encryption, C[i] = E(P[i] XOR C[i - 1]), with the chaining block kept in a local the compiler can hold in a register
+ *
+ * @param prev the ciphertext block (or iv) before the run, the last ciphertext block on return
+ * @param plaintext nblocks blocks of data
+ * @param ciphertext room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+template <class Cipher>
+void CipherModeKernel<Cipher>::cbcEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    uint8_t chain[BLOCK_SIZE], block[BLOCK_SIZE];
+
+    memcpy(chain, prev, BLOCK_SIZE);
+    for (size_t b = 0; b < nblocks; b++) {
+        xorBlock(block, plaintext + b * BLOCK_SIZE, chain);
+        cipher.encryptBlock(block, chain);
+        memcpy(ciphertext + b * BLOCK_SIZE, chain, BLOCK_SIZE);
+    }
+    memcpy(prev, chain, BLOCK_SIZE);
+}
+
+/**
+ * CBC decryption, P[i] = D(C[i]) XOR C[i - 1], PARALLEL_BLOCKS blocks to the cipher at a time
+ * each group is XORed from its last block to its first so that in-place output never overwrites a ciphertext block still needed
+ *
+ * @param prev the ciphertext block (or iv) before the run, the last ciphertext block on return
+ * @param ciphertext nblocks blocks of data
+ * @param plaintext room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+template <class Cipher>
+void CipherModeKernel<Cipher>::cbcDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    uint8_t blocks[PARALLEL_BLOCKS * BLOCK_SIZE], chain[BLOCK_SIZE];
+    size_t n;
+
+    memcpy(chain, prev, BLOCK_SIZE);
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < PARALLEL_BLOCKS ? nblocks - b : PARALLEL_BLOCKS;
+
+        cipher.decryptBlocks(ciphertext + b * BLOCK_SIZE, blocks, n);
+        xorBlock(blocks, blocks, chain);
+
+        // the group's last ciphertext block is saved before any plaintext can overwrite it
+        memcpy(chain, ciphertext + (b + n - 1) * BLOCK_SIZE, BLOCK_SIZE);
+        for (size_t i = n - 1; i > 0; i--)
+            xorBlock(plaintext + (b + i) * BLOCK_SIZE, blocks + i * BLOCK_SIZE, ciphertext + (b + i - 1) * BLOCK_SIZE);
+        memcpy(plaintext + b * BLOCK_SIZE, blocks, BLOCK_SIZE);
+    }
+    memcpy(prev, chain, BLOCK_SIZE);
+}
+
+/**
+ * CFB encryption, C[i] = P[i] XOR E(C[i - 1])
+ *
+ * @param prev the ciphertext block (or iv) before the run, the last ciphertext block on return
+ * @param plaintext nblocks blocks of data
+ * @param ciphertext room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+template <class Cipher>
+void CipherModeKernel<Cipher>::cfbEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const {
+    uint8_t chain[BLOCK_SIZE];
+
+    memcpy(chain, prev, BLOCK_SIZE);
+    for (size_t b = 0; b < nblocks; b++) {
+        cipher.encryptBlock(chain, chain);
+        xorBlock(chain, chain, plaintext + b * BLOCK_SIZE);
+        memcpy(ciphertext + b * BLOCK_SIZE, chain, BLOCK_SIZE);
+    }
+    memcpy(prev, chain, BLOCK_SIZE);
+}
+
+/**
+ * CFB decryption, P[i] = C[i] XOR E(C[i - 1]), PARALLEL_BLOCKS blocks to the cipher at a time since every input is ciphertext
+ *
+ * @param prev the ciphertext block (or iv) before the run, the last ciphertext block on return
+ * @param ciphertext nblocks blocks of data
+ * @param plaintext room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+template <class Cipher>
+void CipherModeKernel<Cipher>::cfbDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const {
+    uint8_t blocks[PARALLEL_BLOCKS * BLOCK_SIZE], chain[BLOCK_SIZE];
+    size_t n;
+
+    memcpy(chain, prev, BLOCK_SIZE);
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < PARALLEL_BLOCKS ? nblocks - b : PARALLEL_BLOCKS;
+
+        memcpy(blocks, chain, BLOCK_SIZE);
+        memcpy(blocks + BLOCK_SIZE, ciphertext + b * BLOCK_SIZE, (n - 1) * BLOCK_SIZE);
+        memcpy(chain, ciphertext + (b + n - 1) * BLOCK_SIZE, BLOCK_SIZE);
+
+        cipher.encryptBlocks(blocks, blocks, n);
+        for (size_t i = 0; i < n; i++)
+            xorBlock(plaintext + (b + i) * BLOCK_SIZE, ciphertext + (b + i) * BLOCK_SIZE, blocks + i * BLOCK_SIZE);
+    }
+    memcpy(prev, chain, BLOCK_SIZE);
+}
+
+/**
+ * OFB encryption/decryption, each keystream block is the encryption of the one before it
+ *
+ * @param keystream the keystream block (or iv) before the run, the last keystream block on return
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+template <class Cipher>
+void CipherModeKernel<Cipher>::ofb(uint8_t keystream[], const uint8_t *input, uint8_t *output, size_t nblocks) const {
+    uint8_t chain[BLOCK_SIZE];
+
+    memcpy(chain, keystream, BLOCK_SIZE);
+    for (size_t b = 0; b < nblocks; b++) {
+        cipher.encryptBlock(chain, chain);
+        xorBlock(output + b * BLOCK_SIZE, input + b * BLOCK_SIZE, chain);
+    }
+    memcpy(keystream, chain, BLOCK_SIZE);
+}
+
+/**
+ * CTR encryption/decryption, PARALLEL_BLOCKS counter blocks laid out and encrypted at a time
+ *
+ * @param counter the counter of the first block, advanced past the last block on return
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks
+ * @param nblocks the number of blocks
+ */
+template <class Cipher>
+void CipherModeKernel<Cipher>::ctr(uint8_t counter[], const uint8_t *input, uint8_t *output, size_t nblocks) const {
+    uint8_t blocks[PARALLEL_BLOCKS * BLOCK_SIZE];
+    size_t n;
+
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < PARALLEL_BLOCKS ? nblocks - b : PARALLEL_BLOCKS;
+
+        if constexpr (BLOCK_SIZE == 16) {
+            BlockOps::generateCounters(counter, blocks, n);
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                memcpy(blocks + i * BLOCK_SIZE, counter, BLOCK_SIZE);
+                incrementCounter(counter);
+            }
+        }
+
+        cipher.encryptBlocks(blocks, blocks, n);
+        for (size_t i = 0; i < n; i++)
+            xorBlock(output + (b + i) * BLOCK_SIZE, input + (b + i) * BLOCK_SIZE, blocks + i * BLOCK_SIZE);
+    }
+}
+
+template class CipherModeKernel<AES_NI>;
+template class CipherModeKernel<AES_TTable>;
@@ -0,0 +1,91 @@
+/**
+ * header file for the mode of operation kernels, the chaining loops of the modes compiled against a concrete block cipher.
+ * @file ModeKernel.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYMODEKERNEL
+#define MYMODEKERNEL
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include "../ciphers/BlockCipher.hpp"
+#include "../ciphers/AES.hpp"
+#include "../ciphers/AES_NI.hpp"
+#include "../ciphers/AES_TTable.hpp"
+#include "BlockOps.hpp"
+
+// the whole-block loops of the modes behind one virtual call per run of blocks, rather than one per block,
+// so ModeOfOperation and its subclasses stay polymorphic over BlockCipher
+// every function takes the chaining value (previous ciphertext block, keystream block, or counter) and advances it
+// past the last block, the output may be the same buffer as the input but must not otherwise overlap it
+class ModeKernel {
+private:
+    ModeKernel(const ModeKernel &that) = delete;
+    ModeKernel& operator=(const ModeKernel &that) = delete;
+
+protected:
+    ModeKernel();
+
+public:
+    virtual ~ModeKernel();
+    virtual void cbcEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const = 0;
+    virtual void cbcDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const = 0;
+    virtual void cfbEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const = 0;
+    virtual void cfbDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const = 0;
+    virtual void ofb(uint8_t keystream[], const uint8_t *input, uint8_t *output, size_t nblocks) const = 0;
+    virtual void ctr(uint8_t counter[], const uint8_t *input, uint8_t *output, size_t nblocks) const = 0;
+
+    static ModeKernel* create(const BlockCipher &blockCipher);
+};
+
+// the kernels for one concrete (final) cipher class, whose block functions are called directly and whose
+// BLOCK_SIZE is a compile-time constant, so the XOR and copies of each block compile down to a few vector instructions
+// and ciphers with inline block functions (AES_NI) have their rounds fused into the chaining loop
+// on x86 every instantiation is compiled with AES-NI (and so SSE2) enabled, which the compiler only uses
+// in the inlined AES_NI code and to vectorize the XORs
+#if defined(__x86_64__) || defined(__i386__)
+#pragma GCC push_options
+#pragma GCC target("aes,sse2")
+#endif
+template <class Cipher>
+class CipherModeKernel final : public ModeKernel {
+private:
+    static constexpr uint8_t BLOCK_SIZE = Cipher::BLOCK_SIZE;
+    static_assert(BLOCK_SIZE % 8 == 0, "the kernels XOR whole 64 bit words");
+
+    // number of independent blocks handed to the cipher at once by the parallel directions
+    static constexpr size_t PARALLEL_BLOCKS = 8;
+
+    const Cipher &cipher;
+
+    CipherModeKernel();
+    CipherModeKernel(const CipherModeKernel &that) = delete;
+    CipherModeKernel& operator=(const CipherModeKernel &that) = delete;
+
+    static void xorBlock(uint8_t *dst, const uint8_t *a, const uint8_t *b);
+    static void incrementCounter(uint8_t counter[]);
+
+public:
+    CipherModeKernel(const Cipher &cipher);
+    ~CipherModeKernel();
+
+    void cbcEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void cbcDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+    void cfbEncrypt(uint8_t prev[], const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks) const;
+    void cfbDecrypt(uint8_t prev[], const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks) const;
+    void ofb(uint8_t keystream[], const uint8_t *input, uint8_t *output, size_t nblocks) const;
+    void ctr(uint8_t counter[], const uint8_t *input, uint8_t *output, size_t nblocks) const;
+};
+#if defined(__x86_64__) || defined(__i386__)
+#pragma GCC pop_options
+#endif
+
+// the kernels are compiled once in ModeKernel.cpp
+extern template class CipherModeKernel<AES_NI>;
+extern template class CipherModeKernel<AES_TTable>;
+
+#endif
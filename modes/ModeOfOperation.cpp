@@ -6,21 +6,257 @@
  */
 
 #include "ModeOfOperation.hpp"
+#include "MappedFile.hpp"
+
+/**
+ * ModeContext primary constructor
+ */
+ModeContext::ModeContext() {
+
+}
+
+/**
+ * ModeContext destructor
+ */
+ModeContext::~ModeContext() {
+
+}
 
 /**
  * ModeOfOperation primary constructor
  *
  * @param blockCipher a reference to a BlockCipher that will be used to encrypt/decrypt data
  */
-ModeOfOperation::ModeOfOperation(const BlockCipher &blockCipher) : blockCipher(blockCipher) {
-
+ModeOfOperation::ModeOfOperation(const BlockCipher &blockCipher) : blockCipher(blockCipher), kernel(nullptr) {
+    try {
+        kernel = ModeKernel::create(blockCipher);
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
 }
 
 /**
  * ModeOfOperation destructor
  */
 ModeOfOperation::~ModeOfOperation() {
-    
+    delete kernel;
+}
+
+/**
+ * decryption can only remove bytes (padding), so a plaintext buffer this large always suffices
+ * the exact size is returned by decrypt()
+ *
+ * @param ciphertextSize the number of ciphertext bytes to decrypt
+ *
+ * @return the largest number of bytes decrypt() can write for ciphertextSize bytes of input
+ */
+size_t ModeOfOperation::getMaxDecryptedSize(size_t ciphertextSize) const {
+    return ciphertextSize;
+}
+
+/**
+ * encrypts a whole file by mapping it and a ciphertext file of exactly getEncryptedSize() bytes into memory
+ * the mapped buffers go through the buffer encrypt(), so a parallel mode of operation splits the file across its threads
+ *
+ * @param plaintextPath the file to encrypt
+ * @param ciphertextPath the file to create or overwrite with the ciphertext, it must not be the plaintext file
+ *
+ * @throws std::system_error if either file cannot be opened, sized, or mapped
+ * @throws std::bad_alloc if the mode of operation is unable to allocate memory on the heap
+ */
+void ModeOfOperation::encryptFile(const std::string &plaintextPath, const std::string &ciphertextPath) const {
+    MappedFile plaintext(plaintextPath);
+    MappedFile ciphertext(ciphertextPath, getEncryptedSize(plaintext.getSize()));
+
+    encrypt(plaintext.getData(), plaintext.getSize(), ciphertext.getData());
+}
+
+/**
+ * decrypts a whole file by mapping it and a plaintext file of getMaxDecryptedSize() bytes into memory,
+ * the plaintext file is then truncated to the number of bytes left after stripping padding
+ *
+ * @param ciphertextPath the file to decrypt
+ * @param plaintextPath the file to create or overwrite with the plaintext, it must not be the ciphertext file
+ *
+ * @throws std::invalid_argument if the ciphertext is not a multiple of the block size for a block mode of operation
+ * @throws std::system_error if either file cannot be opened, sized, or mapped
+ * @throws std::bad_alloc if the mode of operation is unable to allocate memory on the heap
+ */
+void ModeOfOperation::decryptFile(const std::string &ciphertextPath, const std::string &plaintextPath) const {
+    MappedFile ciphertext(ciphertextPath);
+    MappedFile plaintext(plaintextPath, getMaxDecryptedSize(ciphertext.getSize()));
+
+    plaintext.truncate(decrypt(ciphertext.getData(), ciphertext.getSize(), plaintext.getData()));
+}
+
+/**
+ * the number of plaintext bytes a whole ciphertext decrypts to, which bounds the ranges decryptRange() accepts
+ * stream modes of operation do not pad, so this is the ciphertext size unless a subclass overrides it
+ *
+ * @param ciphertext size bytes of ciphertext, only read by modes that pad
+ * @param size the number of ciphertext bytes
+ *
+ * @return the number of plaintext bytes
+ */
+size_t ModeOfOperation::getRangeSize(const uint8_t *, size_t size) const {
+    return size;
+}
+
+/**
+ * decrypts ciphertext starting at any block without decrypting the blocks before it, subclasses whose
+ * chaining state can be derived from the iv and the ciphertext alone (CTR, CBC, CFB, ECB) override this
+ *
+ * @param ciphertext the start of the whole ciphertext
+ * @param firstBlock the index of the first block to decrypt
+ * @param nbytes the number of bytes to decrypt, a multiple of the block size unless the run ends the ciphertext
+ * @param plaintext room for nbytes rounded up to a whole number of blocks, must not overlap ciphertext
+ *
+ * @throws std::invalid_argument since the mode of operation does not support random access
+ */
+void ModeOfOperation::decryptAt(const uint8_t *, size_t, size_t, uint8_t *) const {
+    throw std::invalid_argument("this mode of operation does not support decrypting a range");
+}
+
+/**
+ * decrypts only the plaintext bytes [offset, offset + length) of a message, starting at the block that contains offset
+ * rather than at the start of the ciphertext, so the cost depends on the length of the range and not on its position
+ * a range reaching past the end of the plaintext is cut short
+ *
+ * @param ciphertext size bytes of ciphertext, the whole message
+ * @param size the number of ciphertext bytes
+ * @param offset the position of the first plaintext byte to decrypt
+ * @param length the number of plaintext bytes to decrypt
+ * @param plaintext room for length bytes, must not overlap ciphertext
+ *
+ * @return the number of plaintext bytes written, less than length if the range reaches past the end of the plaintext
+ *
+ * @throws std::invalid_argument if the mode of operation does not support random access,
+ *                               or the ciphertext is not a multiple of the block size for a block mode of operation
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the decrypted blocks
+ */
+size_t ModeOfOperation::decryptRange(const uint8_t *ciphertext, size_t size, uint64_t offset, size_t length, uint8_t *plaintext) const {
+    uint8_t blockSize, *buffer;
+    size_t plaintextSize, chunkSize, firstBlock, skip, n, nbytes;
+
+    plaintextSize = getRangeSize(ciphertext, size);
+    if (offset >= plaintextSize)
+        return 0;
+    if (length > plaintextSize - offset)
+        length = plaintextSize - offset;
+
+    blockSize = blockCipher.getBlockSize();
+    chunkSize = BATCH_BLOCKS * blockSize;
+    try {
+        buffer = new uint8_t[chunkSize];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    // decrypt the whole blocks covering the range a chunk at a time and copy out the requested bytes
+    firstBlock = offset / blockSize;
+    skip = offset % blockSize;
+    try {
+        for (size_t done = 0; done < length; done += n) {
+            n = length - done < chunkSize - skip ? length - done : chunkSize - skip;
+            nbytes = (skip + n + blockSize - 1) / blockSize * blockSize;
+            if (nbytes > size - firstBlock * blockSize)
+                nbytes = size - firstBlock * blockSize;
+
+            decryptAt(ciphertext, firstBlock, nbytes, buffer);
+            memcpy(plaintext + done, buffer + skip, n);
+
+            firstBlock += BATCH_BLOCKS;
+            skip = 0;
+        }
+    } catch (...) {
+        delete[] buffer;
+        throw;
+    }
+
+    delete[] buffer;
+
+    return length;
+}
+
+/**
+ * decrypts only the plaintext bytes [offset, offset + length) of an encrypted file
+ * the file is mapped into memory, so only the pages holding the blocks of the range (and, for a padded
+ * block mode of operation, the final block) are read from disk
+ *
+ * @param ciphertextPath the file to decrypt part of
+ * @param offset the position of the first plaintext byte to decrypt
+ * @param length the number of plaintext bytes to decrypt
+ * @param plaintext room for length bytes
+ *
+ * @return the number of plaintext bytes written, less than length if the range reaches past the end of the plaintext
+ *
+ * @throws std::invalid_argument if the mode of operation does not support random access,
+ *                               or the ciphertext is not a multiple of the block size for a block mode of operation
+ * @throws std::system_error if the file cannot be opened or mapped
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the decrypted blocks
+ */
+size_t ModeOfOperation::decryptFileRange(const std::string &ciphertextPath, uint64_t offset, size_t length, uint8_t *plaintext) const {
+    MappedFile ciphertext(ciphertextPath);
+
+    return decryptRange(ciphertext.getData(), ciphertext.getSize(), offset, length, plaintext);
+}
+
+/**
+ * computes dst = a XOR b over n bytes with the widest vector instructions the CPU supports (see BlockOps)
+ * dst may be the same buffer as a or b, but must not partially overlap either of them
+ *
+ * @param dst the n byte result
+ * @param a the first n byte operand
+ * @param b the second n byte operand
+ * @param n the number of bytes to XOR
+ */
+void ModeOfOperation::xorBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n) {
+    BlockOps::xorBytes(dst, a, b, n);
+}
+
+/**
+ * runs a whole stream through a context of this mode of operation, a large chunk at a time
+ * only the context holds data back between chunks, so each read and write moves up to STREAM_CHUNK_SIZE bytes
+ *
+ * @param input std::istream where data is retrieved
+ * @param output std::ostream where data is sent after encrypting/decrypting
+ * @param direction whether to encrypt or decrypt
+ *
+ * @throws std::invalid_argument if the context rejects the input, see ModeContext::final()
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers or the context
+ */
+void ModeOfOperation::processStream(std::istream &input, std::ostream &output, DIRECTION direction) const {
+    ModeContext *context;
+    uint8_t *inBuffer, *outBuffer;
+    size_t nbytes;
+
+    // update() can write one held back block more than it reads, final() at most two blocks
+    try {
+        inBuffer = new uint8_t[STREAM_CHUNK_SIZE];
+        outBuffer = new uint8_t[STREAM_CHUNK_SIZE + 512];
+        context = createContext(direction);
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    try {
+        do {
+            input.read((char*) inBuffer, STREAM_CHUNK_SIZE);
+            nbytes = input.gcount();
+            output.write((char*) outBuffer, context->update(inBuffer, nbytes, outBuffer));
+        } while (nbytes == STREAM_CHUNK_SIZE);
+
+        output.write((char*) outBuffer, context->final(outBuffer));
+    } catch (...) {
+        delete context;
+        delete[] inBuffer;
+        delete[] outBuffer;
+        throw;
+    }
+
+    delete context;
+    delete[] inBuffer;
+    delete[] outBuffer;
 }
 
 /**
@@ -43,6 +279,191 @@ BlockModeOfOperation::~BlockModeOfOperation() {
     
 }
 
+/**
+ * @param plaintextSize the number of plaintext bytes to encrypt
+ *
+ * @return the exact number of bytes encrypt() writes, including padding
+ */
+size_t BlockModeOfOperation::getEncryptedSize(size_t plaintextSize) const {
+    return blockPadding.getPaddedSize(plaintextSize);
+}
+
+/**
+ * checks and reads the padding of the final block of decrypted data, the check itself takes the same time for any block
+ *
+ * @param plaintext the decrypted data, a non-zero multiple of the block size
+ * @param size the number of decrypted bytes
+ *
+ * @return the number of bytes left after stripping the padding
+ *
+ * @throws std::invalid_argument if the final block does not end in valid padding
+ */
+size_t BlockModeOfOperation::getUnpaddedSize(const uint8_t *plaintext, size_t size) const {
+    const uint8_t *last = plaintext + size - blockCipher.getBlockSize();
+
+    if (!blockPadding.isPaddingValid(last))
+        throw std::invalid_argument("invalid padding");
+
+    return size - blockPadding.getPaddingAmount(last);
+}
+
+/**
+ * the number of plaintext bytes a whole ciphertext decrypts to, found by decrypting only its final block
+ *
+ * @param ciphertext size bytes of ciphertext
+ * @param size the number of ciphertext bytes, a multiple of the block size
+ *
+ * @return the number of plaintext bytes after stripping padding
+ *
+ * @throws std::invalid_argument if size is not a multiple of the block size
+ */
+size_t BlockModeOfOperation::getRangeSize(const uint8_t *ciphertext, size_t size) const {
+    uint8_t blockSize, last[256];
+
+    blockSize = blockCipher.getBlockSize();
+    if (size % blockSize)
+        throw std::invalid_argument("ciphertext size must be a multiple of blockSize");
+    if (size == 0)
+        return 0;
+
+    decryptAt(ciphertext, size / blockSize - 1, blockSize, last);
+
+    return size - blockSize + getUnpaddedSize(last, blockSize);
+}
+
+/**
+ * BlockContext primary constructor, the context starts out ready for a new message
+ *
+ * @param mode the mode of operation whose cipher, padding, and iv are used, it must outlive the context
+ * @param direction whether the context encrypts or decrypts
+ */
+BlockModeOfOperation::BlockContext::BlockContext(const BlockModeOfOperation &mode, DIRECTION direction) : mode(mode), direction(direction), npending(0) {
+
+}
+
+/**
+ * BlockContext destructor
+ */
+BlockModeOfOperation::BlockContext::~BlockContext() {
+
+}
+
+/**
+ * discards any buffered data so the next update() begins a new message
+ */
+void BlockModeOfOperation::BlockContext::init() {
+    npending = 0;
+}
+
+/**
+ * encrypts/decrypts every complete block that is available except the final one
+ * the last 1 to blockSize bytes seen so far are kept until more data arrives or final() is called
+ *
+ * @param input size bytes of the message
+ * @param size the number of input bytes, may be 0
+ * @param output room for getUpdateSize(size) bytes, must not overlap input
+ *
+ * @return the number of bytes written to output, a multiple of the block size
+ */
+size_t BlockModeOfOperation::BlockContext::update(const uint8_t *input, size_t size, uint8_t *output) {
+    uint8_t blockSize;
+    size_t nblocks, take, written = 0;
+
+    blockSize = mode.blockCipher.getBlockSize();
+    if (npending + size <= blockSize) {
+        // an empty update may pass a null input
+        if (size)
+            memcpy(pending + npending, input, size);
+        npending += size;
+        return 0;
+    }
+
+    // complete the block left over from the previous update, more input is known to follow it
+    if (npending) {
+        take = blockSize - npending;
+        memcpy(pending + npending, input, take);
+        processBlocks(pending, output, 1);
+        input += take;
+        size -= take;
+        output += blockSize;
+        written += blockSize;
+    }
+
+    // process the whole blocks of the input, holding back the final 1 to blockSize bytes
+    nblocks = (size - 1) / blockSize;
+    processBlocks(input, output, nblocks);
+    written += nblocks * blockSize;
+
+    npending = size - nblocks * blockSize;
+    memcpy(pending, input + nblocks * blockSize, npending);
+
+    return written;
+}
+
+/**
+ * pads and encrypts, or decrypts and unpads, the held back data, then readies the context for a new message
+ *
+ * @param output room for getFinalSize() bytes
+ *
+ * @return the number of bytes written to output
+ *
+ * @throws std::invalid_argument if decrypting and the ciphertext was not a multiple of the block size or has invalid padding
+ */
+size_t BlockModeOfOperation::BlockContext::final(uint8_t *output) {
+    uint8_t blockSize;
+    size_t written;
+
+    blockSize = mode.blockCipher.getBlockSize();
+    if (direction == ENCRYPT) {
+        // padding is written after the held back bytes, a full final block is followed by a block of nothing but padding
+        written = mode.blockPadding.addPadding(pending, npending);
+        processBlocks(pending, output, written / blockSize);
+    } else {
+        if (npending == 0)
+            return 0;
+        if (npending != blockSize) {
+            init();
+            throw std::invalid_argument("ciphertext size must be a multiple of blockSize");
+        }
+
+        processBlocks(pending, output, 1);
+        try {
+            written = mode.getUnpaddedSize(output, blockSize);
+        } catch (std::invalid_argument &e) {
+            init();
+            throw;
+        }
+    }
+
+    init();
+
+    return written;
+}
+
+/**
+ * @param size the number of bytes about to be passed to update()
+ *
+ * @return the exact number of bytes update() will write
+ */
+size_t BlockModeOfOperation::BlockContext::getUpdateSize(size_t size) const {
+    uint8_t blockSize = mode.blockCipher.getBlockSize();
+
+    if (npending + size <= blockSize)
+        return 0;
+
+    return (npending + size - 1) / blockSize * blockSize;
+}
+
+/**
+ * @return the largest number of bytes final() can write given the data held back so far
+ */
+size_t BlockModeOfOperation::BlockContext::getFinalSize() const {
+    if (direction == ENCRYPT)
+        return mode.blockPadding.getPaddedSize(npending);
+
+    return npending;
+}
+
 /**
  * StreamModeOfOperation primary constructor
  *
@@ -57,4 +478,139 @@ StreamModeOfOperation::StreamModeOfOperation(const BlockCipher &blockCipher) : M
  */
 StreamModeOfOperation::~StreamModeOfOperation() {
     
-}
\ No newline at end of file
+}
+
+/**
+ * @param plaintextSize the number of plaintext bytes to encrypt
+ *
+ * @return plaintextSize, stream modes do not pad
+ */
+size_t StreamModeOfOperation::getEncryptedSize(size_t plaintextSize) const {
+    return plaintextSize;
+}
+
+/**
+ * StreamContext primary constructor, the context starts out ready for a new message
+ *
+ * @param mode the mode of operation whose cipher and iv are used, it must outlive the context
+ * @param direction whether the context encrypts or decrypts
+ */
+StreamModeOfOperation::StreamContext::StreamContext(const StreamModeOfOperation &mode, DIRECTION direction) : mode(mode), direction(direction), used(mode.blockCipher.getBlockSize()) {
+
+}
+
+/**
+ * StreamContext destructor
+ */
+StreamModeOfOperation::StreamContext::~StreamContext() {
+
+}
+
+/**
+ * marks the keystream as used up so the next update() begins a new message
+ * subclasses also restore their chaining state from the iv
+ */
+void StreamModeOfOperation::StreamContext::init() {
+    used = mode.blockCipher.getBlockSize();
+}
+
+/**
+ * called with every ciphertext byte as it is produced or consumed, for modes whose keystream depends on the ciphertext
+ *
+ * @param ciphertext n bytes of ciphertext
+ * @param offset the position of the first byte within its block
+ * @param n the number of bytes, offset + n is at most the block size
+ */
+void StreamModeOfOperation::StreamContext::absorb(const uint8_t *, size_t, size_t) {
+
+}
+
+/**
+ * encrypts/decrypts whole blocks starting on a block boundary, one keystream block at a time
+ * subclasses override this when their keystream can be generated for many blocks at once
+ *
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks, must not overlap input
+ * @param nblocks the number of blocks
+ */
+void StreamModeOfOperation::StreamContext::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    uint8_t blockSize = mode.blockCipher.getBlockSize();
+
+    for (size_t b = 0; b < nblocks; b++) {
+        nextKeystream();
+        xorBytes(output + b * blockSize, input + b * blockSize, keystream, blockSize);
+        absorb(direction == ENCRYPT ? output + b * blockSize : input + b * blockSize, 0, blockSize);
+    }
+}
+
+/**
+ * encrypts/decrypts every input byte immediately, a partial final block leaves the rest of its keystream for the next update
+ *
+ * @param input size bytes of the message
+ * @param size the number of input bytes, may be 0
+ * @param output room for size bytes, must not overlap input
+ *
+ * @return the number of bytes written to output, equal to size
+ */
+size_t StreamModeOfOperation::StreamContext::update(const uint8_t *input, size_t size, uint8_t *output) {
+    uint8_t blockSize;
+    size_t n, nblocks, written = size;
+
+    blockSize = mode.blockCipher.getBlockSize();
+
+    // finish the keystream block started by the previous update
+    if (used < blockSize) {
+        n = size < blockSize - used ? size : blockSize - used;
+        xorBytes(output, input, keystream + used, n);
+        absorb(direction == ENCRYPT ? output : input, used, n);
+        used += n;
+        input += n;
+        output += n;
+        size -= n;
+    }
+
+    nblocks = size / blockSize;
+    processBlocks(input, output, nblocks);
+    input += nblocks * blockSize;
+    output += nblocks * blockSize;
+    size -= nblocks * blockSize;
+
+    // start a keystream block for the trailing partial block
+    if (size) {
+        nextKeystream();
+        xorBytes(output, input, keystream, size);
+        absorb(direction == ENCRYPT ? output : input, 0, size);
+        used = size;
+    }
+
+    return written;
+}
+
+/**
+ * stream modes never hold data back, this only readies the context for a new message
+ *
+ * @param output unused, nothing is written
+ *
+ * @return 0
+ */
+size_t StreamModeOfOperation::StreamContext::final(uint8_t *) {
+    init();
+
+    return 0;
+}
+
+/**
+ * @param size the number of bytes about to be passed to update()
+ *
+ * @return size, stream modes output every byte immediately
+ */
+size_t StreamModeOfOperation::StreamContext::getUpdateSize(size_t size) const {
+    return size;
+}
+
+/**
+ * @return 0, final() never writes anything
+ */
+size_t StreamModeOfOperation::StreamContext::getFinalSize() const {
+    return 0;
+}
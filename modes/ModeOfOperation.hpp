@@ -10,25 +10,79 @@
 
 #include <istream>
 #include <ostream>
+#include <cstddef>
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
+#include <string>
 #include "../ciphers/BlockCipher.hpp"
 #include "../padding/BlockPadding.hpp"
+#include "ModeKernel.hpp"
+#include "BlockOps.hpp"
+
+class ModeContext {
+private:
+    ModeContext(const ModeContext &that) = delete;
+    ModeContext& operator=(const ModeContext &that) = delete;
+
+protected:
+    ModeContext();
+
+public:
+    virtual ~ModeContext();
+    virtual void init() = 0;
+    virtual size_t update(const uint8_t *input, size_t size, uint8_t *output) = 0;
+    virtual size_t final(uint8_t *output) = 0;
+    virtual size_t getUpdateSize(size_t size) const = 0;
+    virtual size_t getFinalSize() const = 0;
+};
 
 class ModeOfOperation {
+public:
+    enum DIRECTION : uint8_t {
+        ENCRYPT,
+        DECRYPT
+    };
+
 private:
     ModeOfOperation();
     ModeOfOperation(const ModeOfOperation &that) = delete;
     ModeOfOperation& operator=(const ModeOfOperation &that) = delete;
 
 protected:
+    // number of blocks handed to the block cipher at once
+    static constexpr size_t BATCH_BLOCKS = 64;
+
+    // number of bytes read from and written to a stream at once by processStream()
+    static constexpr size_t STREAM_CHUNK_SIZE = 1 << 16;
+
     const BlockCipher &blockCipher;
+
+    // the whole-block loops compiled for the concrete class behind blockCipher, or nullptr to call blockCipher per block
+    const ModeKernel *kernel;
+
     ModeOfOperation(const BlockCipher &blockCipher);
 
+    void processStream(std::istream &input, std::ostream &output, DIRECTION direction) const;
+    virtual size_t getRangeSize(const uint8_t *ciphertext, size_t size) const;
+    virtual void decryptAt(const uint8_t *ciphertext, size_t firstBlock, size_t nbytes, uint8_t *plaintext) const;
+
 public:
     virtual ~ModeOfOperation();
     virtual void encrypt(std::istream &plaintext, std::ostream &ciphertext) const = 0;
     virtual void decrypt(std::istream &ciphertext, std::ostream &plaintext) const = 0;
+    virtual size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const = 0;
+    virtual size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const = 0;
+    virtual size_t getEncryptedSize(size_t plaintextSize) const = 0;
+    size_t getMaxDecryptedSize(size_t ciphertextSize) const;
+    void encryptFile(const std::string &plaintextPath, const std::string &ciphertextPath) const;
+    void decryptFile(const std::string &ciphertextPath, const std::string &plaintextPath) const;
+    size_t decryptRange(const uint8_t *ciphertext, size_t size, uint64_t offset, size_t length, uint8_t *plaintext) const;
+    size_t decryptFileRange(const std::string &ciphertextPath, uint64_t offset, size_t length, uint8_t *plaintext) const;
+    virtual ModeContext* createContext(DIRECTION direction) const = 0;
+
+    static void xorBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t n);
 };
 
 class BlockModeOfOperation : public ModeOfOperation {
@@ -41,8 +95,36 @@ protected:
     const BlockPadding &blockPadding;
     BlockModeOfOperation(const BlockCipher &blockCipher, const BlockPadding &blockPadding);
 
+    size_t getUnpaddedSize(const uint8_t *plaintext, size_t size) const;
+    size_t getRangeSize(const uint8_t *ciphertext, size_t size) const;
+
+    // buffers partial blocks between updates and always holds back the final 1 to blockSize bytes,
+    // which encryption pads and decryption strips the padding from in final()
+    class BlockContext : public ModeContext {
+    private:
+        BlockContext();
+
+    protected:
+        const BlockModeOfOperation &mode;
+        const DIRECTION direction;
+        uint8_t pending[512];
+        size_t npending;
+
+        BlockContext(const BlockModeOfOperation &mode, DIRECTION direction);
+        virtual void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) = 0;
+
+    public:
+        virtual ~BlockContext();
+        virtual void init();
+        size_t update(const uint8_t *input, size_t size, uint8_t *output);
+        size_t final(uint8_t *output);
+        size_t getUpdateSize(size_t size) const;
+        size_t getFinalSize() const;
+    };
+
 public:
     virtual ~BlockModeOfOperation();
+    size_t getEncryptedSize(size_t plaintextSize) const;
 };
 
 class StreamModeOfOperation : public ModeOfOperation {
@@ -54,8 +136,34 @@ private:
 protected:
     StreamModeOfOperation(const BlockCipher &blockCipher);
 
+    // XORs each byte as soon as it arrives, keeping the unused part of the current keystream block between updates
+    class StreamContext : public ModeContext {
+    private:
+        StreamContext();
+
+    protected:
+        const StreamModeOfOperation &mode;
+        const DIRECTION direction;
+        uint8_t keystream[256];
+        size_t used;
+
+        StreamContext(const StreamModeOfOperation &mode, DIRECTION direction);
+        virtual void nextKeystream() = 0;
+        virtual void absorb(const uint8_t *ciphertext, size_t offset, size_t n);
+        virtual void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        virtual ~StreamContext();
+        virtual void init();
+        size_t update(const uint8_t *input, size_t size, uint8_t *output);
+        size_t final(uint8_t *output);
+        size_t getUpdateSize(size_t size) const;
+        size_t getFinalSize() const;
+    };
+
 public:
     virtual ~StreamModeOfOperation();
+    size_t getEncryptedSize(size_t plaintextSize) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,176 @@
+/**
+ * class implementation for CBC encryption of many independent messages at once, interleaved across the block cipher's batch path.
+ * @file MultiBufferCBC.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "MultiBufferCBC.hpp"
+
+/**
+ * copies one block 16 bytes at a time, a fixed size memcpy compiles to a single load and store
+ * while a variable size one goes through the library call, which dominates the cost of a round
+ *
+ * @param dst the destination block
+ * @param src the source block
+ * @param blockSize the number of bytes to copy
+ */
+static inline void copyBlock(uint8_t *dst, const uint8_t *src, uint8_t blockSize) {
+    uint8_t i = 0;
+
+    for (; i + 16 <= blockSize; i += 16)
+        memcpy(dst + i, src + i, 16);
+    for (; i < blockSize; i++)
+        dst[i] = src[i];
+}
+
+/**
+ * MultiBufferCBC primary constructor
+ *
+ * @param blockCipher a reference to a BlockCipher that will be used to encrypt data
+ * @param blockPadding a reference to a BlockPadding that will be used to pad every message to a multiple of blockSize
+ * @param lanes the number of messages whose blocks are encrypted together in each call to the block cipher
+ *
+ * @throws std::invalid_argument if blockCipher and blockPadding don't have the same blockSize or lanes is 0
+ */
+MultiBufferCBC::MultiBufferCBC(const BlockCipher &blockCipher, const BlockPadding &blockPadding, unsigned lanes) : blockCipher(blockCipher), blockPadding(blockPadding), lanes(lanes) {
+    if (blockCipher.getBlockSize() != blockPadding.getBlockSize())
+        throw std::invalid_argument("blockCipher and blockPadding must have the same blockSize");
+    if (lanes == 0)
+        throw std::invalid_argument("lanes must be at least 1");
+}
+
+/**
+ * MultiBufferCBC copy constructor
+ *
+ * @param that reference to a preexisting MultiBufferCBC object that should be copied
+ */
+MultiBufferCBC::MultiBufferCBC(const MultiBufferCBC &that) : MultiBufferCBC(that.blockCipher, that.blockPadding, that.lanes) {
+
+}
+
+/**
+ * MultiBufferCBC destructor
+ */
+MultiBufferCBC::~MultiBufferCBC() {
+
+}
+
+/**
+ * @param plaintextSize the number of plaintext bytes in one job
+ *
+ * @return the exact number of ciphertext bytes encrypt() writes for that job, including padding
+ */
+size_t MultiBufferCBC::getEncryptedSize(size_t plaintextSize) const {
+    return blockPadding.getPaddedSize(plaintextSize);
+}
+
+/**
+ * CBC encrypts every job with its own iv, the output of each job is identical to CBC::encrypt
+ * CBC is serial within one message, so instead the next block of each of [lanes] different jobs is encrypted in a
+ * single call to BlockCipher::encryptBlocks, when a job finishes its lane moves on to the next unstarted job
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param jobs the messages to encrypt, of any lengths, each ciphertext may be the same buffer as its plaintext
+ * @param njobs the number of jobs
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the lanes
+ */
+void MultiBufferCBC::encrypt(const Job jobs[], size_t njobs) const {
+    uint8_t blockSize, *batch, *output;
+    const uint8_t *input;
+    Lane *lane;
+    size_t nextJob = 0;
+    unsigned active = 0;
+
+    blockSize = blockCipher.getBlockSize();
+    try {
+        lane = new Lane[lanes];
+        batch = new uint8_t[lanes * blockSize];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    try {
+        // fill the lanes with the first jobs, a job that pads to nothing (zero padding of no data) has no blocks to encrypt
+        for (; active < lanes && nextJob < njobs; nextJob++)
+            if (getEncryptedSize(jobs[nextJob].size))
+                startJob(lane[active++], jobs[nextJob], nextJob);
+
+        while (active) {
+            // XOR the next block of every active job with its previous ciphertext block (or iv)
+            for (unsigned l = 0; l < active; l++) {
+                if (lane[l].block < lane[l].fullBlocks)
+                    input = jobs[lane[l].job].plaintext + lane[l].block * blockSize;
+                else
+                    input = lane[l].tail + (lane[l].block - lane[l].fullBlocks) * blockSize;
+
+                ModeOfOperation::xorBytes(batch + l * blockSize, input, lane[l].prev, blockSize);
+            }
+
+            // one block from each job, these do not depend on each other so the cipher can overlap them
+            blockCipher.encryptBlocks(batch, batch, active);
+
+            // each ciphertext block stays where it is written, so later blocks read it back as their chaining input
+            for (unsigned l = 0; l < active; l++) {
+                output = jobs[lane[l].job].ciphertext + lane[l].block * blockSize;
+                copyBlock(output, batch + l * blockSize, blockSize);
+                lane[l].prev = output;
+
+                if (++lane[l].block < lane[l].nblocks)
+                    continue;
+
+                // the job is done, start the next one in this lane or close the lane by moving the last one into it
+                while (nextJob < njobs && getEncryptedSize(jobs[nextJob].size) == 0)
+                    nextJob++;
+                if (nextJob < njobs) {
+                    startJob(lane[l], jobs[nextJob], nextJob);
+                    nextJob++;
+                } else {
+                    active--;
+                    lane[l] = lane[active];
+                    memcpy(batch + l * blockSize, batch + active * blockSize, blockSize);
+
+                    // the lane moved in came from later in the array, so its block still has to be stored this round
+                    l--;
+                }
+            }
+        }
+    } catch (std::bad_alloc &e) {
+        delete[] lane;
+        delete[] batch;
+        throw;
+    }
+
+    delete[] lane;
+    delete[] batch;
+}
+
+/**
+ * points a lane at the start of a job, copying its final 1 to blockSize bytes aside and padding them
+ * they are copied before any ciphertext is written in case the job encrypts in place
+ *
+ * @param lane the lane to set up
+ * @param job the job it will encrypt
+ * @param index the position of the job in the jobs array
+ */
+void MultiBufferCBC::startJob(Lane &lane, const Job &job, size_t index) const {
+    uint8_t blockSize;
+    size_t last;
+
+    blockSize = blockCipher.getBlockSize();
+    lane.job = index;
+    lane.block = 0;
+    lane.fullBlocks = job.size ? (job.size - 1) / blockSize : 0;
+    lane.nblocks = getEncryptedSize(job.size) / blockSize;
+    lane.prev = job.iv;
+
+    // an empty job has no last bytes to copy and may come with a null plaintext
+    last = job.size - lane.fullBlocks * blockSize;
+    if (last)
+        memcpy(lane.tail, job.plaintext + lane.fullBlocks * blockSize, last);
+
+    // depending on the padding scheme, an additional full block of padding may be needed
+    blockPadding.addPadding(lane.tail, last);
+}
@@ -0,0 +1,62 @@
+/**
+ * header file for CBC encryption of many independent messages at once, interleaved across the block cipher's batch path.
+ * @file MultiBufferCBC.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYMULTIBUFFERCBC
+#define MYMULTIBUFFERCBC
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include "ModeOfOperation.hpp"
+#include "../ciphers/BlockCipher.hpp"
+#include "../padding/BlockPadding.hpp"
+
+class MultiBufferCBC {
+public:
+    // one message: its iv, its plaintext, and room for getEncryptedSize(size) bytes of ciphertext
+    struct Job {
+        const uint8_t *iv;
+        const uint8_t *plaintext;
+        size_t size;
+        uint8_t *ciphertext;
+    };
+
+private:
+    // the state of the job a lane is working through
+    struct Lane {
+        size_t job;
+        size_t block;
+        size_t fullBlocks;
+        size_t nblocks;
+        const uint8_t *prev;
+        uint8_t tail[512];
+    };
+
+    const BlockCipher &blockCipher;
+    const BlockPadding &blockPadding;
+    unsigned lanes;
+
+    MultiBufferCBC();
+    MultiBufferCBC& operator=(const MultiBufferCBC &that) = delete;
+
+    void startJob(Lane &lane, const Job &job, size_t index) const;
+
+public:
+    // number of messages encrypted side by side, matching the 8 block batches of the AES-NI and bitsliced backends
+    static constexpr unsigned DEFAULT_LANES = 8;
+
+    MultiBufferCBC(const BlockCipher &blockCipher, const BlockPadding &blockPadding, unsigned lanes = DEFAULT_LANES);
+    MultiBufferCBC(const MultiBufferCBC &that);
+    ~MultiBufferCBC();
+
+    void encrypt(const Job jobs[], size_t njobs) const;
+    size_t getEncryptedSize(size_t plaintextSize) const;
+};
+
+#endif
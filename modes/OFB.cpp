@@ -42,6 +42,7 @@ OFB::~OFB() {
 
 /**
  * takes data from a plaintext stream, encrypts, and writes it to a ciphertext stream 
+ * the stream is read and written [ModeOfOperation::STREAM_CHUNK_SIZE] bytes at a time through a ModeContext
  * this algorithm is symmetrical so encryption = decryption
  *
  * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
@@ -52,65 +53,146 @@ OFB::~OFB() {
  * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
  */
 void OFB::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
-    uint8_t blockSize, *buffer, *prev, nbytes;
+    processStream(plaintext, ciphertext, ENCRYPT);
+}
+
+/**
+ * takes data from a ciphertext stream, decrypts, and writes it to a plaintext stream 
+ * this algorithm is symmetrical so encryption = decryption
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void OFB::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    encrypt(ciphertext, plaintext);
+}
+
+/**
+ * encrypts a contiguous buffer of plaintext without going through iostreams
+ * this algorithm is symmetrical so encryption = decryption
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to size
+ */
+size_t OFB::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize, keystream[KEYSTREAM_BYTES];
+    const uint8_t *prev = iv;
+    size_t offset = 0, nbytes;
 
     blockSize = blockCipher.getBlockSize();
-    try {
-        buffer = new uint8_t[blockSize];
-        prev = new uint8_t[blockSize];
-    } catch (std::bad_alloc &e) {
-        throw;
-    }
 
-    // read first block of plaintext
-    plaintext.read((char*) buffer, blockSize);
-    nbytes = plaintext.gcount();
+    if (kernel) {
+        memcpy(keystream, iv, blockSize);
+        kernel->ofb(keystream, plaintext, ciphertext, size / blockSize);
+        offset = size / blockSize * blockSize;
+        prev = keystream;
+    }
 
-    // prepare iv
-    for (uint8_t i = 0; i < blockSize; i++)
-        prev[i] = iv[i];
+    for (; offset < size; offset += nbytes) {
+        nbytes = size - offset < KEYSTREAM_BYTES / blockSize * blockSize ? size - offset : KEYSTREAM_BYTES / blockSize * blockSize;
+
+        // encrypt iv (again) for as many blocks as fit in the keystream buffer, then XOR them with the plaintext in one pass
+        for (size_t k = 0; k < nbytes; k += blockSize) {
+            blockCipher.encryptBlock(prev, keystream + k);
+            prev = keystream + k;
+        }
+        xorBytes(ciphertext + offset, plaintext + offset, keystream, nbytes);
+
+        // the last keystream block chains into the next buffer
+        if (prev != keystream) {
+            memmove(keystream, prev, blockSize);
+            prev = keystream;
+        }
+    }
 
-    while (plaintext.peek() != EOF) {
-        // encrypt iv (again)
-        blockCipher.encryptBlock(prev, prev);
+    return size;
+}
 
-        // XOR plaintext with this round's encrypted iv
-        for (uint8_t i = 0; i < blockSize; i++)
-            buffer[i] ^= prev[i];
+/**
+ * decrypts a contiguous buffer of ciphertext without going through iostreams
+ * this algorithm is symmetrical so encryption = decryption
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @return the number of plaintext bytes written, equal to size
+ */
+size_t OFB::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    return encrypt(ciphertext, size, plaintext);
+}
 
-        // write it to the output stream
-        ciphertext.write((char*) buffer, blockSize);
+/**
+ * starts an incremental encryption/decryption of one message, for data that arrives in pieces
+ * the context keeps a reference to this OFB, which must outlive it
+ *
+ * @param direction ModeOfOperation::ENCRYPT or ModeOfOperation::DECRYPT
+ *
+ * @return a heap allocated context ready for update(), the caller must delete it
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the context
+ */
+ModeContext* OFB::createContext(DIRECTION direction) const {
+    ModeContext *context;
 
-        // read next block of plaintext
-        plaintext.read((char*) buffer, blockSize);
-        nbytes = plaintext.gcount();
+    try {
+        context = new Context(*this, direction);
+    } catch (std::bad_alloc &e) {
+        throw;
     }
 
-    // encrypt iv (again)
-    blockCipher.encryptBlock(prev, prev);
+    return context;
+}
+
+/**
+ * OFB::Context primary constructor
+ *
+ * @param ofb the mode of operation whose cipher and iv are used
+ * @param direction whether the context encrypts or decrypts
+ */
+OFB::Context::Context(const OFB &ofb, DIRECTION direction) : StreamContext(ofb, direction), ofb(ofb) {
+    init();
+}
 
-    // XOR plaintext with this round's encrypted iv
-    for (uint8_t i = 0; i < nbytes; i++)
-        buffer[i] ^= prev[i];
-    
-    // write it to the output stream
-    ciphertext.write((char*) buffer, nbytes);
+/**
+ * OFB::Context destructor
+ */
+OFB::Context::~Context() {
 
-    delete buffer;
-    delete prev;
 }
 
 /**
- * takes data from a ciphertext stream, decrypts, and writes it to a plaintext stream 
- * this algorithm is symmetrical so encryption = decryption
- *
- * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
- *
- * @param ciphertext std::istream where data is retrieved for decryption
- * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ * marks the keystream as used up and restarts the output feedback from the iv
+ */
+void OFB::Context::init() {
+    StreamContext::init();
+    memcpy(keystream, ofb.iv, ofb.ivSize);
+}
+
+/**
+ * encrypts the previous keystream block (or iv) in place to get the next one
+ */
+void OFB::Context::nextKeystream() {
+    ofb.blockCipher.encryptBlock(keystream, keystream);
+}
+
+/**
+ * encrypts/decrypts whole blocks inside the kernel for the cipher when there is one, otherwise a block at a time
  *
- * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks, must not overlap input
+ * @param nblocks the number of blocks
  */
-void OFB::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
-    encrypt(ciphertext, plaintext);
-}
\ No newline at end of file
+void OFB::Context::processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks) {
+    if (ofb.kernel)
+        ofb.kernel->ofb(keystream, input, output, nblocks);
+    else
+        StreamContext::processBlocks(input, output, nblocks);
+}
@@ -19,12 +19,31 @@
 
 class OFB : public StreamModeOfOperation {
 private:
+    // bytes of keystream generated ahead of each XOR pass by the buffer API when there is no kernel for the cipher
+    static constexpr size_t KEYSTREAM_BYTES = 1024;
+
     uint8_t iv[256];
     uint8_t ivSize;
 
     OFB();
     OFB& operator=(const OFB &that) = delete;
 
+    class Context : public StreamContext {
+    private:
+        const OFB &ofb;
+
+        Context();
+
+    protected:
+        void nextKeystream();
+        void processBlocks(const uint8_t *input, uint8_t *output, size_t nblocks);
+
+    public:
+        Context(const OFB &ofb, DIRECTION direction);
+        ~Context();
+        void init();
+    };
+
 public:
     OFB(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize);
     OFB(const OFB &that);
@@ -32,6 +51,9 @@ public:
 
     void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
     void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    ModeContext* createContext(DIRECTION direction) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+/**
+ * class implementation for the CBC mode of operation with multi-threaded decryption.
+ * @file ParallelCBC.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ParallelCBC.hpp"
+
+/**
+ * ParallelCBC primary constructor
+ * encryption is inherited from CBC since each block depends on the one before it
+ *
+ * @param blockCipher a reference to a BlockCipher that will be used to encrypt/decrypt data, shared by every worker
+ * @param blockPadding a reference to a BlockPadding that will be used to pad/unpad data to a multiple of blockSize
+ * @param iv the iv used during encryption/decryption
+ * @param ivSize the size of the iv
+ * @param pool the worker threads that decrypt chunks of the stream
+ * @param chunkBlocks the number of blocks each worker decrypts at a time
+ *
+ * @throws std::invalid_argument if blockCipher, blockPadding and iv don't have the same size or chunkBlocks is 0
+ */
+ParallelCBC::ParallelCBC(const BlockCipher &blockCipher, const BlockPadding &blockPadding, const uint8_t iv[], uint8_t ivSize, WorkerPool &pool, size_t chunkBlocks) : CBC(blockCipher, blockPadding, iv, ivSize), pool(pool), chunkBlocks(chunkBlocks) {
+    if (chunkBlocks == 0)
+        throw std::invalid_argument("chunkBlocks must be at least 1");
+}
+
+/**
+ * ParallelCBC copy constructor
+ *
+ * @param that reference to a preexisting ParallelCBC object that should be copied, the copy shares its WorkerPool
+ */
+ParallelCBC::ParallelCBC(const ParallelCBC &that) : ParallelCBC(that.blockCipher, that.blockPadding, that.iv, that.ivSize, that.pool, that.chunkBlocks) {
+
+}
+
+/**
+ * ParallelCBC destructor
+ */
+ParallelCBC::~ParallelCBC() {
+
+}
+
+/**
+ * takes data from a ciphertext stream, decrypts and strips padding, and writes it to a plaintext stream
+ * one chunk per thread is read at a time, every chunk's preceding ciphertext block is already in the buffer
+ * so the chunks are decrypted concurrently and the output is identical to CBC::decrypt
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting and stripping padding
+ *
+ * @throws std::invalid_argument if the ciphertext is not a multiple of the block size or does not end in valid padding
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void ParallelCBC::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    uint8_t blockSize, *buffer, *output, *prev;
+    size_t chunkSize, roundSize, nblocks = 0, nbytes;
+    bool last;
+
+    blockSize = blockCipher.getBlockSize();
+    chunkSize = chunkBlocks * blockSize;
+    roundSize = pool.getThreadCount() * chunkSize;
+    try {
+        buffer = new uint8_t[roundSize];
+        output = new uint8_t[roundSize];
+        prev = new uint8_t[blockSize];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    // decrypts the jth chunk of the current round, chaining from the block before it
+    auto decryptPart = [&](size_t j) {
+        size_t begin = j * chunkSize;
+        size_t length = nblocks - j * chunkBlocks < chunkBlocks ? nblocks - j * chunkBlocks : chunkBlocks;
+
+        decryptChunk(buffer + begin, output + begin, j ? buffer + begin - blockSize : prev, length);
+    };
+
+    // prepare iv
+    for (uint8_t i = 0; i < blockSize; i++)
+        prev[i] = iv[i];
+
+    do {
+        // read the next round of chunks
+        ciphertext.read((char*) buffer, roundSize);
+        nbytes = ciphertext.gcount();
+        nblocks = nbytes / blockSize;
+        last = ciphertext.peek() == EOF;
+
+        // a short read only happens at the end of the stream, where a partial block would otherwise be dropped
+        if (nbytes % blockSize) {
+            delete[] buffer;
+            delete[] output;
+            delete[] prev;
+            throw std::invalid_argument("ciphertext size must be a multiple of blockSize");
+        }
+
+        if (nblocks == 0)
+            break;
+
+        // decrypt every chunk concurrently
+        pool.run((nblocks + chunkBlocks - 1) / chunkBlocks, decryptPart);
+
+        // save the last ciphertext block for the next round
+        for (uint8_t i = 0; i < blockSize; i++)
+            prev[i] = buffer[(nblocks - 1) * blockSize + i];
+
+        // strip padding from the final block and write the chunks to the output stream in order
+        nbytes = nblocks * blockSize;
+        if (last) {
+            try {
+                nbytes = getUnpaddedSize(output, nbytes);
+            } catch (std::invalid_argument &e) {
+                delete[] buffer;
+                delete[] output;
+                delete[] prev;
+                throw;
+            }
+        }
+        plaintext.write((char*) output, nbytes);
+    } while (!last);
+
+    delete[] buffer;
+    delete[] output;
+    delete[] prev;
+}
+
+/**
+ * decrypts and strips padding from a contiguous buffer of ciphertext without going through iostreams
+ * chunks of a separate output buffer are decrypted concurrently, in-place buffers are decrypted by CBC
+ * since a chunk could overwrite the ciphertext block that the next chunk chains from
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes, a multiple of the block size
+ * @param plaintext room for size bytes, either the same buffer as ciphertext or not overlapping it
+ *
+ * @return the number of plaintext bytes written after stripping padding
+ *
+ * @throws std::invalid_argument if size is not a multiple of the block size or the ciphertext does not end in valid padding
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the in-place scratch space
+ */
+size_t ParallelCBC::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+    size_t chunkSize = chunkBlocks * blockSize, nblocks = size / blockSize;
+
+    if (ciphertext == plaintext || size % blockSize || size == 0)
+        return CBC::decrypt(ciphertext, size, plaintext);
+
+    pool.run((nblocks + chunkBlocks - 1) / chunkBlocks, [&](size_t j) {
+        size_t begin = j * chunkSize;
+        size_t length = nblocks - j * chunkBlocks < chunkBlocks ? nblocks - j * chunkBlocks : chunkBlocks;
+
+        decryptChunk(ciphertext + begin, plaintext + begin, j ? ciphertext + begin - blockSize : iv, length);
+    });
+
+    return getUnpaddedSize(plaintext, size);
+}
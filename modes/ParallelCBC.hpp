@@ -0,0 +1,41 @@
+/**
+ * header file for the CBC mode of operation with multi-threaded decryption.
+ * @file ParallelCBC.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYPARALLELCBC
+#define MYPARALLELCBC
+
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include "CBC.hpp"
+#include "WorkerPool.hpp"
+#include "../ciphers/BlockCipher.hpp"
+#include "../padding/BlockPadding.hpp"
+
+class ParallelCBC : public CBC {
+private:
+    WorkerPool &pool;
+    size_t chunkBlocks;
+
+    ParallelCBC();
+    ParallelCBC& operator=(const ParallelCBC &that) = delete;
+
+public:
+    // number of blocks in the chunk handed to one worker, 4096 AES blocks are 64 KiB
+    static constexpr size_t DEFAULT_CHUNK_BLOCKS = 4096;
+
+    ParallelCBC(const BlockCipher &blockCipher, const BlockPadding &blockPadding, const uint8_t iv[], uint8_t ivSize, WorkerPool &pool, size_t chunkBlocks = DEFAULT_CHUNK_BLOCKS);
+    ParallelCBC(const ParallelCBC &that);
+    ~ParallelCBC();
+
+    void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+};
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * class implementation for the CFB mode of operation with multi-threaded decryption.
+ * @file ParallelCFB.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ParallelCFB.hpp"
+
+/**
+ * ParallelCFB primary constructor
+ * encryption is inherited from CFB since each keystream block depends on the ciphertext before it
+ *
+ * @param blockCipher a reference to a BlockCipher that will be used to encrypt/decrypt data, shared by every worker
+ * @param iv the iv used during encryption/decryption
+ * @param ivSize the size of the iv
+ * @param pool the worker threads that decrypt chunks of the stream
+ * @param chunkBlocks the number of blocks each worker decrypts at a time
+ *
+ * @throws std::invalid_argument if blockCipher and iv don't have the same size or chunkBlocks is 0
+ */
+ParallelCFB::ParallelCFB(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, WorkerPool &pool, size_t chunkBlocks) : CFB(blockCipher, iv, ivSize), pool(pool), chunkBlocks(chunkBlocks) {
+    if (chunkBlocks == 0)
+        throw std::invalid_argument("chunkBlocks must be at least 1");
+}
+
+/**
+ * ParallelCFB copy constructor
+ *
+ * @param that reference to a preexisting ParallelCFB object that should be copied, the copy shares its WorkerPool
+ */
+ParallelCFB::ParallelCFB(const ParallelCFB &that) : ParallelCFB(that.blockCipher, that.iv, that.ivSize, that.pool, that.chunkBlocks) {
+
+}
+
+/**
+ * ParallelCFB destructor
+ */
+ParallelCFB::~ParallelCFB() {
+
+}
+
+/**
+ * takes data from a ciphertext stream, decrypts, and writes it to a plaintext stream
+ * one chunk per thread is read at a time, every keystream input is ciphertext that is already in the buffer
+ * so the chunks are decrypted concurrently and the output is identical to CFB::decrypt
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void ParallelCFB::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    uint8_t blockSize, *buffer, *output, *prev;
+    size_t chunkSize, roundSize, nbytes = 0;
+
+    blockSize = blockCipher.getBlockSize();
+    chunkSize = chunkBlocks * blockSize;
+    roundSize = pool.getThreadCount() * chunkSize;
+    try {
+        buffer = new uint8_t[roundSize];
+        output = new uint8_t[roundSize];
+        prev = new uint8_t[blockSize];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    // decrypts the jth chunk of the current round, its first keystream input is the block before it
+    auto decryptPart = [&](size_t j) {
+        size_t begin = j * chunkSize;
+        size_t length = nbytes - begin < chunkSize ? nbytes - begin : chunkSize;
+
+        decryptChunk(buffer + begin, output + begin, j ? buffer + begin - blockSize : prev, length);
+    };
+
+    // prepare iv, which is the input to the first keystream block
+    for (uint8_t i = 0; i < blockSize; i++)
+        prev[i] = iv[i];
+
+    while (ciphertext.peek() != EOF) {
+        // read the next round of chunks
+        ciphertext.read((char*) buffer, roundSize);
+        nbytes = ciphertext.gcount();
+
+        // decrypt every chunk concurrently, then write them to the output stream in order
+        pool.run((nbytes + chunkSize - 1) / chunkSize, decryptPart);
+        plaintext.write((char*) output, nbytes);
+
+        // the last ciphertext block feeds the first keystream block of the next round
+        // a partial block can only occur at the end of the stream
+        if (nbytes == roundSize)
+            for (uint8_t i = 0; i < blockSize; i++)
+                prev[i] = buffer[roundSize - blockSize + i];
+    }
+
+    delete[] buffer;
+    delete[] output;
+    delete[] prev;
+}
+
+/**
+ * decrypts a contiguous buffer of ciphertext without going through iostreams
+ * chunks of a separate output buffer are decrypted concurrently, in-place buffers are decrypted by CFB
+ * since a chunk could overwrite the ciphertext block that the next chunk's keystream starts from
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes
+ * @param plaintext room for size bytes, either the same buffer as ciphertext or not overlapping it
+ *
+ * @return the number of plaintext bytes written, equal to size
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the in-place scratch space
+ */
+size_t ParallelCFB::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+    size_t chunkSize = chunkBlocks * blockSize;
+
+    if (ciphertext == plaintext)
+        return CFB::decrypt(ciphertext, size, plaintext);
+
+    pool.run((size + chunkSize - 1) / chunkSize, [&](size_t j) {
+        size_t begin = j * chunkSize;
+        size_t length = size - begin < chunkSize ? size - begin : chunkSize;
+
+        decryptChunk(ciphertext + begin, plaintext + begin, j ? ciphertext + begin - blockSize : iv, length);
+    });
+
+    return size;
+}
@@ -0,0 +1,40 @@
+/**
+ * header file for the CFB mode of operation with multi-threaded decryption.
+ * @file ParallelCFB.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYPARALLELCFB
+#define MYPARALLELCFB
+
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include "CFB.hpp"
+#include "WorkerPool.hpp"
+#include "../ciphers/BlockCipher.hpp"
+
+class ParallelCFB : public CFB {
+private:
+    WorkerPool &pool;
+    size_t chunkBlocks;
+
+    ParallelCFB();
+    ParallelCFB& operator=(const ParallelCFB &that) = delete;
+
+public:
+    // number of blocks in the chunk handed to one worker, 4096 AES blocks are 64 KiB
+    static constexpr size_t DEFAULT_CHUNK_BLOCKS = 4096;
+
+    ParallelCFB(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, WorkerPool &pool, size_t chunkBlocks = DEFAULT_CHUNK_BLOCKS);
+    ParallelCFB(const ParallelCFB &that);
+    ~ParallelCFB();
+
+    void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+};
+
+#endif
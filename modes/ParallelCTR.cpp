@@ -0,0 +1,171 @@
+/**
+ * class implementation for the multi-threaded CTR mode of operation.
+ * @file ParallelCTR.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ParallelCTR.hpp"
+
+/**
+ * ParallelCTR primary constructor
+ *
+ * @param blockCipher a reference to a BlockCipher that will be used to encrypt/decrypt data, shared by every worker
+ * @param iv the iv used during encryption/decryption
+ * @param ivSize the size of the iv
+ * @param pool the worker threads that encrypt chunks of the stream
+ * @param chunkBlocks the number of blocks each worker encrypts at a time
+ *
+ * @throws std::invalid_argument if blockCipher and iv don't have the same size or chunkBlocks is 0
+ */
+ParallelCTR::ParallelCTR(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, WorkerPool &pool, size_t chunkBlocks) : CTR(blockCipher, iv, ivSize), pool(pool), chunkBlocks(chunkBlocks) {
+    if (chunkBlocks == 0)
+        throw std::invalid_argument("chunkBlocks must be at least 1");
+}
+
+/**
+ * ParallelCTR copy constructor
+ *
+ * @param that reference to a preexisting ParallelCTR object that should be copied, the copy shares its WorkerPool
+ */
+ParallelCTR::ParallelCTR(const ParallelCTR &that) : ParallelCTR(that.blockCipher, that.iv, that.ivSize, that.pool, that.chunkBlocks) {
+
+}
+
+/**
+ * ParallelCTR destructor
+ */
+ParallelCTR::~ParallelCTR() {
+
+}
+
+/**
+ * takes data from a plaintext stream, encrypts, and writes it to a ciphertext stream
+ * one chunk per thread is read at a time, each worker starts its chunk at iv + (index of the chunk's first block)
+ * so the output is identical to CTR::encrypt
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param plaintext std::istream where data is retrieved for encryption
+ * @param ciphertext std::ostream where data is sent after encrypting
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void ParallelCTR::encrypt(std::istream &plaintext, std::ostream &ciphertext) const {
+    uint8_t blockSize, *buffer, *keystream;
+    size_t chunkSize, roundSize, nbytes = 0;
+    uint64_t blocksDone = 0;
+
+    blockSize = blockCipher.getBlockSize();
+    chunkSize = chunkBlocks * blockSize;
+    roundSize = pool.getThreadCount() * chunkSize;
+    try {
+        buffer = new uint8_t[roundSize];
+        keystream = new uint8_t[roundSize];
+    } catch (std::bad_alloc &e) {
+        throw;
+    }
+
+    // encrypts the jth chunk of the current round in place, chunks do not overlap so workers never share bytes
+    auto encryptChunk = [&](size_t j) {
+        size_t begin = j * chunkSize;
+        size_t length = nbytes - begin < chunkSize ? nbytes - begin : chunkSize;
+        size_t nblocks = (length + blockSize - 1) / blockSize;
+        uint8_t ctr[256], *chunkKeystream = keystream + begin;
+
+        // jump the iv/ctr ahead to this chunk's first block
+        for (uint8_t i = 0; i < blockSize; i++)
+            ctr[i] = iv[i];
+        addCounter(ctr, blockSize, blocksDone + j * chunkBlocks);
+
+        // encrypt one iv/ctr per block and XOR them into the plaintext
+        generateKeystream(ctr, chunkKeystream, nblocks);
+        xorBytes(buffer + begin, buffer + begin, chunkKeystream, length);
+    };
+
+    while (plaintext.peek() != EOF) {
+        // read the next round of chunks
+        plaintext.read((char*) buffer, roundSize);
+        nbytes = plaintext.gcount();
+
+        // encrypt every chunk concurrently, then write them back in order
+        pool.run((nbytes + chunkSize - 1) / chunkSize, encryptChunk);
+        ciphertext.write((char*) buffer, nbytes);
+
+        // only the final round can end in a partial block
+        blocksDone += nbytes / blockSize;
+    }
+
+    delete[] buffer;
+    delete[] keystream;
+}
+
+/**
+ * takes data from a ciphertext stream, decrypts, and writes it to a plaintext stream
+ *
+ * algorithm briefly described at: https://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * @param ciphertext std::istream where data is retrieved for decryption
+ * @param plaintext std::ostream where data is sent after decrypting
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+void ParallelCTR::decrypt(std::istream &ciphertext, std::ostream &plaintext) const {
+    encrypt(ciphertext, plaintext);
+}
+
+/**
+ * encrypts a contiguous buffer of plaintext without going through iostreams
+ * the buffer is split into chunks that are encrypted concurrently, each starting at its own counter value
+ *
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ *
+ * @return the number of ciphertext bytes written, equal to size
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the keystream
+ */
+size_t ParallelCTR::encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    uint8_t blockSize = blockCipher.getBlockSize();
+    size_t chunkSize = chunkBlocks * blockSize;
+
+    pool.run((size + chunkSize - 1) / chunkSize, [&](size_t j) {
+        size_t begin = j * chunkSize;
+        size_t length = size - begin < chunkSize ? size - begin : chunkSize;
+        uint8_t ctr[256], *keystream;
+
+        try {
+            keystream = new uint8_t[chunkSize];
+        } catch (std::bad_alloc &e) {
+            throw;
+        }
+
+        // jump the iv/ctr ahead to this chunk's first block
+        for (uint8_t i = 0; i < blockSize; i++)
+            ctr[i] = iv[i];
+        addCounter(ctr, blockSize, j * chunkBlocks);
+
+        generateKeystream(ctr, keystream, (length + blockSize - 1) / blockSize);
+        xorBytes(ciphertext + begin, plaintext + begin, keystream, length);
+
+        delete[] keystream;
+    });
+
+    return size;
+}
+
+/**
+ * decrypts a contiguous buffer of ciphertext without going through iostreams
+ *
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @return the number of plaintext bytes written, equal to size
+ *
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the keystream
+ */
+size_t ParallelCTR::decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    return encrypt(ciphertext, size, plaintext);
+}
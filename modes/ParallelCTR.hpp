@@ -0,0 +1,42 @@
+/**
+ * header file for the multi-threaded CTR mode of operation.
+ * @file ParallelCTR.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYPARALLELCTR
+#define MYPARALLELCTR
+
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include "CTR.hpp"
+#include "WorkerPool.hpp"
+#include "../ciphers/BlockCipher.hpp"
+
+class ParallelCTR : public CTR {
+private:
+    WorkerPool &pool;
+    size_t chunkBlocks;
+
+    ParallelCTR();
+    ParallelCTR& operator=(const ParallelCTR &that) = delete;
+
+public:
+    // number of blocks in the chunk handed to one worker, 4096 AES blocks are 64 KiB
+    static constexpr size_t DEFAULT_CHUNK_BLOCKS = 4096;
+
+    ParallelCTR(const BlockCipher &blockCipher, const uint8_t iv[], uint8_t ivSize, WorkerPool &pool, size_t chunkBlocks = DEFAULT_CHUNK_BLOCKS);
+    ParallelCTR(const ParallelCTR &that);
+    ~ParallelCTR();
+
+    void encrypt(std::istream &plaintext, std::ostream &ciphertext) const;
+    void decrypt(std::istream &ciphertext, std::ostream &plaintext) const;
+    size_t encrypt(const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    size_t decrypt(const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+};
+
+#endif
@@ -0,0 +1,555 @@
+/**
+ * class implementation for the io_uring file pipeline that overlaps disk reads and writes with encryption/decryption.
+ * @file UringPipeline.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "UringPipeline.hpp"
+
+#if defined(__linux__)
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// liburing is not required, the three io_uring system calls are made directly
+static int ioUringSetup(unsigned entries, io_uring_params *params) {
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static int ioUringRegister(int fd, unsigned opcode, const void *arg, unsigned nargs) {
+    return syscall(__NR_io_uring_register, fd, opcode, arg, nargs);
+}
+
+/**
+ * UringPipeline primary constructor, sets up the ring and registers depth pairs of input/output buffers with the kernel
+ *
+ * @param mode the mode of operation used to encrypt/decrypt, it must outlive the pipeline
+ * @param depth the number of chunks that can be read, processed, or written at the same time
+ * @param chunkSize the number of bytes read at a time
+ *
+ * @throws std::invalid_argument if depth is 0 or chunkSize is 0 or larger than 1 GiB
+ * @throws std::system_error if the kernel does not support io_uring or the buffers cannot be registered
+ * @throws std::bad_alloc if unable to allocate memory on the heap for buffers
+ */
+UringPipeline::UringPipeline(const ModeOfOperation &mode, unsigned depth, size_t chunkSize) : mode(mode), depth(depth), chunkSize(chunkSize), ringFd(-1), sqRing(nullptr), cqRing(nullptr), sqes(nullptr), buffers(nullptr), slots(nullptr), toSubmit(0), inFlight(0) {
+    iovec *iovecs;
+
+    if (depth == 0)
+        throw std::invalid_argument("depth must be at least 1");
+    if (chunkSize == 0 || chunkSize > (1 << 30))
+        throw std::invalid_argument("chunkSize must be between 1 byte and 1 GiB");
+
+    // output buffers have room for the block a context can hold back from the previous chunk plus padding
+    try {
+        buffers = new uint8_t[depth * (2 * chunkSize + 512)];
+        slots = new Slot[depth];
+        iovecs = new iovec[2 * depth];
+    } catch (std::bad_alloc &e) {
+        delete[] buffers;
+        delete[] slots;
+        throw;
+    }
+
+    for (unsigned i = 0; i < depth; i++) {
+        slots[i].input = buffers + i * (2 * chunkSize + 512);
+        slots[i].output = slots[i].input + chunkSize;
+        slots[i].state = Slot::FREE;
+        iovecs[2 * i].iov_base = slots[i].input;
+        iovecs[2 * i].iov_len = chunkSize;
+        iovecs[2 * i + 1].iov_base = slots[i].output;
+        iovecs[2 * i + 1].iov_len = chunkSize + 512;
+    }
+
+    try {
+        setupRing();
+    } catch (...) {
+        delete[] iovecs;
+        delete[] buffers;
+        delete[] slots;
+        throw;
+    }
+
+    // registered buffers are pinned once instead of on every read and write
+    if (ioUringRegister(ringFd, IORING_REGISTER_BUFFERS, iovecs, 2 * depth) < 0) {
+        int error = errno;
+        delete[] iovecs;
+        teardownRing();
+        delete[] buffers;
+        delete[] slots;
+        throw std::system_error(error, std::generic_category(), "cannot register io_uring buffers");
+    }
+
+    delete[] iovecs;
+}
+
+/**
+ * UringPipeline copy constructor
+ *
+ * @param that reference to a preexisting UringPipeline object whose mode, depth, and chunk size should be copied, the copy gets its own ring
+ */
+UringPipeline::UringPipeline(const UringPipeline &that) : UringPipeline(that.mode, that.depth, that.chunkSize) {
+
+}
+
+/**
+ * UringPipeline destructor
+ */
+UringPipeline::~UringPipeline() {
+    teardownRing();
+    delete[] buffers;
+    delete[] slots;
+}
+
+/**
+ * checks whether the running kernel allows io_uring, it may be missing or disabled for unprivileged processes
+ *
+ * @return true if a ring can be created
+ */
+bool UringPipeline::isSupported() {
+    io_uring_params params;
+    int fd;
+
+    memset(&params, 0, sizeof(params));
+    fd = ioUringSetup(1, &params);
+    if (fd < 0)
+        return false;
+
+    close(fd);
+    return true;
+}
+
+/**
+ * creates the ring and maps its submission queue, completion queue, and submission entries
+ *
+ * @throws std::system_error if the ring cannot be created or mapped
+ */
+void UringPipeline::setupRing() {
+    io_uring_params params;
+    uint8_t *sq, *cq;
+    int error;
+
+    memset(&params, 0, sizeof(params));
+    ringFd = ioUringSetup(2 * depth, &params);
+    if (ringFd < 0)
+        throw std::system_error(errno, std::generic_category(), "cannot create io_uring");
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    // newer kernels map both queues with a single call
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (cqRingSize > sqRingSize)
+            sqRingSize = cqRingSize;
+        cqRingSize = sqRingSize;
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        error = errno;
+        sqRing = nullptr;
+        teardownRing();
+        throw std::system_error(error, std::generic_category(), "cannot map io_uring");
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cqRing = sqRing;
+    } else {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            error = errno;
+            cqRing = nullptr;
+            teardownRing();
+            throw std::system_error(error, std::generic_category(), "cannot map io_uring");
+        }
+    }
+
+    sqes = (io_uring_sqe*) mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        error = errno;
+        sqes = nullptr;
+        teardownRing();
+        throw std::system_error(error, std::generic_category(), "cannot map io_uring");
+    }
+
+    sq = (uint8_t*) sqRing;
+    cq = (uint8_t*) cqRing;
+    sqHead = (unsigned*) (sq + params.sq_off.head);
+    sqTail = (unsigned*) (sq + params.sq_off.tail);
+    sqMask = (unsigned*) (sq + params.sq_off.ring_mask);
+    sqArray = (unsigned*) (sq + params.sq_off.array);
+    cqHead = (unsigned*) (cq + params.cq_off.head);
+    cqTail = (unsigned*) (cq + params.cq_off.tail);
+    cqMask = (unsigned*) (cq + params.cq_off.ring_mask);
+    cqes = (io_uring_cqe*) (cq + params.cq_off.cqes);
+}
+
+/**
+ * unmaps and closes whatever part of the ring has been set up
+ */
+void UringPipeline::teardownRing() {
+    if (sqes)
+        munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing)
+        munmap(sqRing, sqRingSize);
+    if (ringFd >= 0)
+        close(ringFd);
+
+    sqes = nullptr;
+    cqRing = nullptr;
+    sqRing = nullptr;
+    ringFd = -1;
+}
+
+/**
+ * encrypts a whole file, reading the next chunks and writing the previous ones while the current one is encrypted
+ * the output is identical to mode.encrypt()
+ *
+ * @param plaintextPath the file to encrypt
+ * @param ciphertextPath the file to create or overwrite with the ciphertext, it must not be the plaintext file
+ *
+ * @throws std::system_error if either file cannot be opened or a read or write fails
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the mode's context
+ */
+void UringPipeline::encryptFile(const std::string &plaintextPath, const std::string &ciphertextPath) {
+    run(plaintextPath, ciphertextPath, ModeOfOperation::ENCRYPT);
+}
+
+/**
+ * decrypts a whole file, reading the next chunks and writing the previous ones while the current one is decrypted
+ * the output is identical to mode.decrypt()
+ *
+ * @param ciphertextPath the file to decrypt
+ * @param plaintextPath the file to create or overwrite with the plaintext, it must not be the ciphertext file
+ *
+ * @throws std::invalid_argument if the ciphertext is not a multiple of the block size for a block mode of operation
+ * @throws std::system_error if either file cannot be opened or a read or write fails
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the mode's context
+ */
+void UringPipeline::decryptFile(const std::string &ciphertextPath, const std::string &plaintextPath) {
+    run(ciphertextPath, plaintextPath, ModeOfOperation::DECRYPT);
+}
+
+/**
+ * the pipeline: every free slot reads the next chunk of the input, chunks that have arrived are passed through the
+ * mode's context strictly in file order, and each result is written at the next output offset
+ * the kernel works on up to depth reads and writes while this thread runs the cipher
+ *
+ * @param inputPath the file to read
+ * @param outputPath the file to create or overwrite
+ * @param direction whether to encrypt or decrypt
+ *
+ * @throws std::invalid_argument if the context rejects the input, see ModeContext::final()
+ * @throws std::system_error if either file cannot be opened or a read or write fails
+ * @throws std::bad_alloc if unable to allocate memory on the heap for the mode's context
+ */
+void UringPipeline::run(const std::string &inputPath, const std::string &outputPath, ModeOfOperation::DIRECTION direction) {
+    ModeContext *context;
+    struct stat info;
+    uint64_t fileSize, readOffset = 0, writeOffset = 0, nextSequence = 0, nextProcess = 0;
+    int inputFd, outputFd;
+    bool progress;
+
+    inputFd = open(inputPath.c_str(), O_RDONLY);
+    if (inputFd < 0)
+        throw std::system_error(errno, std::generic_category(), "cannot open " + inputPath);
+    if (fstat(inputFd, &info) < 0) {
+        int error = errno;
+        close(inputFd);
+        throw std::system_error(error, std::generic_category(), "cannot stat " + inputPath);
+    }
+    fileSize = info.st_size;
+
+    outputFd = open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outputFd < 0) {
+        int error = errno;
+        close(inputFd);
+        throw std::system_error(error, std::generic_category(), "cannot create " + outputPath);
+    }
+
+    try {
+        context = mode.createContext(direction);
+    } catch (std::bad_alloc &e) {
+        close(inputFd);
+        close(outputFd);
+        throw;
+    }
+
+    try {
+        while (true) {
+            // keep every free slot reading ahead
+            for (unsigned i = 0; i < depth && readOffset < fileSize; i++) {
+                if (slots[i].state != Slot::FREE)
+                    continue;
+
+                slots[i].offset = readOffset;
+                slots[i].length = fileSize - readOffset < chunkSize ? fileSize - readOffset : chunkSize;
+                slots[i].sequence = nextSequence++;
+                slots[i].done = 0;
+                readOffset += slots[i].length;
+                submitRead(i, inputFd);
+            }
+
+            // chaining state flows through the context, so chunks are processed in the order they appear in the file
+            do {
+                progress = false;
+                for (unsigned i = 0; i < depth; i++) {
+                    if (slots[i].state != Slot::READY || slots[i].sequence != nextProcess)
+                        continue;
+
+                    slots[i].length = context->update(slots[i].input, slots[i].length, slots[i].output);
+                    slots[i].offset = writeOffset;
+                    slots[i].done = 0;
+                    writeOffset += slots[i].length;
+                    nextProcess++;
+                    progress = true;
+
+                    if (slots[i].length)
+                        submitWrite(i, outputFd);
+                    else
+                        slots[i].state = Slot::FREE;
+                }
+            } while (progress);
+
+            if (readOffset >= fileSize && nextProcess == nextSequence)
+                break;
+
+            // a context can hold back a whole chunk (the last block, or GCM's tag), which frees its slot without a
+            // write, so the free slots go back to reading instead of waiting on an empty ring
+            if (inFlight == 0)
+                continue;
+
+            wait();
+            reap(inputFd, outputFd);
+        }
+
+        // the final padded/unpadded block goes out through the first slot once it is free, every slot is either
+        // free or writing here and a write is always in flight
+        while (slots[0].state == Slot::WRITING) {
+            wait();
+            reap(inputFd, outputFd);
+        }
+
+        slots[0].length = context->final(slots[0].output);
+        slots[0].offset = writeOffset;
+        slots[0].done = 0;
+        if (slots[0].length)
+            submitWrite(0, outputFd);
+
+        while (inFlight) {
+            wait();
+            reap(inputFd, outputFd);
+        }
+    } catch (...) {
+        // the kernel may still be using the buffers, so every operation must complete before they can be reused
+        drain();
+        for (unsigned i = 0; i < depth; i++)
+            slots[i].state = Slot::FREE;
+
+        delete context;
+        close(inputFd);
+        close(outputFd);
+        throw;
+    }
+
+    delete context;
+    close(inputFd);
+    close(outputFd);
+}
+
+/**
+ * queues a read of the rest of a slot's chunk into its input buffer
+ *
+ * @param index the slot
+ * @param fd the input file
+ */
+void UringPipeline::submitRead(unsigned index, int fd) {
+    Slot &slot = slots[index];
+
+    slot.state = Slot::READING;
+    submit(IORING_OP_READ_FIXED, index, fd, slot.input + slot.done, slot.length - slot.done, slot.offset + slot.done);
+}
+
+/**
+ * queues a write of the rest of a slot's output buffer
+ *
+ * @param index the slot
+ * @param fd the output file
+ */
+void UringPipeline::submitWrite(unsigned index, int fd) {
+    Slot &slot = slots[index];
+
+    slot.state = Slot::WRITING;
+    submit(IORING_OP_WRITE_FIXED, index, fd, slot.output + slot.done, slot.length - slot.done, slot.offset + slot.done);
+}
+
+/**
+ * fills in the next submission queue entry, it is handed to the kernel by the next wait()
+ *
+ * @param opcode IORING_OP_READ_FIXED or IORING_OP_WRITE_FIXED
+ * @param index the slot, reads use registered buffer 2 * index and writes 2 * index + 1
+ * @param fd the file to read or write
+ * @param buffer where the data goes or comes from, inside the slot's registered buffer
+ * @param length the number of bytes
+ * @param offset the position in the file
+ */
+void UringPipeline::submit(uint8_t opcode, unsigned index, int fd, uint8_t *buffer, size_t length, uint64_t offset) {
+    unsigned tail, entry;
+    io_uring_sqe *sqe;
+
+    tail = *sqTail;
+    entry = tail & *sqMask;
+    sqe = &sqes[entry];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) buffer;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->buf_index = 2 * index + (opcode == IORING_OP_WRITE_FIXED);
+    sqe->user_data = index;
+    sqArray[entry] = entry;
+
+    // the entry must be complete before the kernel can see the new tail
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    toSubmit++;
+    inFlight++;
+}
+
+/**
+ * hands the queued entries to the kernel and sleeps until at least one operation completes
+ *
+ * @throws std::system_error if io_uring_enter fails
+ */
+void UringPipeline::wait() {
+    int submitted;
+
+    do {
+        submitted = ioUringEnter(ringFd, toSubmit, 1, IORING_ENTER_GETEVENTS);
+    } while (submitted < 0 && errno == EINTR);
+
+    if (submitted < 0)
+        throw std::system_error(errno, std::generic_category(), "io_uring_enter failed");
+
+    toSubmit -= submitted;
+}
+
+/**
+ * handles every completed operation: a finished read makes its chunk ready, a finished write frees its slot,
+ * and a short read or write is resubmitted for the remaining bytes
+ *
+ * @param inputFd the input file, for resubmitting short reads
+ * @param outputFd the output file, for resubmitting short writes
+ *
+ * @throws std::system_error if a read or write failed
+ */
+void UringPipeline::reap(int inputFd, int outputFd) {
+    unsigned head, tail;
+    int result;
+
+    head = *cqHead;
+    tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        const io_uring_cqe &cqe = cqes[head & *cqMask];
+        Slot &slot = slots[cqe.user_data];
+
+        result = cqe.res;
+        inFlight--;
+
+        // the entry is consumed before anything can throw so the kernel may reuse it
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+
+        if (result < 0) {
+            const char *what = slot.state == Slot::READING ? "read failed" : "write failed";
+            slot.state = Slot::FREE;
+            throw std::system_error(-result, std::generic_category(), what);
+        }
+
+        slot.done += result;
+        if (slot.state == Slot::READING) {
+            // a read of 0 bytes means the file shrank since it was measured
+            if (slot.done == slot.length || result == 0) {
+                slot.length = slot.done;
+                slot.state = Slot::READY;
+            } else {
+                submitRead(cqe.user_data, inputFd);
+            }
+        } else {
+            if (slot.done == slot.length)
+                slot.state = Slot::FREE;
+            else
+                submitWrite(cqe.user_data, outputFd);
+        }
+    }
+}
+
+/**
+ * waits for every operation in flight, ignoring their results
+ */
+void UringPipeline::drain() {
+    unsigned head, tail;
+    int submitted;
+
+    while (inFlight) {
+        do {
+            submitted = ioUringEnter(ringFd, toSubmit, 1, IORING_ENTER_GETEVENTS);
+        } while (submitted < 0 && errno == EINTR);
+        if (submitted < 0)
+            return;
+        toSubmit -= submitted;
+
+        head = *cqHead;
+        tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            slots[cqes[head & *cqMask].user_data].state = Slot::FREE;
+            inFlight--;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+#else
+
+/**
+ * UringPipeline primary constructor for systems without io_uring
+ *
+ * @throws std::system_error always since io_uring only exists on Linux
+ */
+UringPipeline::UringPipeline(const ModeOfOperation &mode, unsigned depth, size_t chunkSize) : mode(mode), depth(depth), chunkSize(chunkSize), ringFd(-1), sqRing(nullptr), cqRing(nullptr), sqes(nullptr), buffers(nullptr), slots(nullptr), toSubmit(0), inFlight(0) {
+    throw std::system_error(ENOSYS, std::generic_category(), "io_uring is only available on Linux");
+}
+
+UringPipeline::UringPipeline(const UringPipeline &that) : UringPipeline(that.mode, that.depth, that.chunkSize) {
+
+}
+
+UringPipeline::~UringPipeline() {
+
+}
+
+bool UringPipeline::isSupported() {
+    return false;
+}
+
+void UringPipeline::encryptFile(const std::string &, const std::string &) {
+
+}
+
+void UringPipeline::decryptFile(const std::string &, const std::string &) {
+
+}
+
+#endif
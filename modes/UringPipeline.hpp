@@ -0,0 +1,96 @@
+/**
+ * header file for the io_uring file pipeline that overlaps disk reads and writes with encryption/decryption.
+ * @file UringPipeline.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYURINGPIPELINE
+#define MYURINGPIPELINE
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <string>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include "ModeOfOperation.hpp"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+class UringPipeline {
+private:
+    // one chunk of the file, its input is read into, and its output written from, a registered buffer
+    struct Slot {
+        enum STATE : uint8_t {
+            FREE,
+            READING,
+            READY,
+            WRITING
+        };
+
+        uint8_t *input;
+        uint8_t *output;
+        uint64_t offset;
+        uint64_t sequence;
+        size_t length;
+        size_t done;
+        STATE state;
+    };
+
+    const ModeOfOperation &mode;
+    unsigned depth;
+    size_t chunkSize;
+
+    int ringFd;
+    void *sqRing;
+    void *cqRing;
+    size_t sqRingSize;
+    size_t cqRingSize;
+    io_uring_sqe *sqes;
+    size_t sqesSize;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    io_uring_cqe *cqes;
+
+    uint8_t *buffers;
+    Slot *slots;
+    unsigned toSubmit;
+    unsigned inFlight;
+
+    UringPipeline();
+    UringPipeline& operator=(const UringPipeline &that) = delete;
+
+    void setupRing();
+    void teardownRing();
+    void run(const std::string &inputPath, const std::string &outputPath, ModeOfOperation::DIRECTION direction);
+    void submitRead(unsigned index, int fd);
+    void submitWrite(unsigned index, int fd);
+    void submit(uint8_t opcode, unsigned index, int fd, uint8_t *buffer, size_t length, uint64_t offset);
+    void wait();
+    void reap(int inputFd, int outputFd);
+    void drain();
+
+public:
+    // number of chunks in flight at once and the size of each one
+    static constexpr unsigned DEFAULT_DEPTH = 8;
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+    UringPipeline(const ModeOfOperation &mode, unsigned depth = DEFAULT_DEPTH, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    UringPipeline(const UringPipeline &that);
+    ~UringPipeline();
+
+    void encryptFile(const std::string &plaintextPath, const std::string &ciphertextPath);
+    void decryptFile(const std::string &ciphertextPath, const std::string &plaintextPath);
+
+    static bool isSupported();
+};
+
+#endif
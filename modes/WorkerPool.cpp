@@ -0,0 +1,147 @@
+/**
+ * class implementation for the fixed-size pool of worker threads shared by the parallel modes of operation.
+ * @file WorkerPool.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "WorkerPool.hpp"
+
+/**
+ * WorkerPool primary constructor
+ * the thread calling run() takes part in the work, so nThreads - 1 worker threads are started
+ *
+ * @param nThreads the total number of threads working on each run(), or 0 to use every hardware thread
+ *
+ * @throws std::system_error if a worker thread cannot be started
+ */
+WorkerPool::WorkerPool(unsigned nThreads) : task(nullptr), nTasks(0), nextTask(0), nFinished(0), generation(0), stopping(false) {
+    if (nThreads == 0)
+        nThreads = std::thread::hardware_concurrency();
+    if (nThreads == 0)
+        nThreads = 1;
+
+    try {
+        for (unsigned i = 1; i < nThreads; i++)
+            workers.emplace_back(&WorkerPool::workerLoop, this);
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread &worker : workers)
+            worker.join();
+        throw;
+    }
+}
+
+/**
+ * WorkerPool destructor, stops and joins every worker thread
+ */
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+/**
+ * @return the total number of threads that work on each run(), including the caller
+ */
+unsigned WorkerPool::getThreadCount() const {
+    return workers.size() + 1;
+}
+
+/**
+ * calls task(0) through task(nTasks - 1) spread across the pool and returns once every call has finished
+ * tasks are handed out in increasing order, but may complete in any order
+ *
+ * @param nTasks the number of task indices to run
+ * @param task the function to call with each index, it must be safe to call concurrently
+ *
+ * @throws the first exception thrown by a task, after all other tasks have finished
+ */
+void WorkerPool::run(size_t nTasks, const std::function<void(size_t)> &task) {
+    if (nTasks == 0)
+        return;
+
+    std::lock_guard<std::mutex> runLock(runMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->nTasks = nTasks;
+        nextTask = 0;
+        nFinished = 0;
+        error = nullptr;
+        generation++;
+    }
+    wake.notify_all();
+
+    work();
+
+    std::exception_ptr failure;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return nFinished == this->nTasks; });
+        this->task = nullptr;
+        failure = error;
+        error = nullptr;
+    }
+
+    if (failure)
+        std::rethrow_exception(failure);
+}
+
+/**
+ * body of each worker thread: sleep until run() publishes new tasks, help finish them, repeat until destruction
+ */
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        work();
+    }
+}
+
+/**
+ * claims task indices one at a time and runs them until none are left
+ */
+void WorkerPool::work() {
+    while (true) {
+        const std::function<void(size_t)> *current;
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!task || nextTask >= nTasks)
+                return;
+            current = task;
+            index = nextTask++;
+        }
+
+        try {
+            (*current)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (++nFinished == nTasks)
+            done.notify_all();
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * header file for the fixed-size pool of worker threads shared by the parallel modes of operation.
+ * @file WorkerPool.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYWORKERPOOL
+#define MYWORKERPOOL
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+
+class WorkerPool {
+private:
+    WorkerPool(const WorkerPool &that) = delete;
+    WorkerPool& operator=(const WorkerPool &that) = delete;
+
+public:
+    WorkerPool(unsigned nThreads = 0);
+    ~WorkerPool();
+
+    void run(size_t nTasks, const std::function<void(size_t)> &task);
+    unsigned getThreadCount() const;
+
+private:
+    std::vector<std::thread> workers;
+
+    // serializes calls to run() so that one pool can be shared by several modes of operation
+    std::mutex runMutex;
+
+    // guards every member below and signals workers (wake) and the caller of run() (done)
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t)> *task;
+    size_t nTasks;
+    size_t nextTask;
+    size_t nFinished;
+    uint64_t generation;
+    bool stopping;
+    std::exception_ptr error;
+
+    void workerLoop();
+    void work();
+};
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * class implementation for the XTS (IEEE 1619) mode of operation, which encrypts every sector independently.
+ * @file XTS.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "XTS.hpp"
+
+/**
+ * reads 8 bytes as a little-endian integer
+ *
+ * @param bytes the 8 bytes
+ *
+ * @return the integer
+ */
+static inline uint64_t loadLittleEndian(const uint8_t bytes[]) {
+    uint64_t value = 0;
+
+    for (int i = 7; i >= 0; i--)
+        value = (value << 8) | bytes[i];
+
+    return value;
+}
+
+/**
+ * writes an integer as 8 little-endian bytes
+ *
+ * @param bytes room for 8 bytes
+ * @param value the integer
+ */
+static inline void storeLittleEndian(uint8_t bytes[], uint64_t value) {
+    for (int i = 0; i < 8; i++, value >>= 8)
+        bytes[i] = value;
+}
+
+/**
+ * multiplies a tweak by the primitive element alpha of GF(2^128), a one bit shift of the little-endian
+ * 128 bit integer with the bit shifted out folded back in by the polynomial x^128 + x^7 + x^2 + x + 1
+ *
+ * @param tweak the low and high halves of the tweak
+ */
+static inline void multiplyAlpha(uint64_t tweak[2]) {
+    uint64_t carry = tweak[1] >> 63;
+
+    tweak[1] = (tweak[1] << 1) | (tweak[0] >> 63);
+    tweak[0] = (tweak[0] << 1) ^ (0x87 & (0 - carry));
+}
+
+/**
+ * XTS primary constructor
+ * IEEE 1619 requires the two ciphers to be keyed with different keys
+ *
+ * @param dataCipher a reference to a BlockCipher with a 128 bit block, keyed with the first half of the XTS key
+ * @param tweakCipher a reference to a BlockCipher with a 128 bit block, keyed with the second half of the XTS key
+ *
+ * @throws std::invalid_argument if either cipher does not have a 16 byte block
+ */
+XTS::XTS(const BlockCipher &dataCipher, const BlockCipher &tweakCipher) : dataCipher(dataCipher), tweakCipher(tweakCipher) {
+    if (dataCipher.getBlockSize() != 16 || tweakCipher.getBlockSize() != 16)
+        throw std::invalid_argument("XTS requires block ciphers with a 16 byte block");
+}
+
+/**
+ * XTS copy constructor
+ *
+ * @param that reference to a preexisting XTS object that should be copied
+ */
+XTS::XTS(const XTS &that) : XTS(that.dataCipher, that.tweakCipher) {
+
+}
+
+/**
+ * XTS destructor
+ */
+XTS::~XTS() {
+
+}
+
+/**
+ * encrypts/decrypts whole blocks as C = E(P XOR T) XOR T, multiplying the tweak by alpha after every block
+ * the tweaks of [BATCH_BLOCKS] blocks are laid out first so the blocks go to the block cipher in one call
+ *
+ * @param tweak the tweak of the first block, advanced past the last block on return
+ * @param input nblocks blocks of data
+ * @param output room for nblocks blocks, may be the same buffer as input
+ * @param nblocks the number of blocks
+ * @param encrypting whether to encrypt or decrypt
+ */
+void XTS::processBlocks(uint64_t tweak[2], const uint8_t *input, uint8_t *output, size_t nblocks, bool encrypting) const {
+    uint8_t tweaks[BATCH_BLOCKS * 16];
+    size_t n;
+
+    for (size_t b = 0; b < nblocks; b += n) {
+        n = nblocks - b < BATCH_BLOCKS ? nblocks - b : BATCH_BLOCKS;
+
+        for (size_t i = 0; i < n; i++) {
+            storeLittleEndian(tweaks + i * 16, tweak[0]);
+            storeLittleEndian(tweaks + i * 16 + 8, tweak[1]);
+            multiplyAlpha(tweak);
+        }
+
+        ModeOfOperation::xorBytes(output + b * 16, input + b * 16, tweaks, n * 16);
+        if (encrypting)
+            dataCipher.encryptBlocks(output + b * 16, output + b * 16, n);
+        else
+            dataCipher.decryptBlocks(output + b * 16, output + b * 16, n);
+        ModeOfOperation::xorBytes(output + b * 16, output + b * 16, tweaks, n * 16);
+    }
+}
+
+/**
+ * encrypts/decrypts one sector, a partial final block borrows the end of the previous block (ciphertext stealing)
+ * so the output is always the same size as the input
+ *
+ * algorithm described in IEEE 1619-2007, section 5: https://en.wikipedia.org/wiki/Disk_encryption_theory#XTS
+ *
+ * @param sector the sector number, encrypted with the tweak cipher to give the first tweak
+ * @param input size bytes of data
+ * @param size the number of bytes, at least 16
+ * @param output room for size bytes, may be the same buffer as input
+ * @param encrypting whether to encrypt or decrypt
+ *
+ * @throws std::invalid_argument if size is smaller than one block
+ * @throws std::out_of_range if size is larger than MAX_SECTOR_SIZE
+ */
+void XTS::processSector(uint64_t sector, const uint8_t *input, size_t size, uint8_t *output, bool encrypting) const {
+    uint8_t t[16] = {0}, last[16], stolen[16];
+    uint64_t tweak[2], nextTweak[2];
+    size_t nblocks = size / 16, partial = size % 16;
+
+    if (size < 16)
+        throw std::invalid_argument("a sector must be at least 16 bytes");
+    if (size > MAX_SECTOR_SIZE)
+        throw std::out_of_range("a sector can be at most 2^20 blocks");
+
+    storeLittleEndian(t, sector);
+    tweakCipher.encryptBlock(t, t);
+    tweak[0] = loadLittleEndian(t);
+    tweak[1] = loadLittleEndian(t + 8);
+
+    if (partial == 0) {
+        processBlocks(tweak, input, output, nblocks, encrypting);
+        return;
+    }
+
+    // every full block but the last one is unaffected by the stealing
+    processBlocks(tweak, input, output, nblocks - 1, encrypting);
+    input += (nblocks - 1) * 16;
+    output += (nblocks - 1) * 16;
+
+    nextTweak[0] = tweak[0];
+    nextTweak[1] = tweak[1];
+    multiplyAlpha(nextTweak);
+
+    // the last full block is processed with the final tweak when decrypting since it was encrypted second
+    processBlocks(encrypting ? tweak : nextTweak, input, last, 1, encrypting);
+
+    // the partial block is padded with the tail of the last full block's output, which it replaces
+    memcpy(stolen, input + 16, partial);
+    memcpy(stolen + partial, last + partial, 16 - partial);
+    memcpy(output + 16, last, partial);
+
+    processBlocks(encrypting ? nextTweak : tweak, stolen, output, 1, encrypting);
+}
+
+/**
+ * encrypts/decrypts many sectors, divided between the threads of a pool when one is given
+ *
+ * @param sectors the sectors
+ * @param nsectors the number of sectors
+ * @param pool the worker threads to spread the sectors over, or nullptr to process them on the calling thread
+ * @param encrypting whether to encrypt or decrypt
+ *
+ * @throws std::invalid_argument if a sector is smaller than one block
+ * @throws std::out_of_range if a sector is larger than MAX_SECTOR_SIZE
+ */
+void XTS::processSectors(const Sector sectors[], size_t nsectors, WorkerPool *pool, bool encrypting) const {
+    size_t ntasks;
+
+    if (!pool || nsectors < 2) {
+        for (size_t i = 0; i < nsectors; i++)
+            processSector(sectors[i].number, sectors[i].input, sectors[i].size, sectors[i].output, encrypting);
+        return;
+    }
+
+    // one contiguous run of sectors per thread rather than one task per sector, which are often only a few KiB
+    ntasks = nsectors < pool->getThreadCount() ? nsectors : pool->getThreadCount();
+    pool->run(ntasks, [&](size_t j) {
+        for (size_t i = j * nsectors / ntasks; i < (j + 1) * nsectors / ntasks; i++)
+            processSector(sectors[i].number, sectors[i].input, sectors[i].size, sectors[i].output, encrypting);
+    });
+}
+
+/**
+ * encrypts one sector independently of every other sector
+ *
+ * @param sector the sector number, which must never be reused for different data under one key
+ * @param plaintext size bytes of data for encrypting
+ * @param size the number of plaintext bytes, at least 16 and not necessarily a multiple of 16
+ * @param ciphertext room for size bytes, may be the same buffer as plaintext
+ *
+ * @throws std::invalid_argument if size is smaller than one block
+ * @throws std::out_of_range if size is larger than MAX_SECTOR_SIZE
+ */
+void XTS::encryptSector(uint64_t sector, const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const {
+    processSector(sector, plaintext, size, ciphertext, true);
+}
+
+/**
+ * decrypts one sector independently of every other sector
+ *
+ * @param sector the sector number the data was encrypted with
+ * @param ciphertext size bytes of data for decrypting
+ * @param size the number of ciphertext bytes, at least 16 and not necessarily a multiple of 16
+ * @param plaintext room for size bytes, may be the same buffer as ciphertext
+ *
+ * @throws std::invalid_argument if size is smaller than one block
+ * @throws std::out_of_range if size is larger than MAX_SECTOR_SIZE
+ */
+void XTS::decryptSector(uint64_t sector, const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const {
+    processSector(sector, ciphertext, size, plaintext, false);
+}
+
+/**
+ * encrypts a batch of sectors in one call, for example the pages of a scattered read or write
+ *
+ * @param sectors the sectors, each with its own number, input, size, and output
+ * @param nsectors the number of sectors
+ * @param pool the worker threads to spread the sectors over, or nullptr to encrypt them on the calling thread
+ *
+ * @throws std::invalid_argument if a sector is smaller than one block
+ * @throws std::out_of_range if a sector is larger than MAX_SECTOR_SIZE
+ */
+void XTS::encrypt(const Sector sectors[], size_t nsectors, WorkerPool *pool) const {
+    processSectors(sectors, nsectors, pool, true);
+}
+
+/**
+ * decrypts a batch of sectors in one call, for example the pages of a scattered read or write
+ *
+ * @param sectors the sectors, each with its own number, input, size, and output
+ * @param nsectors the number of sectors
+ * @param pool the worker threads to spread the sectors over, or nullptr to decrypt them on the calling thread
+ *
+ * @throws std::invalid_argument if a sector is smaller than one block
+ * @throws std::out_of_range if a sector is larger than MAX_SECTOR_SIZE
+ */
+void XTS::decrypt(const Sector sectors[], size_t nsectors, WorkerPool *pool) const {
+    processSectors(sectors, nsectors, pool, false);
+}
@@ -0,0 +1,57 @@
+/**
+ * header file for the XTS (IEEE 1619) mode of operation, which encrypts every sector independently.
+ * @file XTS.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYXTS
+#define MYXTS
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "ModeOfOperation.hpp"
+#include "WorkerPool.hpp"
+#include "../ciphers/BlockCipher.hpp"
+
+class XTS {
+public:
+    // one sector: its number, which selects the tweak, and its data, which may be the same buffer as the output
+    struct Sector {
+        uint64_t number;
+        const uint8_t *input;
+        size_t size;
+        uint8_t *output;
+    };
+
+private:
+    // number of blocks whose tweaks are laid out and passed to the block cipher in one call
+    static constexpr size_t BATCH_BLOCKS = 64;
+
+    const BlockCipher &dataCipher;
+    const BlockCipher &tweakCipher;
+
+    XTS();
+    XTS& operator=(const XTS &that) = delete;
+
+    void processBlocks(uint64_t tweak[2], const uint8_t *input, uint8_t *output, size_t nblocks, bool encrypting) const;
+    void processSector(uint64_t sector, const uint8_t *input, size_t size, uint8_t *output, bool encrypting) const;
+    void processSectors(const Sector sectors[], size_t nsectors, WorkerPool *pool, bool encrypting) const;
+
+public:
+    // IEEE 1619 limits one sector (data unit) to 2^20 blocks
+    static constexpr size_t MAX_SECTOR_SIZE = (size_t) 1 << 24;
+
+    XTS(const BlockCipher &dataCipher, const BlockCipher &tweakCipher);
+    XTS(const XTS &that);
+    ~XTS();
+
+    void encryptSector(uint64_t sector, const uint8_t *plaintext, size_t size, uint8_t *ciphertext) const;
+    void decryptSector(uint64_t sector, const uint8_t *ciphertext, size_t size, uint8_t *plaintext) const;
+    void encrypt(const Sector sectors[], size_t nsectors, WorkerPool *pool = nullptr) const;
+    void decrypt(const Sector sectors[], size_t nsectors, WorkerPool *pool = nullptr) const;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * class implementation for the ANSI X9.23 block padding standard.
+ * @file ANSI_X923.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ANSI_X923.hpp"
+
+/**
+ * ANSI_X923 primary constructor
+ *
+ * @param blockSize the size in bytes used to calculate the appropriate amount of padding
+ *
+ * @throws std::out_of_range if blockSize is 0
+ */
+ANSI_X923::ANSI_X923(uint8_t blockSize) : BlockPadding(blockSize) {
+
+}
+
+/**
+ * ANSI_X923 copy constructor
+ *
+ * @param that the reference to a preexisting ANSI_X923 object that should be copied
+ */
+ANSI_X923::ANSI_X923(const ANSI_X923 &that) : ANSI_X923(that.blockSize) {
+
+}
+
+/**
+ * ANSI_X923 destructor
+ */
+ANSI_X923::~ANSI_X923() {
+
+}
+
+/**
+ * calculates and applies necessary padding for param block in order to make the number of data bytes a multiple of [ANSI_X923::blockSize]
+ * the padding is zero bytes followed by a final byte holding the number of padding bytes
+ *
+ * implements the ANSI X9.23 padding scheme briefly described at: https://en.wikipedia.org/wiki/Padding_(cryptography)
+ *
+ * @param block room for 2 * [ANSI_X923::blockSize] bytes, starting with the data bytes
+ * @param dataSize the number of data bytes present in param block, at most [ANSI_X923::blockSize]
+ *
+ * @return the number of bytes of param block to encrypt, [ANSI_X923::blockSize] or 2 * [ANSI_X923::blockSize]
+ */
+size_t ANSI_X923::addPadding(uint8_t block[], uint8_t dataSize) const {
+    uint8_t amount = blockSize - dataSize % blockSize;
+
+    memset(block + dataSize, 0, amount - 1);
+    block[dataSize + amount - 1] = amount;
+
+    return dataSize + amount;
+}
+
+/**
+ * @param block the block of bytes containing padding
+ *
+ * @return number of trailing bytes in the block that are padding, stored in its last byte
+ */
+uint8_t ANSI_X923::getPaddingAmount(const uint8_t block[]) const {
+    return block[blockSize - 1];
+}
+
+/**
+ * checks, in constant time, that the last byte is between 1 and [ANSI_X923::blockSize] and every other padding byte is zero
+ *
+ * @param block the final decrypted block
+ *
+ * @return true if the block ends in well-formed padding
+ */
+bool ANSI_X923::isPaddingValid(const uint8_t block[]) const {
+    uint8_t amount = block[blockSize - 1], bad;
+
+    bad = maskZero(amount) | maskLessThan(blockSize, amount);
+    for (unsigned i = 0; i < blockSize - 1u; i++)
+        bad |= ~maskLessThan(i + amount, blockSize) & block[i];
+
+    return bad == 0;
+}
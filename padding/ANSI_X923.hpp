@@ -0,0 +1,31 @@
+/**
+ * header file for the ANSI X9.23 block padding standard.
+ * @file ANSI_X923.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYANSI_X923
+#define MYANSI_X923
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "BlockPadding.hpp"
+
+class ANSI_X923 : public BlockPadding {
+private:
+    ANSI_X923();
+    ANSI_X923& operator=(const ANSI_X923 &that) = delete;
+
+public:
+    ANSI_X923(uint8_t blockSize);
+    ANSI_X923(const ANSI_X923 &that);
+    ~ANSI_X923();
+
+    size_t addPadding(uint8_t block[], uint8_t dataSize) const;
+    uint8_t getPaddingAmount(const uint8_t block[]) const;
+    bool isPaddingValid(const uint8_t block[]) const;
+};
+
+#endif
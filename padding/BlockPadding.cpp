@@ -26,9 +26,44 @@ BlockPadding::~BlockPadding() {
 
 }
 
+/**
+ * constant-time comparison for the padding checks, which must not branch on decrypted data
+ *
+ * @param a the first operand, less than 2^31
+ * @param b the second operand, less than 2^31
+ *
+ * @return 0xff if a < b and 0 otherwise
+ */
+uint8_t BlockPadding::maskLessThan(unsigned a, unsigned b) {
+    return 0 - ((a - b) >> (sizeof(unsigned) * 8 - 1));
+}
+
+/**
+ * constant-time zero test for the padding checks, which must not branch on decrypted data
+ *
+ * @param a the operand, less than 2^31
+ *
+ * @return 0xff if a is 0 and 0 otherwise
+ */
+uint8_t BlockPadding::maskZero(unsigned a) {
+    return maskLessThan(a, 1);
+}
+
 /**
  * @return [BlockPadding::blockSize]
  */
 uint8_t BlockPadding::getBlockSize() const {
     return blockSize;
-}
\ No newline at end of file
+}
+
+/**
+ * the final partial (or empty) block is always padded out and a full final block is followed by a full block of padding,
+ * which is what addPadding() does when it writes an extra block for dataSize == [BlockPadding::blockSize]
+ *
+ * @param dataSize the total number of data bytes to be padded
+ *
+ * @return the number of bytes after padding
+ */
+size_t BlockPadding::getPaddedSize(size_t dataSize) const {
+    return (dataSize / blockSize + 1) * blockSize;
+}
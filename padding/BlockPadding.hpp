@@ -9,6 +9,7 @@
 #define MYBLOCKPADDING
 
 #include <cstdint>
+#include <cstddef>
 #include <stdexcept>
 
 class BlockPadding {
@@ -21,10 +22,15 @@ protected:
     const uint8_t blockSize;
     BlockPadding(uint8_t blockSize);
 
+    static uint8_t maskLessThan(unsigned a, unsigned b);
+    static uint8_t maskZero(unsigned a);
+
 public:
     virtual ~BlockPadding();
-    virtual uint8_t* addPadding(uint8_t block[], uint8_t dataSize) const = 0;
+    virtual size_t addPadding(uint8_t block[], uint8_t dataSize) const = 0;
     virtual uint8_t getPaddingAmount(const uint8_t block[]) const = 0;
+    virtual bool isPaddingValid(const uint8_t block[]) const = 0;
+    virtual size_t getPaddedSize(size_t dataSize) const;
     uint8_t getBlockSize() const;
 };
 
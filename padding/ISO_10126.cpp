@@ -0,0 +1,80 @@
+/**
+ * class implementation for the ISO 10126 block padding standard.
+ * @file ISO_10126.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ISO_10126.hpp"
+
+/**
+ * ISO_10126 primary constructor
+ *
+ * @param blockSize the size in bytes used to calculate the appropriate amount of padding
+ *
+ * @throws std::out_of_range if blockSize is 0
+ */
+ISO_10126::ISO_10126(uint8_t blockSize) : BlockPadding(blockSize) {
+
+}
+
+/**
+ * ISO_10126 copy constructor
+ *
+ * @param that the reference to a preexisting ISO_10126 object that should be copied
+ */
+ISO_10126::ISO_10126(const ISO_10126 &that) : ISO_10126(that.blockSize) {
+
+}
+
+/**
+ * ISO_10126 destructor
+ */
+ISO_10126::~ISO_10126() {
+
+}
+
+/**
+ * calculates and applies necessary padding for param block in order to make the number of data bytes a multiple of [ISO_10126::blockSize]
+ * the padding is random bytes followed by a final byte holding the number of padding bytes
+ * the random bytes only hide the padding's content, they do not need to be unpredictable, so each thread keeps its own generator
+ *
+ * implements the ISO 10126 padding scheme briefly described at: https://en.wikipedia.org/wiki/Padding_(cryptography)
+ *
+ * @param block room for 2 * [ISO_10126::blockSize] bytes, starting with the data bytes
+ * @param dataSize the number of data bytes present in param block, at most [ISO_10126::blockSize]
+ *
+ * @return the number of bytes of param block to encrypt, [ISO_10126::blockSize] or 2 * [ISO_10126::blockSize]
+ */
+size_t ISO_10126::addPadding(uint8_t block[], uint8_t dataSize) const {
+    static thread_local std::mt19937 generator(std::random_device{}());
+    uint8_t amount = blockSize - dataSize % blockSize;
+
+    for (uint8_t i = 0; i < amount - 1; i++)
+        block[dataSize + i] = generator();
+    block[dataSize + amount - 1] = amount;
+
+    return dataSize + amount;
+}
+
+/**
+ * @param block the block of bytes containing padding
+ *
+ * @return number of trailing bytes in the block that are padding, stored in its last byte
+ */
+uint8_t ISO_10126::getPaddingAmount(const uint8_t block[]) const {
+    return block[blockSize - 1];
+}
+
+/**
+ * checks, in constant time, that the last byte is between 1 and [ISO_10126::blockSize], the other padding bytes are arbitrary
+ *
+ * @param block the final decrypted block
+ *
+ * @return true if the block ends in well-formed padding
+ */
+bool ISO_10126::isPaddingValid(const uint8_t block[]) const {
+    uint8_t amount = block[blockSize - 1];
+
+    return (maskZero(amount) | maskLessThan(blockSize, amount)) == 0;
+}
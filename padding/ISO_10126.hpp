@@ -0,0 +1,32 @@
+/**
+ * header file for the ISO 10126 block padding standard.
+ * @file ISO_10126.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYISO_10126
+#define MYISO_10126
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include "BlockPadding.hpp"
+
+class ISO_10126 : public BlockPadding {
+private:
+    ISO_10126();
+    ISO_10126& operator=(const ISO_10126 &that) = delete;
+
+public:
+    ISO_10126(uint8_t blockSize);
+    ISO_10126(const ISO_10126 &that);
+    ~ISO_10126();
+
+    size_t addPadding(uint8_t block[], uint8_t dataSize) const;
+    uint8_t getPaddingAmount(const uint8_t block[]) const;
+    bool isPaddingValid(const uint8_t block[]) const;
+};
+
+#endif
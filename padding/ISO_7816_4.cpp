@@ -0,0 +1,95 @@
+/**
+ * class implementation for the ISO/IEC 7816-4 block padding standard.
+ * @file ISO_7816_4.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ISO_7816_4.hpp"
+
+/**
+ * ISO_7816_4 primary constructor
+ *
+ * @param blockSize the size in bytes used to calculate the appropriate amount of padding
+ *
+ * @throws std::out_of_range if blockSize is 0
+ */
+ISO_7816_4::ISO_7816_4(uint8_t blockSize) : BlockPadding(blockSize) {
+
+}
+
+/**
+ * ISO_7816_4 copy constructor
+ *
+ * @param that the reference to a preexisting ISO_7816_4 object that should be copied
+ */
+ISO_7816_4::ISO_7816_4(const ISO_7816_4 &that) : ISO_7816_4(that.blockSize) {
+
+}
+
+/**
+ * ISO_7816_4 destructor
+ */
+ISO_7816_4::~ISO_7816_4() {
+
+}
+
+/**
+ * calculates and applies necessary padding for param block in order to make the number of data bytes a multiple of [ISO_7816_4::blockSize]
+ * the padding is a single 0x80 byte followed by zero bytes, so its length is found by searching for the 0x80
+ *
+ * implements the ISO/IEC 7816-4 padding scheme briefly described at: https://en.wikipedia.org/wiki/Padding_(cryptography)
+ *
+ * @param block room for 2 * [ISO_7816_4::blockSize] bytes, starting with the data bytes
+ * @param dataSize the number of data bytes present in param block, at most [ISO_7816_4::blockSize]
+ *
+ * @return the number of bytes of param block to encrypt, [ISO_7816_4::blockSize] or 2 * [ISO_7816_4::blockSize]
+ */
+size_t ISO_7816_4::addPadding(uint8_t block[], uint8_t dataSize) const {
+    uint8_t amount = blockSize - dataSize % blockSize;
+
+    block[dataSize] = 0x80;
+    memset(block + dataSize + 1, 0, amount - 1);
+
+    return dataSize + amount;
+}
+
+/**
+ * finds the last non-zero byte of the block without branching on the data
+ *
+ * @param block the block of bytes containing padding
+ *
+ * @return number of trailing bytes in the block that are padding, from the last non-zero byte to the end
+ */
+uint8_t ISO_7816_4::getPaddingAmount(const uint8_t block[]) const {
+    uint8_t found = 0, position = 0, mask;
+
+    for (int i = blockSize - 1; i >= 0; i--) {
+        mask = ~maskZero(block[i]) & ~found;
+        position |= mask & i;
+        found |= mask;
+    }
+
+    return blockSize - position;
+}
+
+/**
+ * checks, in constant time, that the last non-zero byte of the block is 0x80
+ *
+ * @param block the final decrypted block
+ *
+ * @return true if the block ends in well-formed padding
+ */
+bool ISO_7816_4::isPaddingValid(const uint8_t block[]) const {
+    uint8_t found = 0, value = 0, mask, bad;
+
+    for (int i = blockSize - 1; i >= 0; i--) {
+        mask = ~maskZero(block[i]) & ~found;
+        value |= mask & block[i];
+        found |= mask;
+    }
+
+    bad = ~found | ~maskZero(value ^ 0x80);
+
+    return bad == 0;
+}
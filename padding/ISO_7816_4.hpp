@@ -0,0 +1,31 @@
+/**
+ * header file for the ISO/IEC 7816-4 block padding standard.
+ * @file ISO_7816_4.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYISO_7816_4
+#define MYISO_7816_4
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "BlockPadding.hpp"
+
+class ISO_7816_4 : public BlockPadding {
+private:
+    ISO_7816_4();
+    ISO_7816_4& operator=(const ISO_7816_4 &that) = delete;
+
+public:
+    ISO_7816_4(uint8_t blockSize);
+    ISO_7816_4(const ISO_7816_4 &that);
+    ~ISO_7816_4();
+
+    size_t addPadding(uint8_t block[], uint8_t dataSize) const;
+    uint8_t getPaddingAmount(const uint8_t block[]) const;
+    bool isPaddingValid(const uint8_t block[]) const;
+};
+
+#endif
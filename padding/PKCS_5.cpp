@@ -36,33 +36,21 @@ PKCS_5::~PKCS_5() {
 
 /**
  * calculates and applies necessary padding for param block in order to make the number of data bytes a multiple of [PKCS_5::blockSize]
- * 
- * implements the PKCS#5 padding scheme briefly described at: https://en.wikipedia.org/wiki/Padding_(cryptography)
+ * every padding byte holds the number of padding bytes, a full block of data is followed by a full block of padding
  *
- * @param block the block of bytes containing data that needs to be padded
- * @param dataSize the number of data bytes present in param block
+ * implements the PKCS#5 padding scheme briefly described at: https://en.wikipedia.org/wiki/Padding_(cryptography)
  *
- * @return a full block of padding if the number of data bytes is already a multiple of [PKCS_5::blockSize] and nullptr otherwise
+ * @param block room for 2 * [PKCS_5::blockSize] bytes, starting with the data bytes
+ * @param dataSize the number of data bytes present in param block, at most [PKCS_5::blockSize]
  *
- * @throws std::bad_alloc if unable to allocate memory for return block
+ * @return the number of bytes of param block to encrypt, [PKCS_5::blockSize] or 2 * [PKCS_5::blockSize]
  */
-uint8_t* PKCS_5::addPadding(uint8_t block[], uint8_t dataSize) const {
-    uint8_t *padding = nullptr;
+size_t PKCS_5::addPadding(uint8_t block[], uint8_t dataSize) const {
+    uint8_t amount = blockSize - dataSize % blockSize;
 
-    if (dataSize == blockSize) {
-        try {
-            padding = new uint8_t[blockSize];
-        } catch (std::bad_alloc &e) {
-            throw;
-        }
-        for (int i = 0; i < blockSize; i++)
-            padding[i] = blockSize;
-    }
+    memset(block + dataSize, amount, amount);
 
-    for (int i = 0; i < blockSize - dataSize; i++)
-        block[dataSize + i] = blockSize - dataSize;
-        
-    return padding;
+    return dataSize + amount;
 }
 
 /**
@@ -74,4 +62,21 @@ uint8_t* PKCS_5::addPadding(uint8_t block[], uint8_t dataSize) const {
  */
 uint8_t PKCS_5::getPaddingAmount(const uint8_t block[]) const {
     return block[blockSize - 1];
-}
\ No newline at end of file
+}
+
+/**
+ * checks, in constant time, that the last byte is between 1 and [PKCS_5::blockSize] and every padding byte equals it
+ *
+ * @param block the final decrypted block
+ *
+ * @return true if the block ends in well-formed padding
+ */
+bool PKCS_5::isPaddingValid(const uint8_t block[]) const {
+    uint8_t amount = block[blockSize - 1], bad;
+
+    bad = maskZero(amount) | maskLessThan(blockSize, amount);
+    for (unsigned i = 0; i < blockSize; i++)
+        bad |= ~maskLessThan(i + amount, blockSize) & (block[i] ^ amount);
+
+    return bad == 0;
+}
@@ -9,7 +9,8 @@
 #define MYPKCS_5
 
 #include <cstdint>
-#include <new>
+#include <cstddef>
+#include <cstring>
 #include "BlockPadding.hpp"
 
 class PKCS_5 : public BlockPadding {
@@ -22,8 +23,9 @@ public:
     PKCS_5(const PKCS_5 &that);
     ~PKCS_5();
 
-    uint8_t* addPadding(uint8_t block[], uint8_t dataSize) const;
+    size_t addPadding(uint8_t block[], uint8_t dataSize) const;
     uint8_t getPaddingAmount(const uint8_t block[]) const;
+    bool isPaddingValid(const uint8_t block[]) const;
 };
 
 #endif
\ No newline at end of file
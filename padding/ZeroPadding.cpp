@@ -0,0 +1,93 @@
+/**
+ * class implementation for the zero byte block padding scheme.
+ * @file ZeroPadding.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include "ZeroPadding.hpp"
+
+/**
+ * ZeroPadding primary constructor
+ *
+ * @param blockSize the size in bytes used to calculate the appropriate amount of padding
+ *
+ * @throws std::out_of_range if blockSize is 0
+ */
+ZeroPadding::ZeroPadding(uint8_t blockSize) : BlockPadding(blockSize) {
+
+}
+
+/**
+ * ZeroPadding copy constructor
+ *
+ * @param that the reference to a preexisting ZeroPadding object that should be copied
+ */
+ZeroPadding::ZeroPadding(const ZeroPadding &that) : ZeroPadding(that.blockSize) {
+
+}
+
+/**
+ * ZeroPadding destructor
+ */
+ZeroPadding::~ZeroPadding() {
+
+}
+
+/**
+ * fills the rest of a partial block with zero bytes, data that is already a multiple of [ZeroPadding::blockSize] is not padded
+ * since the padding has no length field, trailing zero bytes of the data itself are indistinguishable from it and are stripped too
+ *
+ * implements the zero padding scheme briefly described at: https://en.wikipedia.org/wiki/Padding_(cryptography)
+ *
+ * @param block room for [ZeroPadding::blockSize] bytes, starting with the data bytes
+ * @param dataSize the number of data bytes present in param block, at most [ZeroPadding::blockSize]
+ *
+ * @return the number of bytes of param block to encrypt, 0 for no data and [ZeroPadding::blockSize] otherwise
+ */
+size_t ZeroPadding::addPadding(uint8_t block[], uint8_t dataSize) const {
+    if (dataSize == 0)
+        return 0;
+
+    memset(block + dataSize, 0, blockSize - dataSize);
+
+    return blockSize;
+}
+
+/**
+ * counts the trailing zero bytes of the block without branching on the data
+ *
+ * @param block the block of bytes containing padding
+ *
+ * @return number of trailing bytes in the block that are zero
+ */
+uint8_t ZeroPadding::getPaddingAmount(const uint8_t block[]) const {
+    uint8_t run = 0xff, amount = 0;
+
+    for (int i = blockSize - 1; i >= 0; i--) {
+        run &= maskZero(block[i]);
+        amount += run & 1;
+    }
+
+    return amount;
+}
+
+/**
+ * zero padding cannot be validated, since any block could end in padding zeros, so the final block is not examined
+ *
+ * @return true since every block is validly zero padded
+ */
+bool ZeroPadding::isPaddingValid(const uint8_t []) const {
+    return true;
+}
+
+/**
+ * only a partial final block is padded, so the padded size is dataSize rounded up to a multiple of [ZeroPadding::blockSize]
+ *
+ * @param dataSize the total number of data bytes to be padded
+ *
+ * @return the number of bytes after padding
+ */
+size_t ZeroPadding::getPaddedSize(size_t dataSize) const {
+    return (dataSize + blockSize - 1) / blockSize * blockSize;
+}
@@ -0,0 +1,32 @@
+/**
+ * header file for the zero byte block padding scheme.
+ * @file ZeroPadding.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYZEROPADDING
+#define MYZEROPADDING
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "BlockPadding.hpp"
+
+class ZeroPadding : public BlockPadding {
+private:
+    ZeroPadding();
+    ZeroPadding& operator=(const ZeroPadding &that) = delete;
+
+public:
+    ZeroPadding(uint8_t blockSize);
+    ZeroPadding(const ZeroPadding &that);
+    ~ZeroPadding();
+
+    size_t addPadding(uint8_t block[], uint8_t dataSize) const;
+    uint8_t getPaddingAmount(const uint8_t block[]) const;
+    bool isPaddingValid(const uint8_t block[]) const;
+    size_t getPaddedSize(size_t dataSize) const;
+};
+
+#endif
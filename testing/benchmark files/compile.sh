@@ -0,0 +1,3 @@
+#!/bin/bash
+
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp keyAgility.cpp -o keyAgility.out
\ No newline at end of file
@@ -0,0 +1,120 @@
+/**
+ * benchmark program that compares the cost of setting up an AES key with the cost of encrypting a block under it.
+ * @file keyAgility.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include "../../ciphers/AES.hpp"
+#include "../../ciphers/KeyScheduleCache.hpp"
+
+using namespace std;
+
+// number of distinct keys cycled through, more than fit in the cache for the miss measurement
+const int N_KEYS = 4096;
+
+// number of times each measurement is repeated
+const int N_ITERATIONS = 100000;
+
+// number of blocks encrypted per call when measuring the per-block cost
+const size_t N_BLOCKS = 1024;
+
+double nanosecondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+double constructCost(const vector<vector<uint8_t>> &keys, AES::KEY_SIZE keySize, AES::BACKEND backend) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for (int i = 0; i < N_ITERATIONS; i++) {
+        AES aes(keys[i % N_KEYS].data(), keySize, backend);
+    }
+
+    return nanosecondsSince(start) / N_ITERATIONS;
+}
+
+double setKeyCost(const vector<vector<uint8_t>> &keys, AES::KEY_SIZE keySize, AES::BACKEND backend) {
+    AES aes(keys[0].data(), keySize, backend);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for (int i = 0; i < N_ITERATIONS; i++)
+        aes.setKey(keys[i % N_KEYS].data());
+
+    return nanosecondsSince(start) / N_ITERATIONS;
+}
+
+double cacheCost(const vector<vector<uint8_t>> &keys, const vector<string> &keyIds, AES::KEY_SIZE keySize, AES::BACKEND backend, int nKeys, size_t capacity) {
+    KeyScheduleCache cache(capacity, backend);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for (int i = 0; i < N_ITERATIONS; i++)
+        cache.get(keyIds[i % nKeys], keys[i % nKeys].data(), keySize);
+
+    return nanosecondsSince(start) / N_ITERATIONS;
+}
+
+double blockCost(const vector<vector<uint8_t>> &keys, AES::KEY_SIZE keySize, AES::BACKEND backend) {
+    AES aes(keys[0].data(), keySize, backend);
+    vector<uint8_t> buffer(16 * N_BLOCKS);
+    int nCalls = N_ITERATIONS / 100;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for (int i = 0; i < nCalls; i++)
+        aes.encryptBlocks(buffer.data(), buffer.data(), N_BLOCKS);
+
+    return nanosecondsSince(start) / nCalls / N_BLOCKS;
+}
+
+void benchmark(const vector<vector<uint8_t>> &keys, const vector<string> &keyIds, AES::KEY_SIZE keySize, AES::BACKEND backend, const char *name) {
+    double construct, setKey, hit, miss, block;
+
+    try {
+        construct = constructCost(keys, keySize, backend);
+    } catch (invalid_argument &e) {
+        cout << setw(10) << name << setw(6) << keySize * 8 << "   not supported by this CPU" << endl;
+        return;
+    }
+
+    setKey = setKeyCost(keys, keySize, backend);
+    hit = cacheCost(keys, keyIds, keySize, backend, 64, 1024);
+    miss = cacheCost(keys, keyIds, keySize, backend, N_KEYS, 1024);
+    block = blockCost(keys, keySize, backend);
+
+    // the break-even column is how many blocks a new AES must encrypt before the key setup is no more than half the time
+    cout << setw(10) << name << setw(6) << keySize * 8
+         << setw(12) << construct << setw(12) << setKey << setw(12) << hit << setw(12) << miss << setw(12) << block
+         << setw(12) << construct / block << endl;
+}
+
+int main() {
+    vector<vector<uint8_t>> keys(N_KEYS, vector<uint8_t>(32));
+    vector<string> keyIds(N_KEYS);
+    AES::KEY_SIZE keySizes[] = { AES::AES128, AES::AES192, AES::AES256 };
+    AES::BACKEND backends[] = { AES::AUTO, AES::REFERENCE, AES::TTABLE, AES::AESNI, AES::BITSLICE, AES::VPERM };
+    const char *names[] = { "AUTO", "REFERENCE", "TTABLE", "AESNI", "BITSLICE", "VPERM" };
+
+    for (int i = 0; i < N_KEYS; i++) {
+        for (int j = 0; j < 32; j++)
+            keys[i][j] = i * 131 + j * 17;
+        keyIds[i] = "tenant-" + to_string(i);
+    }
+
+    cout << "nanoseconds per operation: a new AES, setKey, a cache hit, a cache miss, and one block of encryptBlocks" << endl;
+    cout << setw(10) << "backend" << setw(6) << "bits" << setw(12) << "new AES" << setw(12) << "setKey"
+         << setw(12) << "cache hit" << setw(12) << "cache miss" << setw(12) << "per block" << setw(12) << "break-even" << endl;
+    cout << fixed << setprecision(1);
+
+    for (int b = 0; b < 6; b++)
+        for (AES::KEY_SIZE keySize : keySizes)
+            benchmark(keys, keyIds, keySize, backends[b], names[b]);
+
+    return 0;
+}
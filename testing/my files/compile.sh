@@ -1,3 +1,3 @@
 #!/bin/bash
 
-g++ ../../ciphers/* ../../modes/* ../../padding/* generate.cpp -o generate.out
\ No newline at end of file
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp generate.cpp -o generate.out
\ No newline at end of file
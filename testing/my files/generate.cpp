@@ -8,6 +8,7 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <string>
 #include <cstdint>
 #include "../../ciphers/BlockCipher.hpp"
 #include "../../ciphers/AES.hpp"
@@ -42,11 +43,29 @@ void decryptFile(ModeOfOperation &moo, const char *ciphertextPath, const char *p
     plaintext.close();
 }
 
+// the memory-mapped file API writes beside the stream output, under the same file name prefixed with mapped_
+string mappedPath(const char *path) {
+    string mapped(path);
+
+    return mapped.insert(mapped.rfind('/') + 1, "mapped_");
+}
+
+void encryptMappedFile(ModeOfOperation &moo, const char *plaintextPath, const char *ciphertextPath) {
+    moo.encryptFile(plaintextPath, mappedPath(ciphertextPath));
+}
+
+void decryptMappedFile(ModeOfOperation &moo, const char *ciphertextPath, const char *plaintextPath) {
+    moo.decryptFile(mappedPath(ciphertextPath), mappedPath(plaintextPath));
+}
+
 void generateECB(BlockCipher &bc, BlockPadding &padding, const char *plaintextPath, const char *ciphertextPath, const char *_plaintextPath) {
     ECB ecb(bc, padding);
 
     encryptFile(ecb, plaintextPath, ciphertextPath);
     decryptFile(ecb, ciphertextPath, _plaintextPath);
+
+    encryptMappedFile(ecb, plaintextPath, ciphertextPath);
+    decryptMappedFile(ecb, ciphertextPath, _plaintextPath);
 }
 
 void generateCBC(BlockCipher &bc, BlockPadding &padding, uint8_t *iv, const char *plaintextPath, const char *ciphertextPath, const char *_plaintextPath) {
@@ -54,6 +73,9 @@ void generateCBC(BlockCipher &bc, BlockPadding &padding, uint8_t *iv, const char
 
     encryptFile(cbc, plaintextPath, ciphertextPath);
     decryptFile(cbc, ciphertextPath, _plaintextPath);
+
+    encryptMappedFile(cbc, plaintextPath, ciphertextPath);
+    decryptMappedFile(cbc, ciphertextPath, _plaintextPath);
 }
 
 void generateCFB(BlockCipher &bc, uint8_t *iv, const char *plaintextPath, const char *ciphertextPath, const char *_plaintextPath) {
@@ -61,6 +83,9 @@ void generateCFB(BlockCipher &bc, uint8_t *iv, const char *plaintextPath, const
 
     encryptFile(cfb, plaintextPath, ciphertextPath);
     decryptFile(cfb, ciphertextPath, _plaintextPath);
+
+    encryptMappedFile(cfb, plaintextPath, ciphertextPath);
+    decryptMappedFile(cfb, ciphertextPath, _plaintextPath);
 }
 
 void generateOFB(BlockCipher &bc, uint8_t *iv, const char *plaintextPath, const char *ciphertextPath, const char *_plaintextPath) {
@@ -68,6 +93,9 @@ void generateOFB(BlockCipher &bc, uint8_t *iv, const char *plaintextPath, const
 
     encryptFile(ofb, plaintextPath, ciphertextPath);
     decryptFile(ofb, ciphertextPath, _plaintextPath);
+
+    encryptMappedFile(ofb, plaintextPath, ciphertextPath);
+    decryptMappedFile(ofb, ciphertextPath, _plaintextPath);
 }
 
 void generateCTR(BlockCipher &bc, uint8_t *iv, const char *plaintextPath, const char *ciphertextPath, const char *_plaintextPath) {
@@ -75,6 +103,54 @@ void generateCTR(BlockCipher &bc, uint8_t *iv, const char *plaintextPath, const
 
     encryptFile(ctr, plaintextPath, ciphertextPath);
     decryptFile(ctr, ciphertextPath, _plaintextPath);
+
+    encryptMappedFile(ctr, plaintextPath, ciphertextPath);
+    decryptMappedFile(ctr, ciphertextPath, _plaintextPath);
+}
+
+// every backend writes its own files, under the same file names prefixed with the backend's name
+struct Backend {
+    AES::BACKEND backend;
+    const char *name;
+};
+
+const Backend BACKENDS[] = {
+    { AES::AUTO, "auto" },
+    { AES::REFERENCE, "reference" },
+    { AES::TTABLE, "ttable" },
+    { AES::AESNI, "aesni" },
+    { AES::BITSLICE, "bitslice" },
+    { AES::VPERM, "vperm" }
+};
+
+void generateBackend(const Backend &backend, uint8_t *key, uint8_t *iv) {
+    AES aes128(key, AES::AES128, backend.backend);
+    AES aes192(key, AES::AES192, backend.backend);
+    AES aes256(key, AES::AES256, backend.backend);
+
+    PKCS_5 padding(16);
+
+    string prefix = string("./") + backend.name + "_";
+
+    generateECB(aes128, padding, "../plaintext", (prefix + "ciphertext_aes_128_ecb").c_str(), (prefix + "plaintext_aes_128_ecb").c_str());
+    generateECB(aes192, padding, "../plaintext", (prefix + "ciphertext_aes_192_ecb").c_str(), (prefix + "plaintext_aes_192_ecb").c_str());
+    generateECB(aes256, padding, "../plaintext", (prefix + "ciphertext_aes_256_ecb").c_str(), (prefix + "plaintext_aes_256_ecb").c_str());
+
+    generateCBC(aes128, padding, iv, "../plaintext", (prefix + "ciphertext_aes_128_cbc").c_str(), (prefix + "plaintext_aes_128_cbc").c_str());
+    generateCBC(aes192, padding, iv, "../plaintext", (prefix + "ciphertext_aes_192_cbc").c_str(), (prefix + "plaintext_aes_192_cbc").c_str());
+    generateCBC(aes256, padding, iv, "../plaintext", (prefix + "ciphertext_aes_256_cbc").c_str(), (prefix + "plaintext_aes_256_cbc").c_str());
+
+    generateCFB(aes128, iv, "../plaintext", (prefix + "ciphertext_aes_128_cfb").c_str(), (prefix + "plaintext_aes_128_cfb").c_str());
+    generateCFB(aes192, iv, "../plaintext", (prefix + "ciphertext_aes_192_cfb").c_str(), (prefix + "plaintext_aes_192_cfb").c_str());
+    generateCFB(aes256, iv, "../plaintext", (prefix + "ciphertext_aes_256_cfb").c_str(), (prefix + "plaintext_aes_256_cfb").c_str());
+
+    generateOFB(aes128, iv, "../plaintext", (prefix + "ciphertext_aes_128_ofb").c_str(), (prefix + "plaintext_aes_128_ofb").c_str());
+    generateOFB(aes192, iv, "../plaintext", (prefix + "ciphertext_aes_192_ofb").c_str(), (prefix + "plaintext_aes_192_ofb").c_str());
+    generateOFB(aes256, iv, "../plaintext", (prefix + "ciphertext_aes_256_ofb").c_str(), (prefix + "plaintext_aes_256_ofb").c_str());
+
+    generateCTR(aes128, iv, "../plaintext", (prefix + "ciphertext_aes_128_ctr").c_str(), (prefix + "plaintext_aes_128_ctr").c_str());
+    generateCTR(aes192, iv, "../plaintext", (prefix + "ciphertext_aes_192_ctr").c_str(), (prefix + "plaintext_aes_192_ctr").c_str());
+    generateCTR(aes256, iv, "../plaintext", (prefix + "ciphertext_aes_256_ctr").c_str(), (prefix + "plaintext_aes_256_ctr").c_str());
 }
 
 int main() {
@@ -94,29 +170,14 @@ int main() {
         cout << setw(2) << (int) iv[i] << setw(2) << (int) iv[i+1] << " ";
     cout << endl;
 
-    AES aes128(key, AES::AES128);
-    AES aes192(key, AES::AES192);
-    AES aes256(key, AES::AES256);
+    // backends this CPU cannot run write no files, which verify.sh reports as skipped
+    for (const Backend &backend : BACKENDS) {
+        if (!AES::isSupported(backend.backend)) {
+            cout << "BACKEND: " << backend.name << " (not supported by this CPU)" << endl;
+            continue;
+        }
 
-    PKCS_5 padding(16);
-
-    generateECB(aes128, padding, "../plaintext", "./ciphertext_aes_128_ecb", "./plaintext_aes_128_ecb");
-    generateECB(aes192, padding, "../plaintext", "./ciphertext_aes_192_ecb", "./plaintext_aes_192_ecb");
-    generateECB(aes256, padding, "../plaintext", "./ciphertext_aes_256_ecb", "./plaintext_aes_256_ecb");
-
-    generateCBC(aes128, padding, iv, "../plaintext", "./ciphertext_aes_128_cbc", "./plaintext_aes_128_cbc");
-    generateCBC(aes192, padding, iv, "../plaintext", "./ciphertext_aes_192_cbc", "./plaintext_aes_192_cbc");
-    generateCBC(aes256, padding, iv, "../plaintext", "./ciphertext_aes_256_cbc", "./plaintext_aes_256_cbc");
-
-    generateCFB(aes128, iv, "../plaintext", "./ciphertext_aes_128_cfb", "./plaintext_aes_128_cfb");
-    generateCFB(aes192, iv, "../plaintext", "./ciphertext_aes_192_cfb", "./plaintext_aes_192_cfb");
-    generateCFB(aes256, iv, "../plaintext", "./ciphertext_aes_256_cfb", "./plaintext_aes_256_cfb");
-
-    generateOFB(aes128, iv, "../plaintext", "./ciphertext_aes_128_ofb", "./plaintext_aes_128_ofb");
-    generateOFB(aes192, iv, "../plaintext", "./ciphertext_aes_192_ofb", "./plaintext_aes_192_ofb");
-    generateOFB(aes256, iv, "../plaintext", "./ciphertext_aes_256_ofb", "./plaintext_aes_256_ofb");
-
-    generateCTR(aes128, iv, "../plaintext", "./ciphertext_aes_128_ctr", "./plaintext_aes_128_ctr");
-    generateCTR(aes192, iv, "../plaintext", "./ciphertext_aes_192_ctr", "./plaintext_aes_192_ctr");
-    generateCTR(aes256, iv, "../plaintext", "./ciphertext_aes_256_ctr", "./plaintext_aes_256_ctr");
-}
\ No newline at end of file
+        cout << "BACKEND: " << backend.name << endl;
+        generateBackend(backend, key, iv);
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * test program that checks the three CBC ciphertext stealing variants against known answers.
+ * @file cbcCsVectors.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../../ciphers/AES.hpp"
+#include "../../modes/ModeOfOperation.hpp"
+#include "../../modes/CBC_CS.hpp"
+#include "vectors.hpp"
+
+using namespace std;
+
+// the AES-128 vectors of RFC 3962 (key "chicken teriyaki", zero iv), which are CS3
+// CS1 and CS2 are the same ciphertext with the last two blocks ordered as the NIST SP 800-38A addendum defines:
+// CS1 always puts the partial block before the last full block, and CS2 does so only for block aligned data
+// found at: https://www.rfc-editor.org/rfc/rfc3962#appendix-B
+struct Vector {
+    const char *plaintext;
+    const char *cs1;
+    const char *cs2;
+    const char *cs3;
+};
+
+const char KEY[] = "636869636b656e207465726979616b69";
+
+const Vector VECTORS[] = {
+    { "4920776f756c64206c696b652074686520",
+      "97c6353568f2bf8cb4d8a580362da7ff7f",
+      "c6353568f2bf8cb4d8a580362da7ff7f97",
+      "c6353568f2bf8cb4d8a580362da7ff7f97" },
+    { "4920776f756c64206c696b65207468652047656e6572616c20476175277320",
+      "97687268d6ecccc0c07b25e25ecfe5fc00783e0efdb2c1d445d4c8eff7ed22",
+      "fc00783e0efdb2c1d445d4c8eff7ed2297687268d6ecccc0c07b25e25ecfe5",
+      "fc00783e0efdb2c1d445d4c8eff7ed2297687268d6ecccc0c07b25e25ecfe5" },
+    { "4920776f756c64206c696b65207468652047656e6572616c2047617527732043",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5a8",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5a8",
+      "39312523a78662d5be7fcbcc98ebf5a897687268d6ecccc0c07b25e25ecfe584" },
+    { "4920776f756c64206c696b65207468652047656e6572616c20476175277320436869636b656e2c20706c656173652c",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5b3fffd940c16a18c1b5549d2f838029e",
+      "97687268d6ecccc0c07b25e25ecfe584b3fffd940c16a18c1b5549d2f838029e39312523a78662d5be7fcbcc98ebf5",
+      "97687268d6ecccc0c07b25e25ecfe584b3fffd940c16a18c1b5549d2f838029e39312523a78662d5be7fcbcc98ebf5" },
+    { "4920776f756c64206c696b65207468652047656e6572616c20476175277320436869636b656e2c20706c656173652c20",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5a89dad8bbb96c4cdc03bc103e1a194bbd8",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5a89dad8bbb96c4cdc03bc103e1a194bbd8",
+      "97687268d6ecccc0c07b25e25ecfe5849dad8bbb96c4cdc03bc103e1a194bbd839312523a78662d5be7fcbcc98ebf5a8" },
+    { "4920776f756c64206c696b65207468652047656e6572616c20476175277320436869636b656e2c20706c656173652c20616e6420776f6e746f6e20736f75702e",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5a89dad8bbb96c4cdc03bc103e1a194bbd84807efe836ee89a526730dbc2f7bc840",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5a89dad8bbb96c4cdc03bc103e1a194bbd84807efe836ee89a526730dbc2f7bc840",
+      "97687268d6ecccc0c07b25e25ecfe58439312523a78662d5be7fcbcc98ebf5a84807efe836ee89a526730dbc2f7bc8409dad8bbb96c4cdc03bc103e1a194bbd8" }
+};
+
+// feeds the input to a context a few bytes at a time, so the held back tail crosses update calls
+vector<uint8_t> runContext(const CBC_CS &mode, ModeOfOperation::DIRECTION direction, const vector<uint8_t> &input) {
+    ModeContext *context = mode.createContext(direction);
+    vector<uint8_t> output(input.size() + 32);
+    size_t written = 0;
+
+    for (size_t i = 0; i < input.size(); i += 5) {
+        size_t n = input.size() - i < 5 ? input.size() - i : 5;
+
+        written += context->update(input.data() + i, n, output.data() + written);
+    }
+    written += context->final(output.data() + written);
+    delete context;
+
+    output.resize(written);
+    return output;
+}
+
+bool checkVariant(const vector<uint8_t> &plaintext, const char *expected, CBC_CS::VARIANT variant, const string &name) {
+    vector<uint8_t> key = fromHex(KEY), ciphertext = fromHex(expected), output(plaintext.size());
+    uint8_t iv[16] = { 0 };
+    bool passed = true;
+
+    AES aes(key.data(), AES::AES128);
+    CBC_CS cbcCs(aes, iv, sizeof(iv), variant);
+
+    passed &= check(name + " encrypt", cbcCs.encrypt(plaintext.data(), plaintext.size(), output.data()) == ciphertext.size() && output == ciphertext);
+    passed &= check(name + " decrypt", cbcCs.decrypt(ciphertext.data(), ciphertext.size(), output.data()) == plaintext.size() && output == plaintext);
+    passed &= check(name + " encrypt context", runContext(cbcCs, ModeOfOperation::ENCRYPT, plaintext) == ciphertext);
+    passed &= check(name + " decrypt context", runContext(cbcCs, ModeOfOperation::DECRYPT, ciphertext) == plaintext);
+
+    return passed;
+}
+
+int main() {
+    bool passed = true;
+
+    for (const Vector &v : VECTORS) {
+        vector<uint8_t> plaintext = fromHex(v.plaintext);
+        string size = to_string(plaintext.size()) + " bytes";
+
+        passed &= checkVariant(plaintext, v.cs1, CBC_CS::CS1, "CS1 " + size);
+        passed &= checkVariant(plaintext, v.cs2, CBC_CS::CS2, "CS2 " + size);
+        passed &= checkVariant(plaintext, v.cs3, CBC_CS::CS3, "CS3 " + size);
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+#!/bin/bash
+
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp gcmVectors.cpp -o gcmVectors.out
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp xtsVectors.cpp -o xtsVectors.out
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp cbcCsVectors.cpp -o cbcCsVectors.out
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp uringPipeline.cpp -o uringPipeline.out
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp paddingVectors.cpp -o paddingVectors.out
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp rangeVectors.cpp -o rangeVectors.out
+g++ -O2 -pthread ../../ciphers/*.cpp ../../modes/*.cpp ../../padding/*.cpp containerVectors.cpp -o containerVectors.out
@@ -0,0 +1,196 @@
+/**
+ * test program that round trips the container format in every mode and checks that damage is caught where it happens.
+ * @file containerVectors.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include "../../ciphers/AES.hpp"
+#include "../../modes/Container.hpp"
+#include "../../modes/WorkerPool.hpp"
+#include "vectors.hpp"
+
+using namespace std;
+
+const uint32_t CHUNK_SIZE = 64;
+
+// nothing, less than a chunk, exactly one chunk, and several rounds of the 3 thread pool with a partial last chunk
+const size_t SIZES[] = { 0, 1, CHUNK_SIZE - 1, CHUNK_SIZE, 3 * CHUNK_SIZE + 17, 10 * CHUNK_SIZE + 5 };
+
+struct Mode {
+    Container::MODE mode;
+    const char *name;
+};
+
+const Mode MODES[] = {
+    { Container::MODE_CBC, "CBC" },
+    { Container::MODE_CFB, "CFB" },
+    { Container::MODE_OFB, "OFB" },
+    { Container::MODE_CTR, "CTR" },
+    { Container::MODE_GCM, "GCM" }
+};
+
+// writes the plaintext in uneven pieces so that writes straddle chunk and round boundaries
+string writeContainer(const AES &aes, Container::MODE mode, const vector<uint8_t> &plaintext, WorkerPool &pool) {
+    uint8_t nonce[16] = { 0xa5 };
+    ostringstream output;
+    ContainerWriter writer(output, aes, mode, nonce, pool, CHUNK_SIZE);
+
+    for (size_t i = 0, n = 1; i < plaintext.size(); i += n, n = n * 3 % 97 + 1)
+        writer.write(plaintext.data() + i, min(n, plaintext.size() - i));
+    writer.finish();
+
+    return output.str();
+}
+
+bool throwsInvalid(const string &container, const AES &aes, WorkerPool &pool) {
+    istringstream input(container);
+
+    try {
+        ContainerReader reader(input, aes, pool);
+    } catch (invalid_argument &e) {
+        return true;
+    }
+
+    return false;
+}
+
+bool checkRoundTrip(const AES &aes, const Mode &m, WorkerPool &pool) {
+    bool passed = true;
+
+    for (size_t size : SIZES) {
+        vector<uint8_t> plaintext(size), chunk(CHUNK_SIZE), joined;
+        string label = string(m.name) + " " + to_string(size) + " bytes";
+        uint8_t nonce[16] = { 0xa5 };
+
+        for (size_t i = 0; i < size; i++)
+            plaintext[i] = (uint8_t) (i * 7 + 3);
+
+        string container = writeContainer(aes, m.mode, plaintext, pool);
+        istringstream input(container), streamed(string(plaintext.begin(), plaintext.end()));
+        ostringstream output, fromStream;
+
+        ContainerReader reader(input, aes, pool);
+        reader.read(output);
+        passed &= check(label + " read", reader.getMode() == m.mode && reader.getPlaintextSize() == size
+            && reader.getChunkCount() == (size + CHUNK_SIZE - 1) / CHUNK_SIZE && output.str() == string(plaintext.begin(), plaintext.end()));
+
+        for (uint64_t i = 0; i < reader.getChunkCount(); i++) {
+            size_t n = reader.readChunk(i, chunk.data());
+            joined.insert(joined.end(), chunk.begin(), chunk.begin() + n);
+        }
+        passed &= check(label + " readChunk", joined == plaintext);
+
+        // the stream writer must produce the same container as the buffer writer
+        ContainerWriter writer(fromStream, aes, m.mode, nonce, pool, CHUNK_SIZE);
+        writer.write(streamed);
+        writer.finish();
+        passed &= check(label + " write(istream)", fromStream.str() == container);
+    }
+
+    return passed;
+}
+
+// a flipped ciphertext byte in one GCM chunk must fail that chunk alone
+bool checkDamagedChunk(const AES &aes, WorkerPool &pool) {
+    vector<uint8_t> plaintext(10 * CHUNK_SIZE + 5, 0x5a), chunk(CHUNK_SIZE);
+    string container = writeContainer(aes, Container::MODE_GCM, plaintext, pool);
+    ostringstream output;
+    bool passed = true, others = true, thrown = false;
+
+    // chunk 4 starts after the header and 4 chunks of ciphertext and tag
+    container[Container::HEADER_SIZE + 4 * (CHUNK_SIZE + 16) + 10] ^= 1;
+    istringstream input(container);
+    ContainerReader reader(input, aes, pool);
+
+    for (uint64_t i = 0; i < reader.getChunkCount(); i++) {
+        try {
+            others &= reader.readChunk(i, chunk.data()) == (i + 1 < reader.getChunkCount() ? CHUNK_SIZE : 5) && i != 4;
+        } catch (invalid_argument &e) {
+            thrown |= i == 4;
+            others &= i == 4;
+        }
+    }
+    passed &= check("GCM damaged chunk throws from readChunk", thrown);
+    passed &= check("GCM damaged chunk leaves the other chunks readable", others);
+
+    thrown = false;
+    try {
+        reader.read(output);
+    } catch (invalid_argument &e) {
+        thrown = true;
+    }
+    passed &= check("GCM damaged chunk throws from read", thrown);
+
+    return passed;
+}
+
+// damage to the header, footer, or index must be caught when the reader is constructed
+bool checkDamagedFraming(const AES &aes, const AES &otherKeySize, WorkerPool &pool) {
+    vector<uint8_t> plaintext(10 * CHUNK_SIZE + 5, 0x5a);
+    string container = writeContainer(aes, Container::MODE_CTR, plaintext, pool), damaged;
+    size_t footer = container.size() - Container::FOOTER_SIZE, index = footer - 11 * Container::INDEX_ENTRY_SIZE;
+    bool passed = true;
+
+    passed &= check("undamaged container opens", !throwsInvalid(container, aes, pool));
+    passed &= check("wrong key size is rejected", throwsInvalid(container, otherKeySize, pool));
+
+    damaged = container;
+    damaged[0] ^= 1;
+    passed &= check("damaged header magic is rejected", throwsInvalid(damaged, aes, pool));
+
+    damaged = container;
+    damaged[7] = 9;
+    passed &= check("unknown mode is rejected", throwsInvalid(damaged, aes, pool));
+
+    damaged = container;
+    damaged[footer + 23] ^= 1;
+    passed &= check("damaged footer magic is rejected", throwsInvalid(damaged, aes, pool));
+
+    damaged = container;
+    damaged[footer] ^= 16;
+    passed &= check("damaged index offset in the footer is rejected", throwsInvalid(damaged, aes, pool));
+
+    damaged = container;
+    damaged[footer + 8] ^= 1;
+    passed &= check("damaged chunk count in the footer is rejected", throwsInvalid(damaged, aes, pool));
+
+    damaged = container;
+    damaged[index + Container::INDEX_ENTRY_SIZE] ^= 1;
+    passed &= check("damaged chunk offset in the index is rejected", throwsInvalid(damaged, aes, pool));
+
+    damaged = container;
+    damaged[index + 8] ^= 1;
+    passed &= check("damaged ciphertext size in the index is rejected", throwsInvalid(damaged, aes, pool));
+
+    damaged = container;
+    damaged[index + 12] ^= 1;
+    passed &= check("damaged plaintext size in the index is rejected", throwsInvalid(damaged, aes, pool));
+
+    passed &= check("truncated container is rejected", throwsInvalid(container.substr(0, container.size() - 1), aes, pool));
+    passed &= check("container without a footer is rejected", throwsInvalid(container.substr(0, footer), aes, pool));
+
+    return passed;
+}
+
+int main() {
+    vector<uint8_t> key = fromHex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+    WorkerPool pool(3);
+    bool passed = true;
+
+    AES aes(key.data(), AES::AES128), aes256(key.data(), AES::AES256);
+
+    for (const Mode &m : MODES)
+        passed &= checkRoundTrip(aes, m, pool);
+
+    passed &= checkDamagedChunk(aes, pool);
+    passed &= checkDamagedFraming(aes, aes256, pool);
+
+    return passed ? 0 : 1;
+}
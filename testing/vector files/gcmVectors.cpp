@@ -0,0 +1,142 @@
+/**
+ * test program that checks GCM and GHASH against the known answers of the GCM specification.
+ * @file gcmVectors.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include "../../ciphers/AES.hpp"
+#include "../../modes/GCM.hpp"
+#include "../../modes/GHASH.hpp"
+#include "vectors.hpp"
+
+using namespace std;
+
+// test cases 1-6 and 13-16 of the GCM specification, all with a 16 byte tag
+// found at: https://csrc.nist.gov/CSRC/media/Projects/Block-Cipher-Techniques/documents/BCM/proposed-modes/gcm/gcm-spec.pdf
+struct Vector {
+    const char *name;
+    const char *key;
+    const char *iv;
+    const char *aad;
+    const char *plaintext;
+    const char *ciphertext;
+    const char *tag;
+};
+
+const char P64[] = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255";
+const char P60[] = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+const char AAD[] = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+const char K128[] = "feffe9928665731c6d6a8f9467308308";
+const char K256[] = "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308";
+const char IV60[] = "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b";
+
+const Vector VECTORS[] = {
+    { "test case 1", "00000000000000000000000000000000", "000000000000000000000000", "", "", "", "58e2fccefa7e3061367f1d57a4e7455a" },
+    { "test case 2", "00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000",
+      "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf" },
+    { "test case 3", K128, "cafebabefacedbaddecaf888", "", P64,
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+      "4d5c2af327cd64a62cf35abd2ba6fab4" },
+    { "test case 4", K128, "cafebabefacedbaddecaf888", AAD, P60,
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+      "5bc94fbc3221a5db94fae95ae7121a47" },
+    { "test case 5", K128, "cafebabefacedbad", AAD, P60,
+      "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c742373806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+      "3612d2e79e3b0785561be14aaca2fccb" },
+    { "test case 6", K128, IV60, AAD, P60,
+      "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca701e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5",
+      "619cc5aefffe0bfa462af43c1699d050" },
+    { "test case 13", "0000000000000000000000000000000000000000000000000000000000000000", "000000000000000000000000", "", "", "",
+      "530f8afbc74536b9a963b4f1c4cb738b" },
+    { "test case 14", "0000000000000000000000000000000000000000000000000000000000000000", "000000000000000000000000", "",
+      "00000000000000000000000000000000", "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919" },
+    { "test case 15", K256, "cafebabefacedbaddecaf888", "", P64,
+      "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662898015ad",
+      "b094dac5d93471bdec1a502270e3cc6c" },
+    { "test case 16", K256, "cafebabefacedbaddecaf888", AAD, P60,
+      "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+      "76fc6ece0f4e1768cddf8853bb2d551b" }
+};
+
+bool checkVector(const Vector &v) {
+    vector<uint8_t> key = fromHex(v.key), iv = fromHex(v.iv), aad = fromHex(v.aad);
+    vector<uint8_t> plaintext = fromHex(v.plaintext), ciphertext = fromHex(v.ciphertext), tag = fromHex(v.tag);
+    vector<uint8_t> output(plaintext.size()), outputTag(16);
+    bool passed = true;
+
+    AES aes(key.data(), (AES::KEY_SIZE) key.size());
+    GCM gcm(aes, iv.data(), iv.size());
+
+    gcm.encrypt(aad.data(), aad.size(), plaintext.data(), plaintext.size(), output.data(), outputTag.data());
+    passed &= check(string(v.name) + " encrypt", output == ciphertext && outputTag == tag);
+
+    passed &= check(string(v.name) + " decrypt", gcm.decrypt(aad.data(), aad.size(), ciphertext.data(), ciphertext.size(), tag.data(), output.data()) && output == plaintext);
+
+    tag[0] ^= 1;
+    passed &= check(string(v.name) + " rejects a modified tag", !gcm.decrypt(aad.data(), aad.size(), ciphertext.data(), ciphertext.size(), tag.data(), output.data()));
+
+    return passed;
+}
+
+// GHASH(H, {}, C) for H and C of test case 2
+bool checkGHASH(bool useClmul) {
+    uint8_t key[16] = { 0 }, state[16] = { 0 };
+    vector<uint8_t> ciphertext = fromHex("0388dace60b6a392f328c2b971b2fe78"), expected = fromHex("f38cbb1ad69223dcc3457ae5b6b0f885");
+
+    AES aes(key, AES::AES128);
+    GHASH ghash(aes, useClmul);
+
+    ghash.update(state, ciphertext.data(), 1);
+    ghash.updateLengths(state, 0, ciphertext.size());
+
+    return check(string("GHASH test case 2 with ") + (ghash.usesClmul() ? "PCLMULQDQ" : "4 bit tables"), vector<uint8_t>(state, state + 16) == expected);
+}
+
+// the 4 bit tables and PCLMULQDQ, which folds 4 blocks at a time, must agree on every length
+bool compareGHASH() {
+    vector<uint8_t> key(16), data(16 * 37);
+    bool passed = true;
+
+    srand(1);
+    for (uint8_t &b : key)
+        b = rand();
+    for (uint8_t &b : data)
+        b = rand();
+
+    AES aes(key.data(), AES::AES128);
+    GHASH tables(aes, false), clmul(aes, true);
+
+    if (!clmul.usesClmul()) {
+        cout << "SKIP: GHASH tables against PCLMULQDQ, which this CPU lacks" << endl;
+        return true;
+    }
+
+    for (size_t nblocks = 0; nblocks <= 37; nblocks++) {
+        uint8_t a[16] = { 0 }, b[16] = { 0 };
+
+        tables.update(a, data.data(), nblocks);
+        clmul.update(b, data.data(), nblocks);
+        passed &= vector<uint8_t>(a, a + 16) == vector<uint8_t>(b, b + 16);
+    }
+
+    return check("GHASH tables against PCLMULQDQ for 0 to 37 blocks", passed);
+}
+
+int main() {
+    bool passed = true;
+
+    for (const Vector &v : VECTORS)
+        passed &= checkVector(v);
+
+    passed &= checkGHASH(false);
+    passed &= checkGHASH(true);
+    passed &= compareGHASH();
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/**
+ * test program that checks every BlockPadding against known paddings, rejection of malformed padding, and a round trip through ECB.
+ * @file paddingVectors.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include "../../ciphers/AES.hpp"
+#include "../../modes/ECB.hpp"
+#include "../../padding/BlockPadding.hpp"
+#include "../../padding/PKCS_5.hpp"
+#include "../../padding/ANSI_X923.hpp"
+#include "../../padding/ISO_7816_4.hpp"
+#include "../../padding/ISO_10126.hpp"
+#include "../../padding/ZeroPadding.hpp"
+#include "vectors.hpp"
+
+using namespace std;
+
+// 8 byte blocks, the data is the start of "abcdefg"
+// ISO_10126 pads with random bytes, so only its final byte is known
+struct Vector {
+    const char *data;
+    const char *pkcs5;
+    const char *ansiX923;
+    const char *iso7816;
+    const char *iso10126;
+    const char *zero;
+};
+
+const Vector VECTORS[] = {
+    { "", "0808080808080808", "0000000000000008", "8000000000000000", "??????????????08", "" },
+    { "61", "6107070707070707", "6100000000000007", "6180000000000000", "61????????????07", "6100000000000000" },
+    { "616263", "6162630505050505", "6162630000000005", "6162638000000000", "616263????????05", "6162630000000000" },
+    { "61626364656667", "6162636465666701", "6162636465666701", "6162636465666780", "6162636465666701", "6162636465666700" }
+};
+
+// 16 byte final blocks that a padding must reject
+struct Malformed {
+    const char *name;
+    const char *block;
+};
+
+const Malformed PKCS5_MALFORMED[] = {
+    { "amount of 0", "6162636465666768696a6b6c6d6e6f00" },
+    { "amount larger than the block", "6162636465666768696a6b6c6d6e6f11" },
+    { "padding byte that differs from the amount", "6162636465666768696a6b0505040505" }
+};
+
+const Malformed ANSI_X923_MALFORMED[] = {
+    { "amount of 0", "6162636465666768696a6b6c6d6e6f00" },
+    { "amount larger than the block", "6162636465666768696a6b6c6d6e6f11" },
+    { "nonzero filler byte", "6162636465666768696a6b0000010005" }
+};
+
+const Malformed ISO_7816_MALFORMED[] = {
+    { "a block of zeros", "00000000000000000000000000000000" },
+    { "last nonzero byte that is not 0x80", "6162636465666768696a6b0100000000" },
+    { "data without padding", "6162636465666768696a6b6c6d6e6f70" }
+};
+
+const Malformed ISO_10126_MALFORMED[] = {
+    { "amount of 0", "6162636465666768696a6b6c6d6e6f00" },
+    { "amount larger than the block", "6162636465666768696a6b6c6d6e6fff" }
+};
+
+// the data must match the start of the expected padded block, '?' stands for a byte that may be anything
+bool matches(const vector<uint8_t> &block, size_t size, const char *expected) {
+    string hex(expected);
+
+    if (size * 2 != hex.size())
+        return false;
+
+    for (size_t i = 0; i < size; i++)
+        if (hex[2 * i] != '?' && block[i] != (uint8_t) stoi(hex.substr(2 * i, 2), nullptr, 16))
+            return false;
+
+    return true;
+}
+
+bool checkKnown(const BlockPadding &padding, const string &name, const Vector &v, const char *expected) {
+    vector<uint8_t> data = fromHex(v.data), block(8, 0xee);
+    size_t size;
+    bool passed = true;
+
+    copy(data.begin(), data.end(), block.begin());
+    size = padding.addPadding(block.data(), data.size());
+
+    passed &= check(name + " pads " + to_string(data.size()) + " bytes", matches(block, size, expected) && padding.getPaddedSize(data.size()) == size);
+    if (size)
+        passed &= check(name + " unpads " + to_string(data.size()) + " bytes", padding.isPaddingValid(block.data()) && padding.getPaddingAmount(block.data()) == 8 - data.size());
+
+    return passed;
+}
+
+bool checkMalformed(const BlockPadding &padding, const string &name, const Malformed malformed[], size_t count) {
+    uint8_t key[16] = { 0 };
+    AES aes(key, AES::AES128);
+    ECB ecb(aes, padding);
+    bool passed = true;
+
+    for (size_t i = 0; i < count; i++) {
+        vector<uint8_t> block = fromHex(malformed[i].block), ciphertext(16), plaintext(16);
+        bool thrown = false;
+
+        passed &= check(name + " rejects " + malformed[i].name, !padding.isPaddingValid(block.data()));
+
+        // the same block as the last block of a ciphertext must make decryption throw
+        aes.encryptBlock(block.data(), ciphertext.data());
+        try {
+            ecb.decrypt(ciphertext.data(), ciphertext.size(), plaintext.data());
+        } catch (invalid_argument &e) {
+            thrown = true;
+        }
+        passed &= check(name + " decrypt throws on " + malformed[i].name, thrown);
+    }
+
+    return passed;
+}
+
+// ZeroPadding cannot tell padding from trailing zero data, so every block is valid and the zeros are the amount
+bool checkZeroAmbiguity(const ZeroPadding &padding) {
+    vector<uint8_t> data = fromHex("6162630000000000"), zeros(8, 0), none = fromHex("6162636465666768");
+    bool passed = true;
+
+    passed &= check("ZeroPadding accepts any block", padding.isPaddingValid(data.data()) && padding.isPaddingValid(zeros.data()) && padding.isPaddingValid(none.data()));
+    passed &= check("ZeroPadding counts the trailing zeros", padding.getPaddingAmount(data.data()) == 5 && padding.getPaddingAmount(zeros.data()) == 8 && padding.getPaddingAmount(none.data()) == 0);
+
+    return passed;
+}
+
+// messages of every length up to three blocks, with no zero bytes so that ZeroPadding also round trips
+bool checkRoundTrip(const BlockPadding &padding, const string &name) {
+    uint8_t key[16] = { 1 };
+    AES aes(key, AES::AES128);
+    ECB ecb(aes, padding);
+    bool passed = true;
+
+    for (size_t size = 0; size <= 48; size++) {
+        vector<uint8_t> plaintext(size), ciphertext(ecb.getEncryptedSize(size)), output(ciphertext.size());
+        size_t encrypted;
+
+        for (size_t i = 0; i < size; i++)
+            plaintext[i] = (uint8_t) (i + 1);
+
+        encrypted = ecb.encrypt(plaintext.data(), size, ciphertext.data());
+        output.resize(ecb.decrypt(ciphertext.data(), encrypted, output.data()));
+        passed &= encrypted == ciphertext.size() && output == plaintext;
+    }
+
+    return check(name + " round trip through ECB for 0 to 48 bytes", passed);
+}
+
+int main() {
+    PKCS_5 pkcs5(8), pkcs5Aes(16);
+    ANSI_X923 ansiX923(8), ansiX923Aes(16);
+    ISO_7816_4 iso7816(8), iso7816Aes(16);
+    ISO_10126 iso10126(8), iso10126Aes(16);
+    ZeroPadding zero(8), zeroAes(16);
+    bool passed = true;
+
+    for (const Vector &v : VECTORS) {
+        passed &= checkKnown(pkcs5, "PKCS_5", v, v.pkcs5);
+        passed &= checkKnown(ansiX923, "ANSI_X923", v, v.ansiX923);
+        passed &= checkKnown(iso7816, "ISO_7816_4", v, v.iso7816);
+        passed &= checkKnown(iso10126, "ISO_10126", v, v.iso10126);
+        passed &= checkKnown(zero, "ZeroPadding", v, v.zero);
+    }
+
+    passed &= checkMalformed(pkcs5Aes, "PKCS_5", PKCS5_MALFORMED, sizeof(PKCS5_MALFORMED) / sizeof(Malformed));
+    passed &= checkMalformed(ansiX923Aes, "ANSI_X923", ANSI_X923_MALFORMED, sizeof(ANSI_X923_MALFORMED) / sizeof(Malformed));
+    passed &= checkMalformed(iso7816Aes, "ISO_7816_4", ISO_7816_MALFORMED, sizeof(ISO_7816_MALFORMED) / sizeof(Malformed));
+    passed &= checkMalformed(iso10126Aes, "ISO_10126", ISO_10126_MALFORMED, sizeof(ISO_10126_MALFORMED) / sizeof(Malformed));
+    passed &= checkZeroAmbiguity(zero);
+
+    passed &= checkRoundTrip(pkcs5Aes, "PKCS_5");
+    passed &= checkRoundTrip(ansiX923Aes, "ANSI_X923");
+    passed &= checkRoundTrip(iso7816Aes, "ISO_7816_4");
+    passed &= checkRoundTrip(iso10126Aes, "ISO_10126");
+    passed &= checkRoundTrip(zeroAes, "ZeroPadding");
+
+    return passed ? 0 : 1;
+}
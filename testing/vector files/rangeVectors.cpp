@@ -0,0 +1,110 @@
+/**
+ * test program that checks decryptRange and decryptFileRange against a full decrypt for every mode with random access.
+ * @file rangeVectors.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include "../../ciphers/AES.hpp"
+#include "../../modes/ModeOfOperation.hpp"
+#include "../../modes/CTR.hpp"
+#include "../../modes/CBC.hpp"
+#include "../../modes/CFB.hpp"
+#include "../../modes/ECB.hpp"
+#include "../../padding/PKCS_5.hpp"
+#include "vectors.hpp"
+
+using namespace std;
+
+const char CIPHERTEXT_PATH[] = "./range_ciphertext";
+
+// sizes around a block and around the 1024 byte chunk decryptRange works in
+const size_t SIZES[] = { 1, 15, 16, 17, 100, 1023, 1024, 1025, 5000 };
+const int RANDOM_RANGES = 200;
+
+// decrypts [offset, offset + length) and compares it with the same bytes of the full plaintext, including the cut at the end
+bool checkRange(const ModeOfOperation &mode, const vector<uint8_t> &ciphertext, const vector<uint8_t> &plaintext, uint64_t offset, size_t length) {
+    vector<uint8_t> output(length);
+    size_t expected = offset >= plaintext.size() ? 0 : min(length, plaintext.size() - (size_t) offset);
+
+    if (mode.decryptRange(ciphertext.data(), ciphertext.size(), offset, length, output.data()) != expected)
+        return false;
+
+    return equal(output.begin(), output.begin() + expected, plaintext.begin() + offset);
+}
+
+bool checkMode(const ModeOfOperation &mode, const string &name, mt19937 &generator) {
+    bool passed = true;
+
+    for (size_t size : SIZES) {
+        vector<uint8_t> plaintext(size), ciphertext(mode.getEncryptedSize(size)), decrypted(ciphertext.size()), output(size);
+        string label = name + " " + to_string(size) + " bytes";
+        bool edges = true, random = true;
+
+        for (size_t i = 0; i < size; i++)
+            plaintext[i] = (uint8_t) generator();
+        ciphertext.resize(mode.encrypt(plaintext.data(), size, ciphertext.data()));
+        decrypted.resize(mode.decrypt(ciphertext.data(), ciphertext.size(), decrypted.data()));
+        passed &= check(label + " full decrypt", decrypted == plaintext);
+
+        // every range starting or ending in the first and last two blocks, which covers mid-block starts and ends
+        // and every range that touches the final (padded) block
+        for (size_t first = 0; first < size; first++) {
+            if (first >= 32 && first + 32 < size)
+                continue;
+            for (size_t last = first; last <= size + 16; last++)
+                if (last < 32 || last + 32 >= size)
+                    edges &= checkRange(mode, ciphertext, plaintext, first, last - first);
+        }
+        edges &= checkRange(mode, ciphertext, plaintext, size, 1);
+        edges &= checkRange(mode, ciphertext, plaintext, size + 100, 10);
+        passed &= check(label + " ranges at the start and end", edges);
+
+        for (int i = 0; i < RANDOM_RANGES; i++) {
+            size_t offset = generator() % size, length = generator() % (size - offset + 20);
+            random &= checkRange(mode, ciphertext, plaintext, offset, length);
+        }
+        passed &= check(label + " random ranges", random);
+
+        // the same ranges through a mapped file
+        ofstream(CIPHERTEXT_PATH, ios::binary).write((const char*) ciphertext.data(), ciphertext.size());
+        random = mode.decryptFileRange(CIPHERTEXT_PATH, 0, size, output.data()) == size && output == plaintext;
+        for (int i = 0; i < RANDOM_RANGES / 10; i++) {
+            size_t offset = generator() % size, length = generator() % (size - offset) + 1;
+            random &= mode.decryptFileRange(CIPHERTEXT_PATH, offset, length, output.data()) == length
+                && equal(output.begin(), output.begin() + length, plaintext.begin() + offset);
+        }
+        passed &= check(label + " file ranges", random);
+    }
+
+    return passed;
+}
+
+int main() {
+    vector<uint8_t> key = fromHex("2b7e151628aed2a6abf7158809cf4f3c"), iv = fromHex("000102030405060708090a0b0c0d0e0f");
+    mt19937 generator(1);
+    bool passed = true;
+
+    AES aes(key.data(), AES::AES128);
+    PKCS_5 padding(16);
+    CTR ctr(aes, iv.data(), 16);
+    CBC cbc(aes, padding, iv.data(), 16);
+    CFB cfb(aes, iv.data(), 16);
+    ECB ecb(aes, padding);
+
+    passed &= checkMode(ctr, "CTR", generator);
+    passed &= checkMode(cbc, "CBC", generator);
+    passed &= checkMode(cfb, "CFB", generator);
+    passed &= checkMode(ecb, "ECB", generator);
+
+    remove(CIPHERTEXT_PATH);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/**
+ * test program that checks UringPipeline against the buffer API of the modes it runs, including depths and chunk
+ * sizes small enough that a context holds back a whole chunk.
+ * @file uringPipeline.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "../../ciphers/AES.hpp"
+#include "../../modes/ModeOfOperation.hpp"
+#include "../../modes/CBC.hpp"
+#include "../../modes/CTR.hpp"
+#include "../../modes/GCM.hpp"
+#include "../../modes/UringPipeline.hpp"
+#include "../../padding/PKCS_5.hpp"
+#include "vectors.hpp"
+
+using namespace std;
+
+const char PLAINTEXT_PATH[] = "./pipeline_plaintext";
+const char CIPHERTEXT_PATH[] = "./pipeline_ciphertext";
+const char DECRYPTED_PATH[] = "./pipeline_decrypted";
+
+const size_t SIZES[] = { 0, 1, 16, 100, 4097 };
+const unsigned DEPTHS[] = { 1, 3 };
+const size_t CHUNK_SIZES[] = { 16, 17, 4096 };
+
+vector<uint8_t> readFile(const char *path) {
+    ifstream file(path, ios::binary);
+    return vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+void writeFile(const char *path, const vector<uint8_t> &bytes) {
+    ofstream file(path, ios::binary);
+    file.write((const char*) bytes.data(), bytes.size());
+}
+
+bool checkMode(const ModeOfOperation &mode, const string &name) {
+    bool passed = true;
+
+    for (size_t size : SIZES) {
+        vector<uint8_t> plaintext(size), expected(mode.getEncryptedSize(size));
+
+        for (size_t i = 0; i < size; i++)
+            plaintext[i] = (uint8_t) rand();
+        expected.resize(mode.encrypt(plaintext.data(), size, expected.data()));
+        writeFile(PLAINTEXT_PATH, plaintext);
+
+        for (unsigned depth : DEPTHS) {
+            for (size_t chunkSize : CHUNK_SIZES) {
+                UringPipeline pipeline(mode, depth, chunkSize);
+                string label = name + " size " + to_string(size) + " depth " + to_string(depth) + " chunk " + to_string(chunkSize);
+
+                pipeline.encryptFile(PLAINTEXT_PATH, CIPHERTEXT_PATH);
+                passed &= check(label + " encrypt", readFile(CIPHERTEXT_PATH) == expected);
+
+                pipeline.decryptFile(CIPHERTEXT_PATH, DECRYPTED_PATH);
+                passed &= check(label + " decrypt", readFile(DECRYPTED_PATH) == plaintext);
+            }
+        }
+    }
+
+    return passed;
+}
+
+int main() {
+    vector<uint8_t> key = fromHex("000102030405060708090a0b0c0d0e0f"), iv = fromHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+    bool passed = true;
+
+    if (!UringPipeline::isSupported()) {
+        cout << "SKIP: io_uring is not available" << endl;
+        return 0;
+    }
+
+    AES aes(key.data(), AES::AES128);
+    PKCS_5 padding(16);
+    CBC cbc(aes, padding, iv.data(), 16);
+    CTR ctr(aes, iv.data(), 16);
+    GCM gcm(aes, iv.data(), 12);
+
+    passed &= checkMode(cbc, "CBC");
+    passed &= checkMode(ctr, "CTR");
+    passed &= checkMode(gcm, "GCM");
+
+    remove(PLAINTEXT_PATH);
+    remove(CIPHERTEXT_PATH);
+    remove(DECRYPTED_PATH);
+
+    return passed ? 0 : 1;
+}
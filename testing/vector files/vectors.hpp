@@ -0,0 +1,41 @@
+/**
+ * header file for the helpers shared by the vector test programs.
+ * @file vectors.hpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#ifndef MYVECTORS
+#define MYVECTORS
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * converts a hex string into the bytes it spells out.
+ * @param hex is the hex string
+ * @return the bytes
+ */
+inline std::vector<uint8_t> fromHex(const char *hex) {
+    std::vector<uint8_t> bytes;
+
+    for (size_t i = 0; hex[i] && hex[i + 1]; i += 2)
+        bytes.push_back((uint8_t) std::stoi(std::string(hex + i, 2), nullptr, 16));
+
+    return bytes;
+}
+
+/**
+ * prints whether a check passed.
+ * @param name is the name of the check
+ * @param passed is whether the check passed
+ * @return passed
+ */
+inline bool check(const std::string &name, bool passed) {
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    return passed;
+}
+
+#endif
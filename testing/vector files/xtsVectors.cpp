@@ -0,0 +1,109 @@
+/**
+ * test program that checks XTS against the known answers of IEEE 1619.
+ * @file xtsVectors.cpp
+ * @author Daniel Wygant
+ * @version 1.0 10/20/2020
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../../ciphers/AES.hpp"
+#include "../../modes/XTS.hpp"
+#include "../../modes/WorkerPool.hpp"
+#include "vectors.hpp"
+
+using namespace std;
+
+// vectors 1-3 and the ciphertext stealing vectors 15-18 of IEEE 1619-2007 annex B, all with AES-128
+struct Vector {
+    const char *name;
+    const char *dataKey;
+    const char *tweakKey;
+    uint64_t sector;
+    const char *plaintext;
+    const char *ciphertext;
+};
+
+const char STEALING_DATA_KEY[] = "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0";
+const char STEALING_TWEAK_KEY[] = "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0";
+
+const Vector VECTORS[] = {
+    { "vector 1", "00000000000000000000000000000000", "00000000000000000000000000000000", 0,
+      "0000000000000000000000000000000000000000000000000000000000000000",
+      "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e" },
+    { "vector 2", "11111111111111111111111111111111", "22222222222222222222222222222222", 0x3333333333,
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0" },
+    { "vector 3", "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "22222222222222222222222222222222", 0x3333333333,
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "af85336b597afc1a900b2eb21ec949d292df4c047e0b21532186a5971a227a89" },
+    { "vector 15", STEALING_DATA_KEY, STEALING_TWEAK_KEY, 0x123456789a,
+      "000102030405060708090a0b0c0d0e0f10", "6c1625db4671522d3d7599601de7ca09ed" },
+    { "vector 16", STEALING_DATA_KEY, STEALING_TWEAK_KEY, 0x123456789a,
+      "000102030405060708090a0b0c0d0e0f1011", "d069444b7a7e0cab09e24447d24deb1fedbf" },
+    { "vector 17", STEALING_DATA_KEY, STEALING_TWEAK_KEY, 0x123456789a,
+      "000102030405060708090a0b0c0d0e0f101112", "e5df1351c0544ba1350b3363cd8ef4beedbf9d" },
+    { "vector 18", STEALING_DATA_KEY, STEALING_TWEAK_KEY, 0x123456789a,
+      "000102030405060708090a0b0c0d0e0f10111213", "9d84c813f719aa2c7be3f66171c7c5c2edbf9dac" }
+};
+
+bool checkVector(const Vector &v, WorkerPool &pool) {
+    vector<uint8_t> dataKey = fromHex(v.dataKey), tweakKey = fromHex(v.tweakKey);
+    vector<uint8_t> plaintext = fromHex(v.plaintext), ciphertext = fromHex(v.ciphertext);
+    vector<uint8_t> output(plaintext.size());
+    bool passed = true;
+
+    AES dataCipher(dataKey.data(), AES::AES128), tweakCipher(tweakKey.data(), AES::AES128);
+    XTS xts(dataCipher, tweakCipher);
+
+    xts.encryptSector(v.sector, plaintext.data(), plaintext.size(), output.data());
+    passed &= check(string(v.name) + " encryptSector", output == ciphertext);
+
+    xts.decryptSector(v.sector, ciphertext.data(), ciphertext.size(), output.data());
+    passed &= check(string(v.name) + " decryptSector", output == plaintext);
+
+    // the batch API splits its sectors between the threads of the pool, so give it several copies
+    vector<vector<uint8_t>> outputs(8, vector<uint8_t>(plaintext.size()));
+    vector<XTS::Sector> sectors;
+    bool batchPassed = true;
+
+    for (vector<uint8_t> &out : outputs)
+        sectors.push_back({ v.sector, plaintext.data(), plaintext.size(), out.data() });
+    xts.encrypt(sectors.data(), sectors.size(), &pool);
+    for (const vector<uint8_t> &out : outputs)
+        batchPassed &= out == ciphertext;
+    passed &= check(string(v.name) + " encrypt on a WorkerPool", batchPassed);
+
+    return passed;
+}
+
+// no vector spans more than one batch of tweaks, so also round-trip a sector that does, ending with a partial block
+bool checkLongSector() {
+    vector<uint8_t> dataKey = fromHex(STEALING_DATA_KEY), tweakKey = fromHex(STEALING_TWEAK_KEY);
+    vector<uint8_t> plaintext(4096 + 5), ciphertext(plaintext.size()), output(plaintext.size());
+
+    for (size_t i = 0; i < plaintext.size(); i++)
+        plaintext[i] = (uint8_t) i;
+
+    AES dataCipher(dataKey.data(), AES::AES128), tweakCipher(tweakKey.data(), AES::AES128);
+    XTS xts(dataCipher, tweakCipher);
+
+    xts.encryptSector(7, plaintext.data(), plaintext.size(), ciphertext.data());
+    xts.decryptSector(7, ciphertext.data(), ciphertext.size(), output.data());
+
+    return check("4101 byte sector round trip", output == plaintext && ciphertext != plaintext);
+}
+
+int main() {
+    WorkerPool pool(4);
+    bool passed = true;
+
+    for (const Vector &v : VECTORS)
+        passed &= checkVector(v, pool);
+
+    passed &= checkLongSector();
+
+    return passed ? 0 : 1;
+}
@@ -1,45 +1,21 @@
 #!/bin/bash
 
-diff ./my\ files/ciphertext_aes_128_ecb ./openssl\ files/ciphertext_aes_128_ecb -q
-diff ./my\ files/ciphertext_aes_192_ecb ./openssl\ files/ciphertext_aes_192_ecb -q
-diff ./my\ files/ciphertext_aes_256_ecb ./openssl\ files/ciphertext_aes_256_ecb -q
-
-diff ./my\ files/plaintext_aes_128_ecb ./plaintext -q
-diff ./my\ files/plaintext_aes_192_ecb ./plaintext -q
-diff ./my\ files/plaintext_aes_256_ecb ./plaintext -q
-
-
-diff ./my\ files/ciphertext_aes_128_cbc ./openssl\ files/ciphertext_aes_128_cbc -q
-diff ./my\ files/ciphertext_aes_192_cbc ./openssl\ files/ciphertext_aes_192_cbc -q
-diff ./my\ files/ciphertext_aes_256_cbc ./openssl\ files/ciphertext_aes_256_cbc -q
-
-diff ./my\ files/plaintext_aes_128_cbc ./plaintext -q
-diff ./my\ files/plaintext_aes_192_cbc ./plaintext -q
-diff ./my\ files/plaintext_aes_256_cbc ./plaintext -q
-
-
-diff ./my\ files/ciphertext_aes_128_cfb ./openssl\ files/ciphertext_aes_128_cfb -q
-diff ./my\ files/ciphertext_aes_192_cfb ./openssl\ files/ciphertext_aes_192_cfb -q
-diff ./my\ files/ciphertext_aes_256_cfb ./openssl\ files/ciphertext_aes_256_cfb -q
-
-diff ./my\ files/plaintext_aes_128_cfb ./plaintext -q
-diff ./my\ files/plaintext_aes_192_cfb ./plaintext -q
-diff ./my\ files/plaintext_aes_256_cfb ./plaintext -q
-
-
-diff ./my\ files/ciphertext_aes_128_ofb ./openssl\ files/ciphertext_aes_128_ofb -q
-diff ./my\ files/ciphertext_aes_192_ofb ./openssl\ files/ciphertext_aes_192_ofb -q
-diff ./my\ files/ciphertext_aes_256_ofb ./openssl\ files/ciphertext_aes_256_ofb -q
-
-diff ./my\ files/plaintext_aes_128_ofb ./plaintext -q
-diff ./my\ files/plaintext_aes_192_ofb ./plaintext -q
-diff ./my\ files/plaintext_aes_256_ofb ./plaintext -q
-
-
-diff ./my\ files/ciphertext_aes_128_ctr ./openssl\ files/ciphertext_aes_128_ctr -q
-diff ./my\ files/ciphertext_aes_192_ctr ./openssl\ files/ciphertext_aes_192_ctr -q
-diff ./my\ files/ciphertext_aes_256_ctr ./openssl\ files/ciphertext_aes_256_ctr -q
-
-diff ./my\ files/plaintext_aes_128_ctr ./plaintext -q
-diff ./my\ files/plaintext_aes_192_ctr ./plaintext -q
-diff ./my\ files/plaintext_aes_256_ctr ./plaintext -q
\ No newline at end of file
+# generate.out writes the files of every backend the CPU supports, prefixed with the backend's name
+for backend in auto reference ttable aesni bitslice vperm; do
+    if [ ! -e ./my\ files/${backend}_ciphertext_aes_128_ecb ]; then
+        echo "skipping $backend, which was not generated on this CPU"
+        continue
+    fi
+
+    for mode in ecb cbc cfb ofb ctr; do
+        for size in 128 192 256; do
+            diff ./my\ files/${backend}_ciphertext_aes_${size}_${mode} ./openssl\ files/ciphertext_aes_${size}_${mode} -q
+            diff ./my\ files/${backend}_plaintext_aes_${size}_${mode} ./plaintext -q
+        done
+
+        for size in 128 192 256; do
+            diff ./my\ files/mapped_${backend}_ciphertext_aes_${size}_${mode} ./openssl\ files/ciphertext_aes_${size}_${mode} -q
+            diff ./my\ files/mapped_${backend}_plaintext_aes_${size}_${mode} ./plaintext -q
+        done
+    done
+done